@@ -0,0 +1,245 @@
+#include "async_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+// Bounded multi-producer/single-consumer ring (Vyukov): each slot's sequence
+// says whether it is free for the producer at that position or holds a
+// finished message for the writer, so neither side ever takes a lock.
+static const size_t LOG_RING_SIZE = 1024; // Power of two
+static const size_t LOG_LINE_MAX = 256;   // Longer messages are truncated
+
+struct LogSlot {
+    std::atomic<size_t> sequence{0};
+    uint8_t level = LOG_INFO;
+    uint8_t topic = LOG_GENERAL;
+    uint32_t suppressedBefore = 0; // Lines of this topic the rate limit dropped since the last one
+    char text[LOG_LINE_MAX];
+};
+
+struct TopicLimit {
+    std::atomic<int64_t> windowStartUs{0};
+    std::atomic<int> count{0};
+    std::atomic<uint32_t> suppressed{0};
+};
+
+static LogSlot logRing[LOG_RING_SIZE];
+static std::atomic<size_t> enqueuePos{0};
+static size_t dequeuePos = 0; // Writer thread only
+static std::atomic<bool> writerRunning{false};
+static std::atomic<bool> writerStopping{false};
+static std::atomic<int> activeProducers{0}; // logMessage() calls between the writerRunning check and publishing
+static std::thread writerThread;
+
+static std::atomic<int> minLevel{LOG_INFO};
+static std::atomic<int> rateLimit{0};
+static TopicLimit topicLimits[LOG_TOPIC_COUNT];
+static std::atomic<uint64_t> droppedCount{0};
+
+static const char* LOG_TOPIC_NAMES[LOG_TOPIC_COUNT] = {"general", "pose", "gesture", "capture", "output", "stats"};
+
+static int64_t logNowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+LogLevel parseLogLevel(const char* name) {
+    std::string lower = name ? name : "";
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "debug") return LOG_DEBUG;
+    if (lower == "warn" || lower == "warning") return LOG_WARN;
+    if (lower == "error") return LOG_ERROR;
+    return LOG_INFO;
+}
+
+void setLogLevel(LogLevel level) {
+    minLevel.store(level, std::memory_order_relaxed);
+}
+
+void setLogRateLimit(int linesPerSecond) {
+    rateLimit.store(std::max(0, linesPerSecond), std::memory_order_relaxed);
+}
+
+uint64_t droppedLogMessages() {
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+// One-second window per topic. Returns false if the line is over the limit;
+// otherwise suppressedBefore is how many were dropped since the last line.
+static bool passRateLimit(LogTopic topic, uint32_t& suppressedBefore) {
+    suppressedBefore = 0;
+    int limit = rateLimit.load(std::memory_order_relaxed);
+    if (limit <= 0) {
+        return true;
+    }
+    TopicLimit& state = topicLimits[topic];
+    int64_t now = logNowUs();
+    int64_t windowStart = state.windowStartUs.load(std::memory_order_relaxed);
+    if (now - windowStart >= 1000000 &&
+        state.windowStartUs.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        state.count.store(0, std::memory_order_relaxed);
+    }
+    if (state.count.fetch_add(1, std::memory_order_relaxed) >= limit) {
+        state.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressedBefore = state.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+static void appendLine(std::string& out, uint8_t topic, uint32_t suppressedBefore, const char* text) {
+    if (suppressedBefore > 0) {
+        out += "(" + std::to_string(suppressedBefore) + " " + LOG_TOPIC_NAMES[topic] + " messages suppressed)\n";
+    }
+    out += text;
+    out += '\n';
+}
+
+// The only place that can block on a full pipe
+static void writeLines(std::string& out, std::string& err) {
+    if (!out.empty()) {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        std::fflush(stdout);
+        out.clear();
+    }
+    if (!err.empty()) {
+        std::fwrite(err.data(), 1, err.size(), stderr);
+        std::fflush(stderr);
+        err.clear();
+    }
+}
+
+// Drain finished slots in order; false if the next one is not ready yet
+static bool popLine(std::string& out, std::string& err) {
+    LogSlot& slot = logRing[dequeuePos & (LOG_RING_SIZE - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+        return false;
+    }
+    appendLine(slot.level >= LOG_ERROR ? err : out, slot.topic, slot.suppressedBefore, slot.text);
+    slot.sequence.store(dequeuePos + LOG_RING_SIZE, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
+
+static void runLogWriter() {
+    std::string out;
+    std::string err;
+    uint64_t reportedDrops = 0;
+    while (true) {
+        bool stopping = writerStopping.load(std::memory_order_acquire);
+        while (popLine(out, err) && out.size() + err.size() < 64 * 1024) {
+        }
+        uint64_t drops = droppedCount.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            err += "(" + std::to_string(drops - reportedDrops) + " log messages dropped: log buffer full)\n";
+            reportedDrops = drops;
+        }
+
+        if (out.empty() && err.empty()) {
+            if (stopping) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        writeLines(out, err);
+    }
+}
+
+void startLogWriter() {
+    if (writerRunning.load()) {
+        return;
+    }
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+        logRing[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos = 0;
+    writerStopping.store(false);
+    writerThread = std::thread(runLogWriter);
+    writerRunning.store(true, std::memory_order_release);
+}
+
+void stopLogWriter() {
+    if (!writerRunning.load()) {
+        return;
+    }
+    // seq_cst pairs with logMessage(): a producer either sees the writer gone and
+    // writes synchronously, or is counted in activeProducers below
+    writerRunning.store(false);
+    writerStopping.store(true, std::memory_order_release);
+    writerThread.join();
+
+    // Lines queued after the writer's last pass: wait for their producers to
+    // publish, then write them from here
+    while (activeProducers.load() > 0) {
+        std::this_thread::yield();
+    }
+    std::string out;
+    std::string err;
+    while (popLine(out, err)) {
+    }
+    writeLines(out, err);
+}
+
+void logMessage(LogLevel level, LogTopic topic, const char* format, ...) {
+    if (level < minLevel.load(std::memory_order_relaxed)) {
+        return;
+    }
+    uint32_t suppressedBefore = 0;
+    if (!passRateLimit(topic, suppressedBefore)) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    activeProducers.fetch_add(1);
+    if (!writerRunning.load()) {
+        activeProducers.fetch_sub(1);
+        // No writer (startup, shutdown, tools): write synchronously
+        char text[LOG_LINE_MAX];
+        std::vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        std::string line;
+        appendLine(line, static_cast<uint8_t>(topic), suppressedBefore, text);
+        FILE* stream = level >= LOG_ERROR ? stderr : stdout;
+        std::fwrite(line.data(), 1, line.size(), stream);
+        std::fflush(stream);
+        return;
+    }
+
+    // Claim the next slot; a full ring drops the message instead of waiting
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    LogSlot* slot = nullptr;
+    while (true) {
+        slot = &logRing[pos & (LOG_RING_SIZE - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            va_end(args);
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            activeProducers.fetch_sub(1, std::memory_order_release);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = static_cast<uint8_t>(level);
+    slot->topic = static_cast<uint8_t>(topic);
+    slot->suppressedBefore = suppressedBefore;
+    std::vsnprintf(slot->text, LOG_LINE_MAX, format, args);
+    va_end(args);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    activeProducers.fetch_sub(1, std::memory_order_release);
+}
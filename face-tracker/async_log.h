@@ -0,0 +1,61 @@
+// Asynchronous, rate-limited logging for the tracking hot path
+//
+// "Face tracked - Pan: ..." goes out on every DMX send and per-frame
+// warnings can repeat at camera rate. Written with std::cout/std::endl the
+// tracking thread pays for a flushed write each time, and blocks outright
+// when the Node service stops draining the pipe. logMessage() instead
+// formats into a slot of a fixed-size lock-free ring (any thread may log)
+// and returns; a writer thread drains the ring to stdout/stderr in batches.
+//
+//   - Levels: messages below the configured level cost one comparison
+//   - Rate limit: each topic allows logRateLimit lines per second; the rest
+//     are counted and reported as one "suppressed" line afterwards
+//   - A full ring drops the message (counted) rather than wait
+//
+// Lines keep exactly the text they had before, so the stdout parsing in
+// faceTrackerService.ts is unaffected. Before startLogWriter() (and after
+// stopLogWriter()) messages are written synchronously.
+#pragma once
+
+#include <cstdint>
+
+enum LogLevel {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR    // Written to stderr
+};
+
+// Rate limits apply per topic
+enum LogTopic {
+    LOG_GENERAL,
+    LOG_POSE,       // Per-DMX-send pose lines
+    LOG_GESTURE,
+    LOG_CAPTURE,    // Frame grab/decode problems
+    LOG_OUTPUT,     // DMX HTTP/transport errors
+    LOG_STATS,      // Periodic counters
+    LOG_TOPIC_COUNT
+};
+
+// "debug", "info", "warn" or "error" (case-insensitive); anything else is info
+LogLevel parseLogLevel(const char* name);
+
+void setLogLevel(LogLevel level);
+// Lines per second per topic; 0 = unlimited
+void setLogRateLimit(int linesPerSecond);
+
+void startLogWriter();
+// Drains everything still queued, then stops the writer thread
+void stopLogWriter();
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT __attribute__((format(printf, 3, 4)))
+#else
+#define LOG_PRINTF_FORMAT
+#endif
+
+// printf-style; the newline is added. Never blocks once the writer is running.
+void logMessage(LogLevel level, LogTopic topic, const char* format, ...) LOG_PRINTF_FORMAT;
+
+// Messages lost to a full ring since startup
+uint64_t droppedLogMessages();
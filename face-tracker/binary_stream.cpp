@@ -0,0 +1,214 @@
+#include "binary_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0 // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+
+BinaryStream::~BinaryStream() {
+    disconnect();
+}
+
+void BinaryStream::setSocketPath(const std::string& path) {
+    if (path == socketPath_) return;
+    disconnect();
+    socketPath_ = path;
+    nextConnectAttempt_ = std::chrono::steady_clock::time_point();
+}
+
+void BinaryStream::begin(StreamMessageType type) {
+    buffer_.clear();
+    putU8(STREAM_MAGIC);
+    putU8(type);
+    putU16(0); // Payload length, patched in finish()
+    putU32(sequence_++);
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    putU64(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()));
+}
+
+void BinaryStream::putU16(uint16_t v) {
+    buffer_.push_back(static_cast<uint8_t>(v & 0xFF));
+    buffer_.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void BinaryStream::putU32(uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        buffer_.push_back(static_cast<uint8_t>((v >> (8 * i)) & 0xFF));
+    }
+}
+
+void BinaryStream::putU64(uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        buffer_.push_back(static_cast<uint8_t>((v >> (8 * i)) & 0xFF));
+    }
+}
+
+void BinaryStream::putF32(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putU32(bits);
+}
+
+bool BinaryStream::sendPose(float rawPan, float rawTilt, float smoothedPan, float smoothedTilt,
+                            int panDmx, int tiltDmx, uint8_t flags) {
+    begin(STREAM_POSE);
+    putF32(rawPan);
+    putF32(rawTilt);
+    putF32(smoothedPan);
+    putF32(smoothedTilt);
+    putU8(static_cast<uint8_t>(panDmx));
+    putU8(static_cast<uint8_t>(tiltDmx));
+    putU8(flags);
+    return finish();
+}
+
+bool BinaryStream::sendDmx(const StreamDmxValue* values, size_t count) {
+    if (count > 255) count = 255;
+    begin(STREAM_DMX);
+    putU8(static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; i++) {
+        putU16(values[i].channel);
+        putU8(values[i].value);
+    }
+    return finish();
+}
+
+bool BinaryStream::sendGesture(const std::string& gesture) {
+    size_t length = std::min<size_t>(gesture.size(), 255);
+    begin(STREAM_GESTURE);
+    putU8(static_cast<uint8_t>(length));
+    buffer_.insert(buffer_.end(), gesture.begin(), gesture.begin() + length);
+    return finish();
+}
+
+bool BinaryStream::sendStats(uint32_t frames, uint64_t sent, uint64_t suppressed, uint64_t keyframes) {
+    begin(STREAM_STATS);
+    putU32(frames);
+    putU64(sent);
+    putU64(suppressed);
+    putU64(keyframes);
+    putU64(dropped_);
+    return finish();
+}
+
+#ifdef _WIN32
+
+// Unix domain sockets are not wired up on Windows; the tracker keeps using HTTP/OSC
+bool BinaryStream::finish() {
+    dropped_++;
+    return false;
+}
+
+bool BinaryStream::ensureConnected() { return false; }
+bool BinaryStream::flushPending() { return false; }
+void BinaryStream::disconnect() {}
+
+#else
+
+bool BinaryStream::finish() {
+    size_t payloadLength = buffer_.size() - STREAM_HEADER_SIZE;
+    buffer_[2] = static_cast<uint8_t>(payloadLength & 0xFF);
+    buffer_[3] = static_cast<uint8_t>(payloadLength >> 8);
+
+    // Never wait on the consumer: drop the message if we can't write it now
+    if (!ensureConnected() || !flushPending()) {
+        dropped_++;
+        return false;
+    }
+
+    ssize_t written = ::send(fd_, buffer_.data(), buffer_.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            disconnect();
+        }
+        dropped_++;
+        return false;
+    }
+
+    // Keep the unwritten tail so framing stays intact for the next send
+    if (static_cast<size_t>(written) < buffer_.size()) {
+        pending_.assign(buffer_.begin() + written, buffer_.end());
+    }
+    return true;
+}
+
+bool BinaryStream::ensureConnected() {
+    if (fd_ >= 0) return true;
+    if (socketPath_.empty()) return false;
+
+    // Back off between attempts so a missing backend costs nothing per frame
+    auto now = std::chrono::steady_clock::now();
+    if (now < nextConnectAttempt_) return false;
+    nextConnectAttempt_ = now + std::chrono::seconds(1);
+
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath_.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Stream socket path too long: " << socketPath_ << std::endl;
+        return false;
+    }
+    std::strncpy(addr.sun_path, socketPath_.c_str(), sizeof(addr.sun_path) - 1);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return false;
+    }
+    if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(sock);
+        return false;
+    }
+
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    fd_ = sock;
+    pending_.clear();
+    std::cout << "Stream connected: " << socketPath_ << std::endl;
+
+    // Announce protocol version (sequence/timestamp unused; fits an empty socket buffer)
+    uint8_t hello[STREAM_HEADER_SIZE + 2] = {STREAM_MAGIC, STREAM_HELLO, 2, 0};
+    hello[STREAM_HEADER_SIZE] = static_cast<uint8_t>(STREAM_PROTOCOL_VERSION & 0xFF);
+    hello[STREAM_HEADER_SIZE + 1] = static_cast<uint8_t>(STREAM_PROTOCOL_VERSION >> 8);
+    ::send(fd_, hello, sizeof(hello), MSG_DONTWAIT | MSG_NOSIGNAL);
+    return true;
+}
+
+bool BinaryStream::flushPending() {
+    if (pending_.empty()) return true;
+
+    ssize_t written = ::send(fd_, pending_.data(), pending_.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            disconnect();
+        }
+        return false;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + written);
+    return pending_.empty();
+}
+
+void BinaryStream::disconnect() {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+        std::cout << "Stream disconnected: " << socketPath_ << std::endl;
+    }
+    pending_.clear();
+}
+
+#endif
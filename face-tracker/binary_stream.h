@@ -0,0 +1,86 @@
+// Binary streaming channel to the ArtBastard Node backend
+//
+// One persistent Unix domain socket carries pose, DMX, gesture and stats
+// messages using compact little-endian framing:
+//
+//   u8  magic (0xAB)
+//   u8  message type (StreamMessageType)
+//   u16 payload length
+//   u32 sequence number
+//   u64 timestamp (microseconds, steady clock)
+//   ... payload ...
+//
+// The Node side (src/faceTrackerStream.ts) owns the listening socket; the
+// tracker connects to it and reconnects in the background if it goes away.
+// Sends never block the tracking loop: when the socket buffer is full the
+// message is dropped and counted.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+
+const uint8_t STREAM_MAGIC = 0xAB;
+const uint16_t STREAM_PROTOCOL_VERSION = 1;
+const size_t STREAM_HEADER_SIZE = 16;
+
+enum StreamMessageType : uint8_t {
+    STREAM_HELLO = 0,   // u16 protocol version
+    STREAM_POSE = 1,    // f32 rawPan, rawTilt, smoothedPan, smoothedTilt; u8 panDmx, tiltDmx, flags
+    STREAM_DMX = 2,     // u8 count; count x (u16 channel (0-based), u8 value)
+    STREAM_GESTURE = 3, // u8 length; gesture name bytes
+    STREAM_STATS = 4    // u32 frames; u64 sent, suppressed, keyframes, streamDropped
+};
+
+// Pose flags
+const uint8_t STREAM_POSE_FACE = 0x01;      // Face detected this frame
+const uint8_t STREAM_POSE_LANDMARKS = 0x02; // Pose came from landmarks (not face center)
+
+// Channel/value pair carried by STREAM_DMX
+struct StreamDmxValue {
+    uint16_t channel; // 0-based DMX channel
+    uint8_t value;
+};
+
+class BinaryStream {
+public:
+    BinaryStream() = default;
+    ~BinaryStream();
+    BinaryStream(const BinaryStream&) = delete;
+    BinaryStream& operator=(const BinaryStream&) = delete;
+
+    // Set the socket path; connection is attempted lazily on the next send
+    void setSocketPath(const std::string& path);
+    bool isConnected() const { return fd_ >= 0; }
+
+    bool sendPose(float rawPan, float rawTilt, float smoothedPan, float smoothedTilt,
+                  int panDmx, int tiltDmx, uint8_t flags);
+    bool sendDmx(const StreamDmxValue* values, size_t count);
+    bool sendGesture(const std::string& gesture);
+    bool sendStats(uint32_t frames, uint64_t sent, uint64_t suppressed, uint64_t keyframes);
+
+    uint64_t droppedCount() const { return dropped_; }
+
+private:
+    // Message building (into buffer_, reused between sends)
+    void begin(StreamMessageType type);
+    void putU8(uint8_t v) { buffer_.push_back(v); }
+    void putU16(uint16_t v);
+    void putU32(uint32_t v);
+    void putU64(uint64_t v);
+    void putF32(float v);
+    bool finish();
+
+    bool ensureConnected();
+    bool flushPending();
+    void disconnect();
+
+    std::string socketPath_;
+    int fd_ = -1;
+    uint32_t sequence_ = 0;
+    uint64_t dropped_ = 0;
+    std::vector<uint8_t> buffer_;
+    std::vector<uint8_t> pending_; // Tail of a partially written message
+    std::chrono::steady_clock::time_point nextConnectAttempt_;
+};
@@ -0,0 +1,137 @@
+#include "camera_frame.h"
+#include "v4l2_capture.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+
+CaptureFormat parseCaptureFormat(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "yuyv" || lower == "yuy2") return CAPTURE_YUYV;
+    if (lower == "nv12") return CAPTURE_NV12;
+    if (lower == "mjpeg" || lower == "mjpg") return CAPTURE_MJPEG;
+    return CAPTURE_BGR;
+}
+
+const char* captureFormatName(CaptureFormat format) {
+    switch (format) {
+        case CAPTURE_YUYV: return "yuyv";
+        case CAPTURE_NV12: return "nv12";
+        case CAPTURE_MJPEG: return "mjpeg";
+        default: return "bgr";
+    }
+}
+
+bool requestCaptureFormat(cv::VideoCapture& cap, CaptureFormat format) {
+    if (format == CAPTURE_BGR) {
+        cap.set(cv::CAP_PROP_CONVERT_RGB, 1);
+        return true;
+    }
+    int fourcc = format == CAPTURE_YUYV ? cv::VideoWriter::fourcc('Y', 'U', 'Y', 'V')
+               : format == CAPTURE_NV12 ? cv::VideoWriter::fourcc('N', 'V', '1', '2')
+               : cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+    bool fourccSet = cap.set(cv::CAP_PROP_FOURCC, fourcc);
+    bool rawSet = cap.set(cv::CAP_PROP_CONVERT_RGB, 0);
+    return fourccSet && rawSet;
+}
+
+// Drop a header onto memory we do not own (a V4L2 buffer already handed back
+// to the driver) before writing, instead of writing into it
+static void releaseIfBorrowed(cv::Mat& m) {
+    if (!m.u) m.release();
+}
+
+bool CameraFrame::read(cv::VideoCapture& cap) {
+    bgrReady_ = false;
+    releaseIfBorrowed(raw_); // Left over from a V4L2 camera that has been swapped out
+    if (!cap.read(raw_) || raw_.empty()) {
+        return false;
+    }
+    const V4l2Capture* v4l2 = dynamic_cast<const V4l2Capture*>(&cap);
+    if (v4l2 && v4l2->frameTimestampUs() > 0) {
+        timestampUs_ = v4l2->frameTimestampUs();
+    } else {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        timestampUs_ = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    }
+    if (raw_.channels() != 3 && parseRaw(cap)) {
+        return true;
+    }
+
+    // Decoded by the backend (or a layout we do not know: shown as delivered)
+    if (raw_.rows == 1 && !warnedLayout_) {
+        std::cerr << "Warning: Unrecognized raw camera frame (" << raw_.cols << "x" << raw_.rows
+                  << ", " << raw_.channels() << " channels)" << std::endl;
+        warnedLayout_ = true;
+    }
+    format_ = CAPTURE_BGR;
+    size_ = raw_.size();
+    luma_.release();
+    bgr_ = raw_;
+    bgrReady_ = true;
+    return true;
+}
+
+// Recognize the raw buffer by its shape; the backend may hand it over as an
+// image (YUYV as 2 channels, NV12 as 1.5x height) or as one row of bytes
+bool CameraFrame::parseRaw(cv::VideoCapture& cap) {
+    cv::Mat buffer = raw_;
+    if (buffer.type() == CV_8UC1 && buffer.rows == 1 && buffer.cols > 2 &&
+        buffer.ptr<uchar>()[0] == 0xFF && buffer.ptr<uchar>()[1] == 0xD8) {
+        // JPEG start-of-image marker: a compressed MJPEG frame
+        format_ = CAPTURE_MJPEG;
+        size_ = cv::Size(static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH)),
+                         static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT)));
+        luma_.release();
+        yuv_ = buffer;
+        return true;
+    }
+    if (buffer.type() == CV_8UC1) {
+        int width = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
+        int height = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+        if (width <= 0 || height <= 0) {
+            return false;
+        }
+        size_t pixels = static_cast<size_t>(width) * height;
+        if (buffer.rows == 1 && buffer.isContinuous() && buffer.total() == pixels * 2) {
+            buffer = buffer.reshape(2, height);
+        } else if (buffer.rows == 1 && buffer.isContinuous() && buffer.total() == pixels * 3 / 2) {
+            buffer = buffer.reshape(1, height * 3 / 2);
+        } else if (buffer.cols != width || buffer.rows != height * 3 / 2) {
+            return false; // Plain grayscale camera
+        }
+    }
+
+    if (buffer.type() == CV_8UC2) {
+        format_ = CAPTURE_YUYV;
+        size_ = buffer.size();
+        releaseIfBorrowed(luma_);
+        cv::extractChannel(buffer, luma_, 0); // Y0 U Y1 V: Y is channel 0 of every pixel
+    } else if (buffer.type() == CV_8UC1) {
+        format_ = CAPTURE_NV12;
+        size_ = cv::Size(buffer.cols, buffer.rows * 2 / 3);
+        luma_ = buffer.rowRange(0, size_.height); // Y plane, then interleaved UV
+    } else {
+        return false;
+    }
+    yuv_ = buffer;
+    return true;
+}
+
+const cv::Mat& CameraFrame::bgr() {
+    if (!bgrReady_) {
+        releaseIfBorrowed(bgr_);
+        if (format_ == CAPTURE_MJPEG) {
+            bgr_ = cv::imdecode(yuv_, cv::IMREAD_COLOR);
+        } else {
+            cv::cvtColor(yuv_, bgr_, format_ == CAPTURE_YUYV ? cv::COLOR_YUV2BGR_YUYV : cv::COLOR_YUV2BGR_NV12);
+        }
+        bgrReady_ = true;
+    }
+    return bgr_;
+}
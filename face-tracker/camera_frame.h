@@ -0,0 +1,87 @@
+// Camera frames in the camera's own pixel format (captureFormat)
+//
+// With captureFormat "bgr" the capture backend decodes every frame to BGR and
+// detection converts it straight back to gray. With "yuyv" or "nv12" the
+// backend is asked for raw frames instead (CAP_PROP_CONVERT_RGB off) and
+// detection reads the Y plane, which already is the gray image:
+//
+//   - NV12: the Y plane is the top rows of the buffer (no copy at all)
+//   - YUYV: Y is every other byte (one extractChannel, no color math)
+//
+// With "mjpeg" the frame stays compressed (jpeg()); the tracking loop decodes
+// it on a worker pool at reduced size for detection (jpeg_decode_pool.h).
+//
+// BGR is only produced by bgr(), i.e. when a preview actually needs color.
+// Backends that ignore the request keep delivering BGR; that is detected per
+// frame from the buffer layout, so nothing breaks, it just is not faster.
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <cstdint>
+#include <string>
+
+enum CaptureFormat {
+    CAPTURE_BGR = 0,  // Decoded by the backend
+    CAPTURE_YUYV,     // Packed 4:2:2 (most USB webcams)
+    CAPTURE_NV12,     // Planar 4:2:0 (CSI cameras, some USB cameras)
+    CAPTURE_MJPEG     // Compressed; needed for high frame rates over USB 2
+};
+
+// "bgr", "yuyv", "nv12" or "mjpeg" (case-insensitive); anything else is BGR
+CaptureFormat parseCaptureFormat(const std::string& name);
+const char* captureFormatName(CaptureFormat format);
+
+// Ask a freshly opened camera for `format`; false if the backend refused
+bool requestCaptureFormat(cv::VideoCapture& cap, CaptureFormat format);
+
+// Capture-to-pose latency over one stats interval
+struct CaptureLatencyStats {
+    uint64_t frames = 0;
+    int64_t totalUs = 0;
+    int64_t maxUs = 0;
+
+    void add(int64_t us) {
+        frames++;
+        totalUs += us;
+        maxUs = us > maxUs ? us : maxUs;
+    }
+};
+
+class CameraFrame {
+public:
+    // Grab the next frame from `cap`; false if the camera delivered nothing
+    bool read(cv::VideoCapture& cap);
+
+    // Layout of the current frame (BGR when the backend ignored the request)
+    CaptureFormat format() const { return format_; }
+    bool isRaw() const { return format_ != CAPTURE_BGR; }
+    bool empty() const { return raw_.empty(); }
+    cv::Size size() const { return size_; }
+    // Capture time in steady_clock microseconds: the kernel's timestamp with
+    // captureBackend "v4l2", otherwise when the backend handed the frame over
+    int64_t timestampUs() const { return timestampUs_; }
+
+    // Y plane of a raw frame (shares the capture buffer for NV12; empty for MJPEG)
+    const cv::Mat& luma() const { return luma_; }
+    // Compressed MJPEG frame as one row of bytes (shares the capture buffer)
+    const cv::Mat& jpeg() const { return yuv_; }
+    // Raw frame in its YUYV (2 channels) or NV12 (1.5x height) image layout
+    const cv::Mat& yuv() const { return yuv_; }
+    // BGR image, converted from raw on first use per frame
+    const cv::Mat& bgr();
+
+private:
+    bool parseRaw(cv::VideoCapture& cap);
+
+    cv::Mat raw_;   // As delivered by the backend
+    cv::Mat yuv_;   // raw_ reshaped to its YUYV/NV12 image layout (MJPEG: the bytes)
+    cv::Mat luma_;
+    cv::Mat bgr_;
+    bool bgrReady_ = false;
+    CaptureFormat format_ = CAPTURE_BGR;
+    cv::Size size_;
+    int64_t timestampUs_ = 0;
+    bool warnedLayout_ = false;
+};
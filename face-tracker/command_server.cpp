@@ -0,0 +1,168 @@
+#include "command_server.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0
+#endif
+
+static const char* daemonModeName(int mode) {
+    switch (mode) {
+        case DAEMON_TRACKING: return "tracking";
+        case DAEMON_PAUSED: return "paused";
+        default: return "standby";
+    }
+}
+
+CommandServer::~CommandServer() {
+    stop();
+}
+
+std::string CommandServer::handleLine(const std::string& line) {
+    size_t space = line.find(' ');
+    std::string name = line.substr(0, space);
+    std::string argument = space == std::string::npos ? "" : line.substr(space + 1);
+
+    DaemonCommand command;
+    if (name == "status") {
+        return std::string("ok ") + daemonModeName(mode_) + " frames=" + std::to_string(frames_.load());
+    } else if (name == "start") {
+        command.type = DAEMON_START;
+    } else if (name == "pause") {
+        command.type = DAEMON_PAUSE;
+    } else if (name == "resume") {
+        command.type = DAEMON_RESUME;
+    } else if (name == "stop") {
+        command.type = DAEMON_STOP;
+    } else if (name == "shutdown") {
+        command.type = DAEMON_SHUTDOWN;
+    } else if (name == "trace") {
+        command.type = DAEMON_TRACE;
+    } else if (name == "reconfigure") {
+        command.type = DAEMON_RECONFIGURE;
+        try {
+            command.config = nlohmann::json::parse(argument);
+        } catch (const nlohmann::json::exception& e) {
+            return std::string("error invalid json: ") + e.what();
+        }
+        if (!command.config.is_object()) {
+            return "error reconfigure expects a JSON object";
+        }
+    } else {
+        return "error unknown command: " + name;
+    }
+
+    if (!queue_.push(command)) {
+        return "error busy"; // Tracking thread stalled
+    }
+    return "ok";
+}
+
+#ifdef _WIN32
+
+// Unix domain sockets are not wired up on Windows (see binary_stream.cpp)
+bool CommandServer::start(const std::string& /*socketPath*/) {
+    std::cerr << "Daemon command socket is not supported on Windows" << std::endl;
+    return false;
+}
+
+void CommandServer::stop() {}
+void CommandServer::run() {}
+void CommandServer::serveClient(int /*client*/) {}
+
+#else
+
+bool CommandServer::start(const std::string& socketPath) {
+    if (running_) return true;
+
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Command socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        std::cerr << "Failed to create command socket" << std::endl;
+        return false;
+    }
+
+    unlink(socketPath.c_str()); // Stale socket from a previous run
+    if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(sock, 2) < 0) {
+        std::cerr << "Failed to listen on command socket " << socketPath << std::endl;
+        close(sock);
+        return false;
+    }
+
+    socket_ = sock;
+    socketPath_ = socketPath;
+    running_ = true;
+    thread_ = std::thread(&CommandServer::run, this);
+    std::cout << "Daemon command socket: " << socketPath << std::endl;
+    return true;
+}
+
+void CommandServer::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    close(socket_);
+    socket_ = -1;
+    unlink(socketPath_.c_str());
+}
+
+void CommandServer::run() {
+    // One client at a time keeps this the queue's only producer
+    while (running_) {
+        struct pollfd listenPoll = {socket_, POLLIN, 0};
+        if (::poll(&listenPoll, 1, 200) <= 0) continue;
+        int client = accept(socket_, nullptr, nullptr);
+        if (client < 0) continue;
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        serveClient(client);
+        close(client);
+    }
+}
+
+void CommandServer::serveClient(int client) {
+    std::string buffer;
+    char chunk[1024];
+    while (running_) {
+        struct pollfd clientPoll = {client, POLLIN, 0};
+        int ready = ::poll(&clientPoll, 1, 200);
+        if (ready < 0) return;
+        if (ready == 0) continue;
+
+        ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) return; // Client closed
+        buffer.append(chunk, static_cast<size_t>(received));
+        if (buffer.size() > 65536) return; // No sane command is this long
+
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+
+            std::string reply = handleLine(line) + "\n";
+            if (send(client, reply.data(), reply.size(), MSG_NOSIGNAL) < 0) return;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,80 @@
+// Command socket for daemon mode (--daemon)
+//
+// In daemon mode the tracker stays resident with models loaded and waits
+// for commands from the Node backend instead of being spawned per session.
+// Commands are newline-terminated text on a Unix domain socket owned by the
+// tracker; each gets a one-line reply ("ok ..." or "error ..."):
+//
+//   start               begin tracking from the home position
+//   pause               stop output, fixtures stay where they are
+//   resume              continue tracking after pause
+//   stop                stop tracking and return fixtures home (standby)
+//   reconfigure <json>  apply config fields (same rules as a config file edit)
+//   status              reply "ok <standby|tracking|paused> frames=<n>"
+//   trace               write the frame trace to tracePath (frame_trace.h)
+//   shutdown            exit the tracker
+//
+// Commands are parsed on the server thread and handed to the tracking thread
+// through an SPSC queue; they take effect at the start of the next frame.
+#pragma once
+
+#include "spsc_queue.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+const char* const DEFAULT_COMMAND_SOCKET_PATH = "/tmp/artbastard-face-tracker-control.sock";
+
+enum DaemonCommandType {
+    DAEMON_START,
+    DAEMON_PAUSE,
+    DAEMON_RESUME,
+    DAEMON_STOP,
+    DAEMON_RECONFIGURE,
+    DAEMON_TRACE,
+    DAEMON_SHUTDOWN
+};
+
+// What the tracking loop is doing
+enum DaemonMode { DAEMON_STANDBY, DAEMON_TRACKING, DAEMON_PAUSED };
+
+struct DaemonCommand {
+    DaemonCommandType type = DAEMON_START;
+    nlohmann::json config; // DAEMON_RECONFIGURE only
+};
+
+class CommandServer {
+public:
+    CommandServer() = default;
+    ~CommandServer();
+    CommandServer(const CommandServer&) = delete;
+    CommandServer& operator=(const CommandServer&) = delete;
+
+    bool start(const std::string& socketPath);
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // Tracking thread: next pending command, if any
+    bool poll(DaemonCommand& command) { return queue_.pop(command); }
+
+    // Tracking thread: published for "status" replies
+    void setMode(DaemonMode mode) { mode_ = mode; }
+    void setFrameCount(uint64_t frames) { frames_ = frames; }
+
+private:
+    void run();
+    void serveClient(int client);
+    std::string handleLine(const std::string& line);
+
+    std::atomic<bool> running_{false};
+    int socket_ = -1;
+    std::string socketPath_;
+    std::thread thread_;
+    SpscQueue<DaemonCommand, 16> queue_;
+    std::atomic<int> mode_{DAEMON_STANDBY};
+    std::atomic<uint64_t> frames_{0};
+};
@@ -0,0 +1,400 @@
+#include "config.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <climits>
+#else
+    #include <filesystem>
+#endif
+
+using json = nlohmann::json;
+
+static ConfigField intField(const char* name, int Config::* member, ConfigApply apply = APPLY_LIVE) {
+    return {name, CONFIG_INT, apply, member, nullptr, nullptr, nullptr};
+}
+
+static ConfigField floatField(const char* name, float Config::* member, ConfigApply apply = APPLY_LIVE) {
+    return {name, CONFIG_FLOAT, apply, nullptr, member, nullptr, nullptr};
+}
+
+static ConfigField boolField(const char* name, bool Config::* member, ConfigApply apply = APPLY_LIVE) {
+    return {name, CONFIG_BOOL, apply, nullptr, nullptr, member, nullptr};
+}
+
+static ConfigField stringField(const char* name, std::string Config::* member, ConfigApply apply = APPLY_LIVE) {
+    return {name, CONFIG_STRING, apply, nullptr, nullptr, nullptr, member};
+}
+
+// The one list of persisted fields (JSON key = member name)
+const std::vector<ConfigField>& configFields() {
+    static const std::vector<ConfigField> fields = {
+        stringField("dmxApiUrl", &Config::dmxApiUrl),
+        intField("panChannel", &Config::panChannel),
+        intField("tiltChannel", &Config::tiltChannel),
+        intField("irisChannel", &Config::irisChannel),
+        intField("zoomChannel", &Config::zoomChannel),
+        intField("focusChannel", &Config::focusChannel),
+        intField("cameraIndex", &Config::cameraIndex, APPLY_CAMERA_REOPEN),
+        stringField("captureFormat", &Config::captureFormat, APPLY_CAMERA_REOPEN),
+        stringField("captureBackend", &Config::captureBackend, APPLY_CAMERA_REOPEN),
+        intField("v4l2Buffers", &Config::v4l2Buffers, APPLY_CAMERA_REOPEN),
+        intField("captureDecodeThreads", &Config::captureDecodeThreads, APPLY_RESTART),
+        intField("captureDecodeScale", &Config::captureDecodeScale),
+        stringField("logLevel", &Config::logLevel),
+        intField("logRateLimit", &Config::logRateLimit),
+        intField("updateRate", &Config::updateRate),
+        floatField("panSensitivity", &Config::panSensitivity),
+        floatField("tiltSensitivity", &Config::tiltSensitivity),
+        intField("panOffset", &Config::panOffset),
+        intField("tiltOffset", &Config::tiltOffset),
+        intField("irisValue", &Config::irisValue),
+        intField("zoomValue", &Config::zoomValue),
+        intField("focusValue", &Config::focusValue),
+        // showPreview=false quits the tracker, so it is never applied live
+        boolField("showPreview", &Config::showPreview, APPLY_RESTART),
+        boolField("previewWindows", &Config::previewWindows, APPLY_RESTART),
+        intField("previewFps", &Config::previewFps),
+        boolField("show3DVisualization", &Config::show3DVisualization),
+        floatField("smoothingFactor", &Config::smoothingFactor),
+        floatField("maxVelocity", &Config::maxVelocity),
+        floatField("brightness", &Config::brightness),
+        floatField("contrast", &Config::contrast),
+        intField("cameraExposure", &Config::cameraExposure, APPLY_CAMERA),
+        intField("cameraBrightness", &Config::cameraBrightness, APPLY_CAMERA),
+        boolField("autoExposure", &Config::autoExposure, APPLY_CAMERA),
+
+        // OSC configuration
+        boolField("useOSC", &Config::useOSC),
+        stringField("oscHost", &Config::oscHost),
+        intField("oscPort", &Config::oscPort),
+        stringField("oscPanPath", &Config::oscPanPath),
+        stringField("oscTiltPath", &Config::oscTiltPath),
+        stringField("oscIrisPath", &Config::oscIrisPath),
+        stringField("oscZoomPath", &Config::oscZoomPath),
+        stringField("oscFocusPath", &Config::oscFocusPath),
+
+        // Range cutoffs
+        intField("panMin", &Config::panMin),
+        intField("panMax", &Config::panMax),
+        intField("tiltMin", &Config::tiltMin),
+        intField("tiltMax", &Config::tiltMax),
+        intField("irisMin", &Config::irisMin),
+        intField("irisMax", &Config::irisMax),
+        intField("zoomMin", &Config::zoomMin),
+        intField("zoomMax", &Config::zoomMax),
+        intField("focusMin", &Config::focusMin),
+        intField("focusMax", &Config::focusMax),
+
+        // Rigging parameters
+        floatField("panScale", &Config::panScale),
+        floatField("tiltScale", &Config::tiltScale),
+        floatField("panDeadZone", &Config::panDeadZone),
+        floatField("tiltDeadZone", &Config::tiltDeadZone),
+        floatField("panLimit", &Config::panLimit),
+        floatField("tiltLimit", &Config::tiltLimit),
+        floatField("panGear", &Config::panGear),
+        floatField("tiltGear", &Config::tiltGear),
+
+        // Binary stream (socket path is re-read every frame)
+        boolField("useStream", &Config::useStream),
+        stringField("streamSocketPath", &Config::streamSocketPath),
+
+        // Shared memory ring
+        boolField("useSharedMemory", &Config::useSharedMemory, APPLY_RESTART),
+        stringField("sharedMemoryName", &Config::sharedMemoryName, APPLY_RESTART),
+        intField("sharedMemoryPreviewWidth", &Config::sharedMemoryPreviewWidth),
+
+        // MJPEG preview stream
+        boolField("mjpegEnabled", &Config::mjpegEnabled, APPLY_RESTART),
+        intField("mjpegPort", &Config::mjpegPort, APPLY_RESTART),
+        intField("mjpegFps", &Config::mjpegFps, APPLY_RESTART),
+        intField("mjpegWidth", &Config::mjpegWidth, APPLY_RESTART),
+        intField("mjpegQuality", &Config::mjpegQuality, APPLY_RESTART),
+        boolField("metricsEnabled", &Config::metricsEnabled, APPLY_RESTART),
+        intField("metricsPort", &Config::metricsPort, APPLY_RESTART),
+        boolField("traceEnabled", &Config::traceEnabled),
+        intField("traceSpans", &Config::traceSpans, APPLY_RESTART),
+        stringField("tracePath", &Config::tracePath),
+        intField("watchdogTimeoutMs", &Config::watchdogTimeoutMs),
+        intField("failsafePan", &Config::failsafePan),
+        intField("failsafeTilt", &Config::failsafeTilt),
+        stringField("syntheticMotion", &Config::syntheticMotion, APPLY_CAMERA_REOPEN),
+        intField("syntheticPeriodMs", &Config::syntheticPeriodMs, APPLY_CAMERA_REOPEN),
+        floatField("syntheticAmplitude", &Config::syntheticAmplitude, APPLY_CAMERA_REOPEN),
+        stringField("syntheticFaceImage", &Config::syntheticFaceImage, APPLY_CAMERA_REOPEN),
+        intField("syntheticFaceSize", &Config::syntheticFaceSize, APPLY_CAMERA_REOPEN),
+        floatField("syntheticNoise", &Config::syntheticNoise, APPLY_CAMERA_REOPEN),
+        floatField("syntheticBlur", &Config::syntheticBlur, APPLY_CAMERA_REOPEN),
+        floatField("syntheticLighting", &Config::syntheticLighting, APPLY_CAMERA_REOPEN),
+        floatField("syntheticLightDrift", &Config::syntheticLightDrift, APPLY_CAMERA_REOPEN),
+        boolField("syntheticRealtime", &Config::syntheticRealtime, APPLY_CAMERA_REOPEN),
+        intField("syntheticSeed", &Config::syntheticSeed, APPLY_CAMERA_REOPEN),
+        intField("syntheticFrames", &Config::syntheticFrames),
+        stringField("syntheticTruthPath", &Config::syntheticTruthPath, APPLY_RESTART),
+
+        // Pose log
+        stringField("poseLogPath", &Config::poseLogPath),
+
+        // Frame recorder
+        stringField("recordPath", &Config::recordPath),
+        stringField("recordFormat", &Config::recordFormat),
+        intField("recordQueueFrames", &Config::recordQueueFrames),
+
+        // OSC control input
+        boolField("oscControlEnabled", &Config::oscControlEnabled, APPLY_RESTART),
+        intField("oscControlPort", &Config::oscControlPort, APPLY_RESTART),
+        stringField("oscControlBind", &Config::oscControlBind, APPLY_RESTART),
+
+        // Daemon mode
+        boolField("daemonKeepCameraOpen", &Config::daemonKeepCameraOpen),
+
+        // Change-driven output
+        intField("outputHysteresis", &Config::outputHysteresis),
+        intField("keyframeInterval", &Config::keyframeInterval),
+    };
+    return fields;
+}
+
+const ConfigField* findConfigField(const std::string& name) {
+    for (const auto& field : configFields()) {
+        if (name == field.name) return &field;
+    }
+    return nullptr;
+}
+
+bool readConfigField(const ConfigField& field, const json& value, Config& config) {
+    switch (field.type) {
+        case CONFIG_INT:
+            if (!value.is_number()) break;
+            config.*field.intMember = value.get<int>();
+            return true;
+        case CONFIG_FLOAT:
+            if (!value.is_number()) break;
+            config.*field.floatMember = value.get<float>();
+            return true;
+        case CONFIG_BOOL:
+            if (!value.is_boolean()) break;
+            config.*field.boolMember = value.get<bool>();
+            return true;
+        case CONFIG_STRING:
+            if (!value.is_string()) break;
+            config.*field.stringMember = value.get<std::string>();
+            return true;
+    }
+    std::cerr << "Config: ignoring " << field.name << " (unexpected type: " << value.type_name() << ")" << std::endl;
+    return false;
+}
+
+void writeConfigField(const ConfigField& field, const Config& config, json& j) {
+    switch (field.type) {
+        case CONFIG_INT: j[field.name] = config.*field.intMember; break;
+        case CONFIG_FLOAT: j[field.name] = config.*field.floatMember; break;
+        case CONFIG_BOOL: j[field.name] = config.*field.boolMember; break;
+        case CONFIG_STRING: j[field.name] = config.*field.stringMember; break;
+    }
+}
+
+bool configFieldEquals(const ConfigField& field, const Config& a, const Config& b) {
+    switch (field.type) {
+        case CONFIG_INT: return a.*field.intMember == b.*field.intMember;
+        case CONFIG_FLOAT: return a.*field.floatMember == b.*field.floatMember;
+        case CONFIG_BOOL: return a.*field.boolMember == b.*field.boolMember;
+        case CONFIG_STRING: return a.*field.stringMember == b.*field.stringMember;
+    }
+    return true;
+}
+
+void copyConfigField(const ConfigField& field, const Config& from, Config& to) {
+    switch (field.type) {
+        case CONFIG_INT: to.*field.intMember = from.*field.intMember; break;
+        case CONFIG_FLOAT: to.*field.floatMember = from.*field.floatMember; break;
+        case CONFIG_BOOL: to.*field.boolMember = from.*field.boolMember; break;
+        case CONFIG_STRING: to.*field.stringMember = from.*field.stringMember; break;
+    }
+}
+
+std::string configFieldToString(const ConfigField& field, const Config& config) {
+    std::ostringstream out;
+    switch (field.type) {
+        case CONFIG_INT: out << config.*field.intMember; break;
+        case CONFIG_FLOAT: out << config.*field.floatMember; break;
+        case CONFIG_BOOL: out << (config.*field.boolMember ? "true" : "false"); break;
+        case CONFIG_STRING: out << config.*field.stringMember; break;
+    }
+    return out.str();
+}
+
+void applyConfigJson(const json& j, Config& config) {
+    if (!j.is_object()) return;
+    for (const auto& field : configFields()) {
+        auto it = j.find(field.name);
+        if (it != j.end()) {
+            readConfigField(field, *it, config);
+        }
+    }
+}
+
+std::vector<const ConfigField*> diffConfig(const Config& current, const Config& next) {
+    std::vector<const ConfigField*> changed;
+    for (const auto& field : configFields()) {
+        if (!configFieldEquals(field, current, next)) {
+            changed.push_back(&field);
+        }
+    }
+    return changed;
+}
+
+// Load configuration from JSON file
+Config loadConfig(const std::string& configPath) {
+    Config config;
+    std::ifstream file(configPath);
+
+    if (!file.is_open()) {
+        std::cout << "Config file not found, using defaults. Creating " << configPath << std::endl;
+        // Save default config
+        saveConfig(config, configPath);
+        return config;
+    }
+
+    try {
+        json j;
+        file >> j;
+        applyConfigJson(j, config);
+    } catch (const std::exception& e) {
+        std::cerr << "Error parsing " << configPath << ": " << e.what() << " (using defaults)" << std::endl;
+    }
+
+    return config;
+}
+
+// Save configuration to JSON file
+void saveConfig(const Config& config, const std::string& configPath) {
+    json j;
+    for (const auto& field : configFields()) {
+        writeConfigField(field, config, j);
+    }
+
+    std::ofstream file(configPath);
+    file << j.dump(2);
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+bool ConfigWatcher::start(const std::string& configPath) {
+    if (running_) return true;
+    path_ = configPath;
+
+    // Remember the current contents so the first event only reports real edits
+    std::ifstream file(path_);
+    if (file.is_open()) {
+        lastContent_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    running_ = true;
+    thread_ = std::thread(&ConfigWatcher::run, this);
+    return true;
+}
+
+void ConfigWatcher::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+}
+
+bool ConfigWatcher::takeUpdate(json& j) {
+    if (!hasUpdate_.load(std::memory_order_acquire)) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    j = std::move(pending_);
+    pending_ = json();
+    hasUpdate_ = false;
+    return true;
+}
+
+// Read and parse the file on the watcher thread; only changed, valid content is handed over
+void ConfigWatcher::readFile() {
+    std::ifstream file(path_);
+    if (!file.is_open()) return;
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (content == lastContent_) return;
+
+    json j = json::parse(content, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        // Usually a half-written file; the writer's close will trigger another read
+        return;
+    }
+    lastContent_ = std::move(content);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = std::move(j);
+    hasUpdate_.store(true, std::memory_order_release);
+}
+
+#ifdef __linux__
+
+void ConfigWatcher::run() {
+    // Watch the directory, not the file: editors and fs.writeFile may replace it via rename
+    std::string dir = ".";
+    std::string name = path_;
+    size_t slash = path_.find_last_of('/');
+    if (slash != std::string::npos) {
+        dir = slash == 0 ? "/" : path_.substr(0, slash);
+        name = path_.substr(slash + 1);
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        std::cerr << "Config watcher: inotify unavailable, live reload disabled" << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    while (running_) {
+        // Short timeout so stop() never waits long
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue;
+
+        bool touched = false;
+        ssize_t length;
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length;) {
+                auto* event = reinterpret_cast<struct inotify_event*>(p);
+                if (event->len > 0 && name == event->name) {
+                    touched = true;
+                }
+                p += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        if (touched) {
+            readFile();
+        }
+    }
+    close(fd);
+}
+
+#else
+
+void ConfigWatcher::run() {
+    // No inotify: poll the modification time (cheap stat) and only read when it moves
+    std::error_code ec;
+    auto lastWrite = std::filesystem::last_write_time(path_, ec);
+    while (running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        auto writeTime = std::filesystem::last_write_time(path_, ec);
+        if (!ec && writeTime != lastWrite) {
+            lastWrite = writeTime;
+            readFile();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,218 @@
+// Tracker configuration (face-tracker-config.json)
+//
+// Every persisted field is listed once in the field table in config.cpp;
+// loading, saving, live reload and remote control all go through it.
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char* const DEFAULT_CONFIG_PATH = "face-tracker-config.json";
+
+// Configuration structure
+struct Config {
+    std::string dmxApiUrl = "http://localhost:3030/api/dmx/batch";
+    int panChannel = 1;  // DMX channel for pan (default)
+    int tiltChannel = 2; // DMX channel for tilt (default)
+    int irisChannel = 0; // DMX channel for iris (0 = disabled)
+    int zoomChannel = 0; // DMX channel for zoom (0 = disabled)
+    int focusChannel = 0; // DMX channel for focus (0 = disabled)
+    int cameraIndex = 0;
+    std::string captureFormat = "bgr"; // Camera pixel format: "bgr", or raw "yuyv"/"nv12" (detection reads the Y plane)
+    std::string captureBackend = "opencv"; // "opencv", "v4l2" (Linux: direct mmap capture with kernel timestamps) or "synthetic"
+    int v4l2Buffers = 4;                   // Driver buffers for the v4l2 backend (2-32)
+    int captureDecodeThreads = 2;          // MJPEG decode worker threads (1-8)
+    int captureDecodeScale = 2;            // MJPEG: detect on a 1/1, 1/2, 1/4 or 1/8 size decode
+    std::string logLevel = "info";         // Console output: "debug", "info", "warn" or "error"
+    int logRateLimit = 30;                 // Lines per second per message type (0 = unlimited)
+    int updateRate = 20; // Updates per second (reduced for smoother movement)
+    float panSensitivity = 1.0f;
+    float tiltSensitivity = 1.0f;
+    int panOffset = 128;  // Center position for pan (0-255)
+    int tiltOffset = 128; // Center position for tilt (0-255)
+    int irisValue = 128;  // Default iris value (0-255)
+    int zoomValue = 128;  // Default zoom value (0-255)
+    int focusValue = 128; // Default focus value (0-255)
+    bool showPreview = true;
+    bool previewWindows = true; // Show the OpenCV windows (false = preview only via MJPEG)
+    int previewFps = 15;        // Max OpenCV window refresh rate (drawn on their own thread)
+    bool show3DVisualization = true; // Show 3D fixture visualization
+    float smoothingFactor = 0.85f; // Smoothing for movement (0.0-1.0, higher = smoother)
+    float maxVelocity = 5.0f; // Maximum change per update (prevents overshooting)
+    // Camera brightness/contrast controls
+    float brightness = 1.0f;    // Brightness multiplier (0.0-3.0, default 1.0)
+    float contrast = 1.0f;      // Contrast multiplier (0.0-3.0, default 1.0)
+    int cameraExposure = -1;    // Camera exposure (-1 = auto, or specific value)
+    int cameraBrightness = -1;  // Camera brightness (-1 = auto, or specific value)
+    bool autoExposure = true;   // Enable auto exposure
+    
+    // OSC Configuration
+    bool useOSC = false;              // Use OSC instead of HTTP API
+    std::string oscHost = "127.0.0.1"; // OSC target host
+    int oscPort = 9000;               // OSC target port
+    std::string oscPanPath = "/dmx/pan";    // OSC path for pan
+    std::string oscTiltPath = "/dmx/tilt";  // OSC path for tilt
+    std::string oscIrisPath = "/dmx/iris";  // OSC path for iris
+    std::string oscZoomPath = "/dmx/zoom";  // OSC path for zoom
+    std::string oscFocusPath = "/dmx/focus"; // OSC path for focus
+    
+    // Range cutoff values (min/max for each channel)
+    int panMin = 0;      // Minimum DMX value for pan
+    int panMax = 255;    // Maximum DMX value for pan
+    int tiltMin = 0;     // Minimum DMX value for tilt
+    int tiltMax = 255;   // Maximum DMX value for tilt
+    int irisMin = 0;     // Minimum DMX value for iris
+    int irisMax = 255;   // Maximum DMX value for iris
+    int zoomMin = 0;     // Minimum DMX value for zoom
+    int zoomMax = 255;   // Maximum DMX value for zoom
+    int focusMin = 0;    // Minimum DMX value for focus
+    int focusMax = 255;  // Maximum DMX value for focus
+    
+    // Rigging parameters (mechanical calibration)
+    float panScale = 1.0f;    // Scale factor for pan movement
+    float tiltScale = 1.0f;   // Scale factor for tilt movement
+    float panDeadZone = 0.0f; // Dead zone threshold for pan (ignore small movements)
+    float tiltDeadZone = 0.0f; // Dead zone threshold for tilt
+    float panLimit = 1.0f;    // Maximum range multiplier for pan (0.0-1.0)
+    float tiltLimit = 1.0f;   // Maximum range multiplier for tilt (0.0-1.0)
+    float panGear = 1.0f;     // Gear ratio for pan (higher = slower movement)
+    float tiltGear = 1.0f;    // Gear ratio for tilt (higher = slower movement)
+    
+    // Binary stream to the Node backend (replaces HTTP/OSC output when enabled)
+    bool useStream = false;
+    std::string streamSocketPath = "/tmp/artbastard-face-tracker.sock";
+    
+    // Shared memory ring for local readers (pose, landmarks, DMX, preview frames)
+    bool useSharedMemory = false;
+    std::string sharedMemoryName = "/artbastard-face-tracker";
+    int sharedMemoryPreviewWidth = 160; // Preview frame width (0 = no preview, max 320)
+    
+    // MJPEG preview stream (http://127.0.0.1:<mjpegPort>/stream.mjpg)
+    bool mjpegEnabled = false;
+    int mjpegPort = 8081;
+    int mjpegFps = 15;      // Max preview frame rate
+    int mjpegWidth = 640;   // Encoded width (0 = full theatre size)
+    int mjpegQuality = 75;  // JPEG quality (10-100)
+    
+    // Prometheus metrics (http://127.0.0.1:<metricsPort>/metrics)
+    bool metricsEnabled = false;
+    int metricsPort = 9464;
+    
+    // Per-frame trace spans, written as Chrome trace JSON on SIGUSR1 or the daemon "trace" command
+    bool traceEnabled = false;
+    int traceSpans = 16384;                // Spans kept (newest win); memory is allocated on first enable
+    std::string tracePath = "/tmp/face-tracker-trace.json";
+    
+    // Frame watchdog: with no frame for this long the fixtures go to the failsafe position
+    int watchdogTimeoutMs = 1000;          // 0 = off
+    int failsafePan = -1;                  // DMX value (0-255); -1 = home (mapped centre)
+    int failsafeTilt = -1;
+    
+    // Synthetic camera (captureBackend "synthetic"): a drawn face on a scripted path, with ground truth
+    std::string syntheticMotion = "lissajous"; // "lissajous", "circle", "sweep", "steps" or "still"
+    int syntheticPeriodMs = 4000;          // One cycle of the motion
+    float syntheticAmplitude = 0.6f;       // Fraction of the pan/tilt range (0-1)
+    std::string syntheticFaceImage = "";   // Face sprite (PNG alpha is honoured); empty = built-in drawing
+    int syntheticFaceSize = 160;           // Face width in pixels
+    float syntheticNoise = 0.0f;           // Pixel noise standard deviation
+    float syntheticBlur = 0.0f;            // Gaussian blur sigma in pixels
+    float syntheticLighting = 1.0f;        // Brightness gain
+    float syntheticLightDrift = 0.0f;      // Brightness swing over one period (0-1)
+    bool syntheticRealtime = true;         // Pace at the capture FPS (false = as fast as tracking runs)
+    int syntheticSeed = 1;                 // Noise seed (same seed, same frames)
+    int syntheticFrames = 0;               // Exit after this many frames (0 = run until stopped)
+    std::string syntheticTruthPath = "";   // Per-frame CSV of ground truth vs tracked pose
+    
+    // Pose log (binary record of every pose update, replayed with --replay)
+    std::string poseLogPath = "";          // Empty = not recording
+    
+    // Frame recorder (camera frames plus a per-frame metadata sidecar, for debugging)
+    std::string recordPath = "";           // Output directory; empty = not recording
+    std::string recordFormat = "png";      // "png" (lossless image sequence) or "video" (MJPG AVI)
+    int recordQueueFrames = 32;            // Frames waiting for the encoder before new ones are dropped
+    
+    // OSC control input (UDP /tracker/<setting> messages, applied within one frame)
+    bool oscControlEnabled = false;
+    int oscControlPort = 9001;
+    std::string oscControlBind = "127.0.0.1"; // "0.0.0.0" to accept control surfaces on the network
+    
+    // Daemon mode (--daemon): keep the camera streaming while idle so start/resume is instant
+    bool daemonKeepCameraOpen = true;
+    
+    // Change-driven output
+    int outputHysteresis = 0;    // Min DMX step change before a channel is resent (0 = any change)
+    int keyframeInterval = 1000; // Full refresh of all channels every N ms (0 = never)
+};
+
+enum ConfigFieldType { CONFIG_INT, CONFIG_FLOAT, CONFIG_BOOL, CONFIG_STRING };
+
+// How a changed field takes effect while tracking
+enum ConfigApply {
+    APPLY_LIVE = 0,       // Picked up on the next frame
+    APPLY_CAMERA,         // Camera property, applied between frames
+    APPLY_CAMERA_REOPEN,  // Opens a different camera on a worker thread
+    APPLY_RESTART         // Saved, but only used at startup
+};
+
+// One persisted Config member
+struct ConfigField {
+    const char* name;
+    ConfigFieldType type;
+    ConfigApply apply;
+    int Config::* intMember;
+    float Config::* floatMember;
+    bool Config::* boolMember;
+    std::string Config::* stringMember;
+};
+
+const std::vector<ConfigField>& configFields();
+const ConfigField* findConfigField(const std::string& name);
+
+// Field access through the table
+bool readConfigField(const ConfigField& field, const nlohmann::json& value, Config& config);
+void writeConfigField(const ConfigField& field, const Config& config, nlohmann::json& j);
+bool configFieldEquals(const ConfigField& field, const Config& a, const Config& b);
+void copyConfigField(const ConfigField& field, const Config& from, Config& to);
+std::string configFieldToString(const ConfigField& field, const Config& config);
+
+// Overlay every field present in j onto config (missing fields keep their value)
+void applyConfigJson(const nlohmann::json& j, Config& config);
+// Fields whose value differs between current and next
+std::vector<const ConfigField*> diffConfig(const Config& current, const Config& next);
+
+Config loadConfig(const std::string& configPath = DEFAULT_CONFIG_PATH);
+void saveConfig(const Config& config, const std::string& configPath = DEFAULT_CONFIG_PATH);
+
+// Watches the config file from a background thread (inotify on Linux, mtime
+// polling elsewhere) and parses it there; the tracking thread only picks up
+// the parsed JSON between frames and diffs it against the running Config.
+class ConfigWatcher {
+public:
+    ConfigWatcher() = default;
+    ~ConfigWatcher();
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    bool start(const std::string& configPath = DEFAULT_CONFIG_PATH);
+    void stop();
+
+    // Parsed file contents if the file changed since the last call (cheap when nothing changed)
+    bool takeUpdate(nlohmann::json& j);
+
+private:
+    void run();
+    void readFile();
+
+    std::string path_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> hasUpdate_{false};
+    std::mutex mutex_;
+    nlohmann::json pending_;
+    std::string lastContent_; // Skip rewrites that didn't change anything
+};
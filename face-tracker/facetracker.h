@@ -0,0 +1,86 @@
+/* C API of the facetracker_core library: face tracking in the caller's process
+ *
+ * A plain C interface over TrackerCore (tracker_core.h) so other runtimes can
+ * embed the tracker without IPC; the Node addon in node/ is built on it.
+ *
+ * Threading: ft_start() tracks on a worker thread and calls `callback` on that
+ * thread once per camera frame, and with a non-tracking status when the camera
+ * stalls or tracking fails (see ft_pose::status). The ft_pose (and its strings)
+ * is only valid during the call, so copy what you need. ft_stop() joins the
+ * worker: no callback runs once it returns. After FT_STATUS_FAILED the worker
+ * has ended; call ft_stop() before starting again. Every other function may
+ * be called from any thread, but not concurrently on the same tracker.
+ *
+ * Errors: functions return 0 on success and -1 on failure, with the reason in
+ * ft_last_error() (per tracker, valid until the next call on it).
+ */
+#ifndef FACETRACKER_H
+#define FACETRACKER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped when a struct layout or a function signature changes */
+#define FT_API_VERSION 2
+
+typedef struct ft_tracker ft_tracker;
+
+/* ft_pose::status */
+#define FT_STATUS_TRACKING 0  /* A camera frame was tracked */
+#define FT_STATUS_STALLED  1  /* No frame for watchdogTimeoutMs; repeated every second while it lasts */
+#define FT_STATUS_FAILED   2  /* Tracking stopped on an error (ft_pose::error) */
+
+typedef struct ft_pose {
+    uint64_t frame;
+    int64_t timestamp_us;   /* Capture time (monotonic clock, microseconds) */
+    int face;               /* 1 when a face was found this frame; else the pose is the last one */
+    int landmarks;          /* 1 when the pose came from facial landmarks */
+    float raw_pan;          /* -1..1 */
+    float raw_tilt;
+    float smoothed_pan;
+    float smoothed_tilt;
+    int pan_dmx;            /* 0..255 after dead zone, range and rigging */
+    int tilt_dmx;
+    const char* gesture;    /* Newly detected gesture ("NODDING", ...) or "" */
+    int status;             /* FT_STATUS_*; when not tracking, pan_dmx/tilt_dmx are the failsafe position */
+    const char* error;      /* FT_STATUS_FAILED reason, else "" */
+} ft_pose;
+
+typedef void (*ft_pose_callback)(const ft_pose* pose, void* user_data);
+
+/* FT_API_VERSION of the library actually loaded */
+int ft_api_version(void);
+
+/* `config_json`: face-tracker-config.json fields (missing ones keep their
+ * defaults), or NULL. Returns NULL if the JSON is invalid. */
+ft_tracker* ft_create(const char* config_json);
+
+/* Open the configured camera and track on a worker thread. Loads the
+ * detection models first (can take seconds on the first call). */
+int ft_start(ft_tracker* tracker, ft_pose_callback callback, void* user_data);
+int ft_stop(ft_tracker* tracker);
+
+/* Merge config fields (same format as ft_create) into the running config.
+ * Smoothing, mapping and image fields apply from the next frame; camera
+ * fields on the next ft_start(). */
+int ft_update_config(ft_tracker* tracker, const char* config_json);
+
+/* Track one 8-bit BGR image supplied by the caller, on the caller's thread
+ * (not while started). `stride` is bytes per row (0 = width * 3). The
+ * gesture string stays valid until the next call on this tracker. */
+int ft_process_frame(ft_tracker* tracker, const uint8_t* bgr, int width, int height, int stride,
+                     int64_t timestamp_us, ft_pose* pose);
+
+const char* ft_last_error(const ft_tracker* tracker);
+
+/* Stops the tracker if it is running */
+void ft_destroy(ft_tracker* tracker);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FACETRACKER_H */
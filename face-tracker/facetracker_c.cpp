@@ -0,0 +1,160 @@
+#include "facetracker.h"
+#include "tracker_core.h"
+
+#include <nlohmann/json.hpp>
+
+#include <exception>
+#include <mutex>
+#include <string>
+
+struct ft_tracker {
+    TrackerCore core;
+    Config config;
+    std::mutex configMutex;  // config: ft_update_config() may race a restart
+    std::string error;
+    TrackedPose lastPose;    // ft_process_frame() result (owns the gesture string)
+};
+
+namespace {
+
+bool parseConfig(const char* json, Config& config, std::string& error) {
+    if (!json || !*json) {
+        return true;
+    }
+    try {
+        applyConfigJson(nlohmann::json::parse(json), config);
+        return true;
+    } catch (const std::exception& e) {
+        error = std::string("invalid config JSON: ") + e.what();
+        return false;
+    }
+}
+
+void toCPose(const TrackedPose& in, ft_pose& out) {
+    out.frame = in.frame;
+    out.timestamp_us = in.timestampUs;
+    out.face = in.face ? 1 : 0;
+    out.landmarks = in.landmarks ? 1 : 0;
+    out.raw_pan = in.pan;
+    out.raw_tilt = in.tilt;
+    out.smoothed_pan = in.smoothedPan;
+    out.smoothed_tilt = in.smoothedTilt;
+    out.pan_dmx = in.panDmx;
+    out.tilt_dmx = in.tiltDmx;
+    out.gesture = in.gesture.c_str();
+    out.status = in.status == TRACKER_FAILED ? FT_STATUS_FAILED
+               : in.status == TRACKER_STALLED ? FT_STATUS_STALLED : FT_STATUS_TRACKING;
+    out.error = in.error.c_str();
+}
+
+// Exceptions must not cross the C boundary
+template <typename F>
+int guarded(ft_tracker* tracker, F&& body) {
+    if (!tracker) {
+        return -1;
+    }
+    try {
+        return body() ? 0 : -1;
+    } catch (const std::exception& e) {
+        tracker->error = e.what();
+    } catch (...) {
+        tracker->error = "unknown error";
+    }
+    return -1;
+}
+
+} // namespace
+
+extern "C" {
+
+int ft_api_version(void) {
+    return FT_API_VERSION;
+}
+
+ft_tracker* ft_create(const char* config_json) {
+    try {
+        ft_tracker* tracker = new ft_tracker();
+        if (!parseConfig(config_json, tracker->config, tracker->error)) {
+            delete tracker;
+            return nullptr;
+        }
+        tracker->core.updateConfig(tracker->config);
+        return tracker;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+int ft_start(ft_tracker* tracker, ft_pose_callback callback, void* user_data) {
+    return guarded(tracker, [&] {
+        if (!callback) {
+            tracker->error = "no pose callback";
+            return false;
+        }
+        Config config;
+        {
+            std::lock_guard<std::mutex> lock(tracker->configMutex);
+            config = tracker->config;
+        }
+        return tracker->core.start(config, [callback, user_data](const TrackedPose& pose) {
+            ft_pose out;
+            toCPose(pose, out);
+            callback(&out, user_data);
+        }, tracker->error);
+    });
+}
+
+int ft_stop(ft_tracker* tracker) {
+    return guarded(tracker, [&] {
+        tracker->core.stop();
+        return true;
+    });
+}
+
+int ft_update_config(ft_tracker* tracker, const char* config_json) {
+    return guarded(tracker, [&] {
+        std::lock_guard<std::mutex> lock(tracker->configMutex);
+        Config next = tracker->config;
+        if (!parseConfig(config_json, next, tracker->error)) {
+            return false;
+        }
+        tracker->config = next;
+        tracker->core.updateConfig(next);
+        return true;
+    });
+}
+
+int ft_process_frame(ft_tracker* tracker, const uint8_t* bgr, int width, int height, int stride,
+                     int64_t timestamp_us, ft_pose* pose) {
+    return guarded(tracker, [&] {
+        if (!bgr || !pose || width <= 0 || height <= 0 || (stride != 0 && stride < width * 3)) {
+            tracker->error = "invalid frame";
+            return false;
+        }
+        // Wraps the caller's pixels; TrackerCore only reads them
+        cv::Mat image(height, width, CV_8UC3, const_cast<uint8_t*>(bgr),
+                      stride > 0 ? static_cast<size_t>(stride) : static_cast<size_t>(cv::Mat::AUTO_STEP));
+        if (!tracker->core.processFrame(image, timestamp_us, tracker->lastPose, tracker->error)) {
+            return false;
+        }
+        toCPose(tracker->lastPose, *pose);
+        return true;
+    });
+}
+
+const char* ft_last_error(const ft_tracker* tracker) {
+    return tracker ? tracker->error.c_str() : "no tracker";
+}
+
+void ft_destroy(ft_tracker* tracker) {
+    if (!tracker) {
+        return;
+    }
+    try {
+        tracker->core.stop();
+    } catch (...) {
+    }
+    delete tracker;
+}
+
+} // extern "C"
@@ -0,0 +1,209 @@
+#include "frame_recorder.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+bool FrameRecorder::open(const std::string& directory, const std::string& format, int queueFrames) {
+    close();
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    std::string sidecarPath = (std::filesystem::path(directory) / "frames.jsonl").string();
+    sidecar_ = std::fopen(sidecarPath.c_str(), "w");
+    if (!sidecar_) {
+        std::cerr << "Error: Could not create " << sidecarPath << std::endl;
+        return false;
+    }
+
+    directory_ = directory;
+    video_ = format == "video";
+    queueFrames_ = static_cast<size_t>(std::max(1, queueFrames));
+    videoSegment_ = 0;
+    videoSize_ = cv::Size();
+    warnedWrite_ = false;
+    droppedSinceQueued_ = 0;
+    recorded_ = 0;
+    dropped_ = 0;
+    stopping_ = false;
+    running_ = true;
+    thread_ = std::thread(&FrameRecorder::run, this);
+    std::cout << "Recording camera frames to " << directory << " (" << (video_ ? "video" : "png")
+              << ", up to " << queueFrames_ << " frames queued)" << std::endl;
+    return true;
+}
+
+void FrameRecorder::close() {
+    if (!running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobReady_.notify_one();
+    thread_.join(); // Drains the queue first
+    running_ = false;
+    writer_.release();
+    std::fclose(sidecar_);
+    sidecar_ = nullptr;
+    spare_.clear();
+    bgr_.release();
+    std::cout << "Frame recorder " << directory_ << ": " << recorded_ << " frames";
+    if (dropped_ > 0) {
+        std::cout << " (" << dropped_ << " dropped)";
+    }
+    std::cout << std::endl;
+}
+
+bool FrameRecorder::submit(const cv::Mat& image, CaptureFormat format, const FrameRecordInfo& info) {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (jobs_.size() >= queueFrames_) {
+            droppedSinceQueued_++;
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (!spare_.empty()) {
+            job = std::move(spare_.back());
+            spare_.pop_back();
+        }
+    }
+
+    // The copy happens outside the lock; recycled buffers of the same size are reused
+    job.info = info; // Vector assignment keeps the recycled capacity
+    job.format = format;
+    image.copyTo(job.image);
+    job.droppedBefore = droppedSinceQueued_;
+    droppedSinceQueued_ = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobReady_.notify_one();
+    return true;
+}
+
+void FrameRecorder::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobReady_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return; // Stopping, and everything queued is written
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        std::string file;
+        if (writeFrame(job, file)) {
+            recorded_.fetch_add(1, std::memory_order_relaxed);
+        } else if (!warnedWrite_) {
+            std::cerr << "Warning: Frame recorder could not write to " << directory_ << std::endl;
+            warnedWrite_ = true;
+        }
+        writeSidecar(job, file);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        spare_.push_back(std::move(job));
+    }
+}
+
+// Encoder thread: write one frame; `file` names where it went (empty on failure)
+bool FrameRecorder::writeFrame(Job& job, std::string& file) {
+    std::filesystem::path dir(directory_);
+    char name[64];
+
+    if (!video_ && job.format == CAPTURE_MJPEG) {
+        // The camera's own JPEG, bit for bit: exactly what the decoder saw
+        std::snprintf(name, sizeof(name), "%06llu.jpg", static_cast<unsigned long long>(job.info.frame));
+        FILE* out = std::fopen((dir / name).string().c_str(), "wb");
+        if (!out) {
+            return false;
+        }
+        size_t bytes = job.image.total() * job.image.elemSize();
+        bool ok = std::fwrite(job.image.ptr<uchar>(), 1, bytes, out) == bytes;
+        ok = std::fclose(out) == 0 && ok;
+        if (ok) {
+            file = name;
+        }
+        return ok;
+    }
+
+    const cv::Mat* bgr = &job.image;
+    if (job.format == CAPTURE_MJPEG) {
+        bgr_ = cv::imdecode(job.image, cv::IMREAD_COLOR);
+        bgr = &bgr_;
+    } else if (job.format != CAPTURE_BGR) {
+        cv::cvtColor(job.image, bgr_, job.format == CAPTURE_YUYV ? cv::COLOR_YUV2BGR_YUYV : cv::COLOR_YUV2BGR_NV12);
+        bgr = &bgr_;
+    }
+    if (bgr->empty()) {
+        return false;
+    }
+
+    if (!video_) {
+        // Fastest PNG compression: lossless either way, and the encoder keeps up
+        std::snprintf(name, sizeof(name), "%06llu.png", static_cast<unsigned long long>(job.info.frame));
+        if (!cv::imwrite((dir / name).string(), *bgr, {cv::IMWRITE_PNG_COMPRESSION, 1})) {
+            return false;
+        }
+        file = name;
+        return true;
+    }
+
+    // A container holds one frame size: start a new segment when the camera changes
+    if (!writer_.isOpened() || bgr->size() != videoSize_) {
+        writer_.release();
+        videoSegment_++;
+        if (videoSegment_ == 1) {
+            std::snprintf(name, sizeof(name), "frames.avi");
+        } else {
+            std::snprintf(name, sizeof(name), "frames-%d.avi", videoSegment_);
+        }
+        videoFile_ = name;
+        videoSize_ = bgr->size();
+        double fps = job.info.fps > 0.0 ? job.info.fps : 30.0;
+        if (!writer_.open((dir / name).string(), cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, videoSize_)) {
+            return false;
+        }
+    }
+    writer_.write(*bgr);
+    file = videoFile_;
+    return true;
+}
+
+// Encoder thread: one JSON line per frame, written whether or not the image made it
+void FrameRecorder::writeSidecar(const Job& job, const std::string& file) {
+    const FrameRecordInfo& info = job.info;
+    std::fprintf(sidecar_, "{\"frame\": %llu, \"timestampUs\": %lld, \"file\": \"%s\"",
+                 static_cast<unsigned long long>(info.frame), static_cast<long long>(info.timestampUs),
+                 file.c_str());
+    if (job.droppedBefore > 0) {
+        std::fprintf(sidecar_, ", \"dropped\": %llu", static_cast<unsigned long long>(job.droppedBefore));
+    }
+    std::fprintf(sidecar_, ", \"faces\": [");
+    for (size_t i = 0; i < info.faces.size(); i++) {
+        const cv::Rect& r = info.faces[i];
+        std::fprintf(sidecar_, "%s[%d, %d, %d, %d]", i ? ", " : "", r.x, r.y, r.width, r.height);
+    }
+    std::fprintf(sidecar_, "], \"landmarks\": [");
+    for (size_t i = 0; i < info.landmarks.size(); i++) {
+        std::fprintf(sidecar_, "%s[%.1f, %.1f]", i ? ", " : "", info.landmarks[i].x, info.landmarks[i].y);
+    }
+    std::fprintf(sidecar_, "], \"face\": %s, \"pan\": %.4f, \"tilt\": %.4f, \"smoothedPan\": %.4f, "
+                 "\"smoothedTilt\": %.4f, \"panDmx\": %d, \"tiltDmx\": %d}\n",
+                 info.face ? "true" : "false", info.pan, info.tilt, info.smoothedPan, info.smoothedTilt,
+                 info.panDmx, info.tiltDmx);
+    std::fflush(sidecar_); // A crash keeps every frame written so far
+}
@@ -0,0 +1,108 @@
+// Raw camera session recorder (recordPath): the exact frames the tracker saw,
+// with what it made of each one
+//
+// The tracking thread only copies the camera frame into a recycled buffer and
+// queues it; an encoder thread converts and writes it, so a slow disk never
+// slows tracking. The queue holds at most recordQueueFrames frames: when it
+// is full the frame is dropped and counted, not waited for.
+//
+// Written into the recordPath directory:
+//
+//   frames.jsonl   one JSON object per recorded frame: frame number, capture
+//                  timestamp, face rectangles, landmarks, raw/smoothed pose
+//                  and DMX values, plus "dropped" when frames were skipped
+//   000123.png     recordFormat "png": one lossless image per frame (MJPEG
+//                  cameras keep the original JPEG bytes as 000123.jpg)
+//   frames.avi     recordFormat "video": Motion JPEG AVI (frames-2.avi etc.
+//                  after the camera changes resolution)
+//
+// Raw YUYV/NV12 frames are converted to BGR on the encoder thread.
+#pragma once
+
+#include "camera_frame.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Per-frame sidecar data; coordinates are in recorded-frame pixels
+struct FrameRecordInfo {
+    uint64_t frame = 0;
+    int64_t timestampUs = 0;              // Capture time (CameraFrame::timestampUs)
+    double fps = 0.0;                     // Camera rate for the video container (0 = 30)
+    std::vector<cv::Rect> faces;
+    std::vector<cv::Point2f> landmarks;   // Empty unless the pose came from landmarks
+    bool face = false;                    // The pose below was updated this frame
+    float pan = 0.0f;                     // Raw pose, -1..1
+    float tilt = 0.0f;
+    float smoothedPan = 0.0f;
+    float smoothedTilt = 0.0f;
+    int panDmx = 0;                       // DMX values for the smoothed pose
+    int tiltDmx = 0;
+};
+
+class FrameRecorder {
+public:
+    FrameRecorder() = default;
+    ~FrameRecorder();
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    // Create `directory` and start the encoder thread. format is "png" or "video".
+    bool open(const std::string& directory, const std::string& format, int queueFrames);
+    // Writes everything still queued, then stops
+    void close();
+    bool isOpen() const { return running_; }
+
+    // Tracking thread: copy `image` (BGR, raw YUYV/NV12 layout, or a row of
+    // MJPEG bytes, as given by `format`) and queue it. False when the queue
+    // is full and the frame was dropped.
+    bool submit(const cv::Mat& image, CaptureFormat format, const FrameRecordInfo& info);
+
+    uint64_t recordedCount() const { return recorded_.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        FrameRecordInfo info;
+        CaptureFormat format = CAPTURE_BGR;
+        cv::Mat image;
+        uint64_t droppedBefore = 0;       // Frames dropped since the previous queued one
+    };
+
+    void run();
+    bool writeFrame(Job& job, std::string& file);
+    void writeSidecar(const Job& job, const std::string& file);
+
+    std::string directory_;
+    bool video_ = false;
+    size_t queueFrames_ = 0;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable jobReady_;
+    std::deque<Job> jobs_;
+    std::vector<Job> spare_;              // Recycled jobs (buffers keep their capacity)
+    bool stopping_ = false;
+    uint64_t droppedSinceQueued_ = 0;     // Tracking thread only
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> recorded_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    // Encoder thread only
+    FILE* sidecar_ = nullptr;
+    cv::VideoWriter writer_;
+    cv::Size videoSize_;
+    std::string videoFile_;
+    int videoSegment_ = 0;
+    cv::Mat bgr_;
+    bool warnedWrite_ = false;
+};
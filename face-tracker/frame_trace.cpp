@@ -0,0 +1,254 @@
+#include "frame_trace.h"
+
+#include "async_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct TraceRecord {
+    const char* name = nullptr; // nullptr = slot never written
+    int64_t startUs = 0;
+    int64_t durationUs = 0;
+    uint64_t frame = 0;
+    uint32_t thread = 0;
+    bool isFrame = false;       // Whole-frame span; the fields below are set
+    bool landmarks = false;
+    int faces = 0;
+    const char* output = "";
+    const char* capture = "";
+};
+
+// Seqlocked like the shared memory ring (shm_ring.cpp): odd while being written
+struct TraceSlot {
+    std::atomic<uint32_t> seq{0};
+    TraceRecord record;
+};
+
+static std::unique_ptr<TraceSlot[]> traceSlots; // Allocated once, never freed before exit
+static std::atomic<TraceSlot*> traceRing{nullptr};
+static size_t traceRingSize = 0;
+static std::atomic<uint64_t> traceNextSlot{0};
+static std::atomic<bool> traceRecording{false};
+
+static std::mutex traceMutex; // Setup, thread names and the dump thread
+static std::vector<std::pair<uint32_t, std::string>> traceThreadNames;
+static std::thread traceDumpThread;
+static std::atomic<bool> traceDumping{false};
+static std::atomic<uint32_t> traceNextThreadId{1};
+static volatile std::sig_atomic_t traceSignalled = 0;
+
+int64_t traceNowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+// Small stable per-thread id (trace viewers group spans by it)
+static uint32_t traceThreadId() {
+    thread_local uint32_t id = traceNextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void setTraceEnabled(bool enabled, size_t capacity) {
+    if (enabled && !traceRing.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        if (!traceRing.load(std::memory_order_relaxed)) {
+            traceRingSize = std::max<size_t>(capacity, 256);
+            traceSlots.reset(new TraceSlot[traceRingSize]);
+            traceRing.store(traceSlots.get(), std::memory_order_release);
+        }
+    }
+    traceRecording.store(enabled, std::memory_order_relaxed);
+}
+
+bool traceEnabled() {
+    return traceRecording.load(std::memory_order_relaxed);
+}
+
+void traceThreadName(const char* name) {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceThreadNames.emplace_back(traceThreadId(), name);
+}
+
+static void recordSpan(const TraceRecord& record) {
+    TraceSlot* ring = traceRing.load(std::memory_order_acquire);
+    if (!ring || !traceRecording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    TraceSlot& slot = ring[traceNextSlot.fetch_add(1, std::memory_order_relaxed) % traceRingSize];
+    // Several threads record, so the slot is claimed rather than just marked; if the
+    // ring lapped onto a slot another thread is still writing, this span is dropped
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) || !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = record;
+    slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+void traceSpan(const char* name, uint64_t frame, int64_t startUs, int64_t endUs) {
+    TraceRecord record;
+    record.name = name;
+    record.startUs = startUs;
+    record.durationUs = endUs - startUs;
+    record.frame = frame;
+    record.thread = traceThreadId();
+    recordSpan(record);
+}
+
+void traceFrame(uint64_t frame, int64_t startUs, int64_t endUs, const TraceFrameInfo& info) {
+    TraceRecord record;
+    record.name = "frame";
+    record.startUs = startUs;
+    record.durationUs = endUs - startUs;
+    record.frame = frame;
+    record.thread = traceThreadId();
+    record.isFrame = true;
+    record.faces = info.faces;
+    record.landmarks = info.landmarks;
+    record.output = info.output;
+    record.capture = info.capture;
+    recordSpan(record);
+}
+
+// Consistent copy of every written slot, oldest first
+static std::vector<TraceRecord> snapshotSpans() {
+    std::vector<TraceRecord> spans;
+    TraceSlot* ring = traceRing.load(std::memory_order_acquire);
+    if (!ring) {
+        return spans;
+    }
+    spans.reserve(traceRingSize);
+    for (size_t i = 0; i < traceRingSize; i++) {
+        TraceSlot& slot = ring[i];
+        for (int attempt = 0; attempt < 3; attempt++) {
+            uint32_t before = slot.seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue; // Being written right now
+            }
+            TraceRecord record = slot.record;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == before) {
+                if (record.name) {
+                    spans.push_back(record);
+                }
+                break;
+            }
+        }
+    }
+    std::sort(spans.begin(), spans.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.startUs < b.startUs;
+    });
+    return spans;
+}
+
+static void writeTrace(std::string path) {
+    std::vector<TraceRecord> spans = snapshotSpans();
+    std::vector<std::pair<uint32_t, std::string>> threadNames;
+    {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        threadNames = traceThreadNames;
+    }
+
+    // Frame metadata goes on every span of that frame
+    std::unordered_map<uint64_t, const TraceRecord*> frames;
+    for (const TraceRecord& span : spans) {
+        if (span.isFrame) {
+            frames[span.frame] = &span;
+        }
+    }
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "w");
+    if (!file) {
+        logMessage(LOG_ERROR, LOG_GENERAL, "Could not write trace to %s", tempPath.c_str());
+        traceDumping.store(false);
+        return;
+    }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    for (const auto& thread : threadNames) {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", thread.first, thread.second.c_str());
+        first = false;
+    }
+    for (const TraceRecord& span : spans) {
+        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"tracker\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                           "\"ts\":%lld,\"dur\":%lld,\"args\":{\"frame\":%llu",
+                     first ? "" : ",\n", span.name, span.thread, static_cast<long long>(span.startUs),
+                     static_cast<long long>(std::max<int64_t>(span.durationUs, 0)),
+                     static_cast<unsigned long long>(span.frame));
+        auto frame = frames.find(span.frame);
+        if (frame != frames.end()) {
+            const TraceRecord& info = *frame->second;
+            std::fprintf(file, ",\"faces\":%d,\"landmarks\":%s,\"output\":\"%s\",\"capture\":\"%s\"",
+                         info.faces, info.landmarks ? "true" : "false", info.output, info.capture);
+        }
+        std::fputs("}}", file);
+        first = false;
+    }
+    std::fputs("\n]}\n", file);
+    bool ok = std::fclose(file) == 0 && std::rename(tempPath.c_str(), path.c_str()) == 0;
+
+    if (ok) {
+        logMessage(LOG_INFO, LOG_GENERAL, "Trace written to %s (%zu spans, %zu frames)",
+                   path.c_str(), spans.size(), frames.size());
+    } else {
+        logMessage(LOG_ERROR, LOG_GENERAL, "Could not write trace to %s", path.c_str());
+    }
+    traceDumping.store(false);
+}
+
+bool requestTraceDump(const std::string& path) {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (traceDumping.load()) {
+        return false;
+    }
+    if (traceDumpThread.joinable()) {
+        traceDumpThread.join(); // Previous dump, already finished
+    }
+    traceDumping.store(true);
+    traceDumpThread = std::thread(writeTrace, path);
+    return true;
+}
+
+void finishTraceDump() {
+    std::thread dump;
+    {
+        // Join outside the lock: the dump takes it to copy the thread names
+        std::lock_guard<std::mutex> lock(traceMutex);
+        dump = std::move(traceDumpThread);
+    }
+    if (dump.joinable()) {
+        dump.join();
+    }
+}
+
+#ifdef SIGUSR1
+static void onTraceSignal(int) {
+    traceSignalled = 1;
+}
+
+void installTraceSignal() {
+    std::signal(SIGUSR1, onTraceSignal);
+}
+#else
+void installTraceSignal() {}
+#endif
+
+bool takeTraceSignal() {
+    if (!traceSignalled) {
+        return false;
+    }
+    traceSignalled = 0;
+    return true;
+}
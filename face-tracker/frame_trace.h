@@ -0,0 +1,53 @@
+// Per-frame span tracing in Chrome trace / Perfetto JSON (traceEnabled)
+//
+// Histograms (metrics_server.h) show that frames are slow, not which frame
+// stalled or where. With tracing on, each pipeline stage of each frame is
+// recorded as a span (start, duration, thread, frame number) into a ring
+// allocated once when tracing is first enabled; the newest traceSpans spans
+// are kept and older ones overwritten. Recording is a clock read and a
+// seqlock-guarded slot write, safe from any thread (the preview render
+// thread records its own spans).
+//
+// A dump writes the ring to tracePath as Chrome trace JSON on a background
+// thread, so the tracking loop never waits for the file. It is triggered
+// by SIGUSR1 (Linux/macOS) or the daemon "trace" command. Load the file in
+// chrome://tracing or https://ui.perfetto.dev. Every span's args carry the
+// frame number plus that frame's face count, landmark result, output mode
+// and capture format (taken from the frame's "frame" span).
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+const size_t TRACE_DEFAULT_SPANS = 16384;
+
+// Filled in for the whole-frame span
+struct TraceFrameInfo {
+    int faces = 0;
+    bool landmarks = false;
+    const char* output = "";   // String literals only (stored by pointer)
+    const char* capture = "";
+};
+
+// Steady clock in microseconds (same base as the span timestamps)
+int64_t traceNowUs();
+
+// The first enable allocates `capacity` spans; later calls only toggle recording
+void setTraceEnabled(bool enabled, size_t capacity = TRACE_DEFAULT_SPANS);
+bool traceEnabled();
+
+// Name shown for the calling thread in the trace viewer
+void traceThreadName(const char* name);
+
+// `name` must be a string literal (stored by pointer)
+void traceSpan(const char* name, uint64_t frame, int64_t startUs, int64_t endUs);
+void traceFrame(uint64_t frame, int64_t startUs, int64_t endUs, const TraceFrameInfo& info);
+
+// Start writing the ring to `path` on a background thread; false if a dump is still running
+bool requestTraceDump(const std::string& path);
+// SIGUSR1 sets a flag (no work in the handler); the tracking loop polls it
+void installTraceSignal();
+bool takeTraceSignal();
+// Wait for a dump in progress (shutdown)
+void finishTraceDump();
@@ -0,0 +1,89 @@
+#include "frame_watchdog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+// While stalled, the failsafe is repeated this often (receivers may have missed it)
+static const int64_t WATCHDOG_REPEAT_US = 1000000;
+
+static int64_t watchdogNowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+FrameWatchdog::~FrameWatchdog() {
+    stop();
+}
+
+void FrameWatchdog::start(int timeoutMs, StallHandler onStall) {
+    if (isRunning()) {
+        return;
+    }
+    onStall_ = std::move(onStall);
+    timeoutMs_ = std::max(0, timeoutMs);
+    lastBeatUs_ = watchdogNowUs();
+    stallSinceUs_ = 0;
+    stopping_ = false;
+    thread_ = std::thread(&FrameWatchdog::run, this);
+}
+
+void FrameWatchdog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void FrameWatchdog::setTimeout(int timeoutMs) {
+    // Re-arm from now so enabling it does not report time spent disabled as a stall
+    lastBeatUs_ = watchdogNowUs();
+    timeoutMs_ = std::max(0, timeoutMs);
+}
+
+int64_t FrameWatchdog::heartbeat() {
+    int64_t now = watchdogNowUs();
+    lastBeatUs_.store(now, std::memory_order_relaxed);
+    if (stallSinceUs_.load(std::memory_order_relaxed) == 0) {
+        return 0; // The usual case: one relaxed store and one load
+    }
+    int64_t since = stallSinceUs_.exchange(0);
+    return since > 0 ? (now - since) / 1000 : 0;
+}
+
+void FrameWatchdog::run() {
+    int64_t nextRepeatUs = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        int timeoutMs = timeoutMs_.load();
+        // Check a few times per timeout so a stall is caught close to the deadline
+        int checkMs = timeoutMs > 0 ? std::max(5, std::min(50, timeoutMs / 4)) : 100;
+        wake_.wait_for(lock, std::chrono::milliseconds(checkMs), [this] { return stopping_; });
+        if (stopping_ || timeoutMs <= 0) {
+            continue;
+        }
+
+        int64_t now = watchdogNowUs();
+        int64_t lastBeat = lastBeatUs_.load();
+        if (now - lastBeat < static_cast<int64_t>(timeoutMs) * 1000) {
+            continue;
+        }
+        int64_t expected = 0;
+        bool newStall = stallSinceUs_.compare_exchange_strong(expected, lastBeat);
+        if (!newStall && now < nextRepeatUs) {
+            continue;
+        }
+        nextRepeatUs = now + WATCHDOG_REPEAT_US;
+
+        // The handler sends output (possibly blocking on the network); don't hold the lock
+        lock.unlock();
+        if (onStall_) {
+            onStall_((now - lastBeat) / 1000);
+        }
+        lock.lock();
+    }
+}
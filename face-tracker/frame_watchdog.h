@@ -0,0 +1,52 @@
+// Frame-time watchdog (watchdogTimeoutMs)
+//
+// The tracking thread calls heartbeat() once per processed frame. If no
+// heartbeat arrives within the timeout (a grab that never returns, a wedged
+// detector or output call, a dead camera) a separate thread calls the stall
+// handler, which sends the fixtures to their failsafe position, and calls it
+// again every second for as long as the stall lasts. A moving head pointed
+// over the audience must never simply freeze where it was.
+//
+// The next heartbeat after a stall returns how long the stall lasted, so
+// the tracking thread can report it and force a full output refresh.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class FrameWatchdog {
+public:
+    // Runs on the watchdog thread; stalledMs is the time since the last heartbeat
+    using StallHandler = std::function<void(int64_t stalledMs)>;
+
+    FrameWatchdog() = default;
+    ~FrameWatchdog();
+    FrameWatchdog(const FrameWatchdog&) = delete;
+    FrameWatchdog& operator=(const FrameWatchdog&) = delete;
+
+    // timeoutMs 0 keeps the thread idle until setTimeout() enables it
+    void start(int timeoutMs, StallHandler onStall);
+    void stop();
+    bool isRunning() const { return thread_.joinable(); }
+    void setTimeout(int timeoutMs);
+
+    // Tracking thread: the pipeline made progress. Returns the length of the
+    // stall in ms if one was declared since the previous heartbeat, else 0.
+    int64_t heartbeat();
+
+private:
+    void run();
+
+    std::atomic<int> timeoutMs_{0};
+    std::atomic<int64_t> lastBeatUs_{0};
+    std::atomic<int64_t> stallSinceUs_{0}; // Last heartbeat before a declared stall (0 = none)
+    StallHandler onStall_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
@@ -0,0 +1,147 @@
+#include "jpeg_decode_pool.h"
+
+#include <opencv2/imgcodecs.hpp>
+
+#include <algorithm>
+
+// IMREAD flag producing gray at 1/scale size, decoded in the DCT domain
+static int reducedGrayFlag(int scale) {
+    switch (scale) {
+        case 2: return cv::IMREAD_REDUCED_GRAYSCALE_2;
+        case 4: return cv::IMREAD_REDUCED_GRAYSCALE_4;
+        case 8: return cv::IMREAD_REDUCED_GRAYSCALE_8;
+        default: return cv::IMREAD_GRAYSCALE;
+    }
+}
+
+JpegDecodePool::~JpegDecodePool() {
+    stop();
+}
+
+void JpegDecodePool::start(int threads) {
+    if (isRunning()) {
+        return;
+    }
+    threads = std::max(1, std::min(JPEG_DECODE_MAX_THREADS, threads));
+    stopping_ = false;
+    for (int i = 0; i < threads; i++) {
+        workers_.emplace_back(&JpegDecodePool::run, this);
+    }
+}
+
+void JpegDecodePool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobReady_.notify_all();
+    frameDone_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    frames_.clear();
+    nextJob_ = 0;
+}
+
+void JpegDecodePool::submit(const cv::Mat& jpeg, int64_t timestampUs, int scale, bool wantFull) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frames_.emplace_back();
+        DecodedJpegFrame& frame = frames_.back();
+        frame.sequence = nextSequence_++;
+        frame.generation = generation_;
+        frame.timestampUs = timestampUs;
+        frame.scale = scale == 2 || scale == 4 || scale == 8 ? scale : 1;
+        frame.wantFull = wantFull;
+        if (!spare_.empty()) {
+            frame.jpeg.swap(spare_.back());
+            spare_.pop_back();
+        }
+        const uchar* bytes = jpeg.ptr<uchar>();
+        frame.jpeg.assign(bytes, bytes + jpeg.total() * jpeg.elemSize());
+    }
+    jobReady_.notify_one();
+}
+
+bool JpegDecodePool::next(DecodedJpegFrame& frame) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (frames_.empty()) {
+            return false;
+        }
+        if (!frames_.front().done) {
+            if (frames_.size() < workers_.size()) {
+                return false; // A worker is still free: keep capturing
+            }
+            frameDone_.wait(lock, [this] { return stopping_ || frames_.front().done; });
+            if (stopping_) {
+                return false;
+            }
+        }
+        if (frames_.front().generation == generation_) {
+            break;
+        }
+        // Was in flight during clear(): stale, drop it
+        spare_.push_back(std::move(frames_.front().jpeg));
+        frames_.pop_front();
+        nextJob_ = nextJob_ > 0 ? nextJob_ - 1 : 0;
+    }
+
+    // Hand the caller's previous byte buffer back for reuse
+    if (frame.jpeg.capacity() > 0) {
+        spare_.push_back(std::move(frame.jpeg));
+    }
+    frame = std::move(frames_.front());
+    frames_.pop_front();
+    nextJob_ = nextJob_ > 0 ? nextJob_ - 1 : 0;
+    return true;
+}
+
+void JpegDecodePool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+    // Frames a worker is decoding stay until it finishes (it writes into them);
+    // next() drops them by their old generation
+    while (nextJob_ < frames_.size()) {
+        spare_.push_back(std::move(frames_.back().jpeg));
+        frames_.pop_back();
+    }
+}
+
+int JpegDecodePool::pendingCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(frames_.size());
+}
+
+cv::Mat JpegDecodePool::decodeFull(const DecodedJpegFrame& frame) {
+    return cv::imdecode(frame.jpeg, cv::IMREAD_COLOR);
+}
+
+void JpegDecodePool::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        jobReady_.wait(lock, [this] { return stopping_ || nextJob_ < frames_.size(); });
+        if (stopping_) {
+            return;
+        }
+        // Take the oldest undecoded frame. std::deque keeps references valid
+        // while only the ends change, and a taken frame is never popped
+        // before it is done (next() waits, clear() skips it)
+        DecodedJpegFrame& frame = frames_[nextJob_++];
+        lock.unlock();
+
+        frame.gray = cv::imdecode(frame.jpeg, reducedGrayFlag(frame.scale));
+        if (frame.wantFull && !frame.gray.empty()) {
+            frame.full = cv::imdecode(frame.jpeg, cv::IMREAD_COLOR);
+        }
+        frame.ok = !frame.gray.empty();
+        if (!frame.ok) {
+            failed_++;
+        }
+
+        lock.lock();
+        frame.done = true;
+        frameDone_.notify_all();
+    }
+}
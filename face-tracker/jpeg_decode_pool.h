@@ -0,0 +1,86 @@
+// MJPEG frame decoding on worker threads (captureFormat "mjpeg")
+//
+// USB 2 webcams only reach 60 fps at 720p with MJPEG, and decoding every
+// full-size JPEG on the tracking thread then caps the frame rate. Here the
+// tracking thread only copies the compressed bytes into submit(); workers
+// decode them while it processes earlier frames:
+//
+//   - detection gets a 1/2, 1/4 or 1/8 size gray image straight from the
+//     JPEG decoder (IMREAD_REDUCED_GRAYSCALE_*: libjpeg scales in the DCT
+//     domain, skipping most of the inverse transform and all color work)
+//   - the full-size color image is only decoded when submit() says a
+//     preview or landmarks will want it; decodeFull() covers a miss
+//
+// Frames come back from next() in capture order. At most one frame per
+// worker is in flight, so the added latency is bounded by the pool size.
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int JPEG_DECODE_MAX_THREADS = 8;
+
+struct DecodedJpegFrame {
+    uint64_t sequence = 0;
+    uint64_t generation = 0;    // clear() count when submitted
+    int64_t timestampUs = 0;    // Capture time (CameraFrame::timestampUs)
+    int scale = 1;              // `gray` is 1/scale of the full frame
+    cv::Mat gray;               // Reduced-size luma for detection
+    cv::Mat full;               // Full-size BGR, if it was requested
+    std::vector<uchar> jpeg;    // Compressed frame, for decodeFull()
+    bool ok = false;            // Decoded without error
+    bool done = false;
+    bool wantFull = false;
+};
+
+class JpegDecodePool {
+public:
+    JpegDecodePool() = default;
+    ~JpegDecodePool();
+    JpegDecodePool(const JpegDecodePool&) = delete;
+    JpegDecodePool& operator=(const JpegDecodePool&) = delete;
+
+    void start(int threads);
+    void stop();
+    bool isRunning() const { return !workers_.empty(); }
+    int threadCount() const { return static_cast<int>(workers_.size()); }
+
+    // Queue a compressed frame (bytes are copied; the capture buffer is reused).
+    // scale is 1, 2, 4 or 8; wantFull also decodes the full-size color image.
+    void submit(const cv::Mat& jpeg, int64_t timestampUs, int scale, bool wantFull);
+    // Oldest frame in capture order. Waits only while every worker is busy,
+    // otherwise returns false when that frame is not decoded yet.
+    bool next(DecodedJpegFrame& frame);
+    // Drop frames in flight (e.g. when tracking pauses). Frames a worker is
+    // still decoding finish, but next() discards them instead of returning them.
+    void clear();
+
+    // Full-size BGR for a frame whose full image was not requested
+    static cv::Mat decodeFull(const DecodedJpegFrame& frame);
+
+    uint64_t failedCount() const { return failed_; }
+    // Frames submitted and not yet returned by next()
+    int pendingCount();
+
+private:
+    void run();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable jobReady_;
+    std::condition_variable frameDone_;
+    std::deque<DecodedJpegFrame> frames_;  // In flight, capture order
+    size_t nextJob_ = 0;                   // Index in frames_ of the first frame no worker has taken
+    uint64_t nextSequence_ = 0;
+    uint64_t generation_ = 0;              // Bumped by clear()
+    std::vector<std::vector<uchar>> spare_; // Recycled byte buffers
+    bool stopping_ = false;
+    std::atomic<uint64_t> failed_{0};
+};
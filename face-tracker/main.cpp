@@ -23,6 +23,8 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <future>
+#include <memory>
 #include <curl/curl.h>
 
 // Platform-specific includes
@@ -42,71 +44,77 @@
 
 #include <nlohmann/json.hpp>
 
+#include "config.h"
+#include "binary_stream.h"
+#include "shm_ring.h"
+#include "mjpeg_server.h"
+#include "osc_control.h"
+#include "model_cache.h"
+#include "command_server.h"
+#include "preview_windows.h"
+#include "preprocess.h"
+#include "camera_frame.h"
+#include "v4l2_capture.h"
+#include "synthetic_capture.h"
+#include "pose_output.h"
+#include "tracker_core.h"
+#include "pose_log.h"
+#include "frame_recorder.h"
+#include "jpeg_decode_pool.h"
+#include "async_log.h"
+#include "metrics_server.h"
+#include "frame_trace.h"
+#include "frame_watchdog.h"
+
 using namespace cv;
 #ifdef HAVE_OPENCV_FACE
 using namespace cv::face;
 #endif
 using json = nlohmann::json;
 
-// Configuration structure
-struct Config {
-    std::string dmxApiUrl = "http://localhost:3030/api/dmx/batch";
-    int panChannel = 1;  // DMX channel for pan (default)
-    int tiltChannel = 2; // DMX channel for tilt (default)
-    int irisChannel = 0; // DMX channel for iris (0 = disabled)
-    int zoomChannel = 0; // DMX channel for zoom (0 = disabled)
-    int focusChannel = 0; // DMX channel for focus (0 = disabled)
-    int cameraIndex = 0;
-    int updateRate = 20; // Updates per second (reduced for smoother movement)
-    float panSensitivity = 1.0f;
-    float tiltSensitivity = 1.0f;
-    int panOffset = 128;  // Center position for pan (0-255)
-    int tiltOffset = 128; // Center position for tilt (0-255)
-    int irisValue = 128;  // Default iris value (0-255)
-    int zoomValue = 128;  // Default zoom value (0-255)
-    int focusValue = 128; // Default focus value (0-255)
-    bool showPreview = true;
-    bool show3DVisualization = true; // Show 3D fixture visualization
-    float smoothingFactor = 0.85f; // Smoothing for movement (0.0-1.0, higher = smoother)
-    float maxVelocity = 5.0f; // Maximum change per update (prevents overshooting)
-    // Camera brightness/contrast controls
-    float brightness = 1.0f;    // Brightness multiplier (0.0-3.0, default 1.0)
-    float contrast = 1.0f;      // Contrast multiplier (0.0-3.0, default 1.0)
-    int cameraExposure = -1;    // Camera exposure (-1 = auto, or specific value)
-    int cameraBrightness = -1;  // Camera brightness (-1 = auto, or specific value)
-    bool autoExposure = true;   // Enable auto exposure
-    
-    // OSC Configuration
-    bool useOSC = false;              // Use OSC instead of HTTP API
-    std::string oscHost = "127.0.0.1"; // OSC target host
-    int oscPort = 9000;               // OSC target port
-    std::string oscPanPath = "/dmx/pan";    // OSC path for pan
-    std::string oscTiltPath = "/dmx/tilt";  // OSC path for tilt
-    std::string oscIrisPath = "/dmx/iris";  // OSC path for iris
-    std::string oscZoomPath = "/dmx/zoom";  // OSC path for zoom
-    std::string oscFocusPath = "/dmx/focus"; // OSC path for focus
-    
-    // Range cutoff values (min/max for each channel)
-    int panMin = 0;      // Minimum DMX value for pan
-    int panMax = 255;    // Maximum DMX value for pan
-    int tiltMin = 0;     // Minimum DMX value for tilt
-    int tiltMax = 255;   // Maximum DMX value for tilt
-    int irisMin = 0;     // Minimum DMX value for iris
-    int irisMax = 255;   // Maximum DMX value for iris
-    int zoomMin = 0;     // Minimum DMX value for zoom
-    int zoomMax = 255;   // Maximum DMX value for zoom
-    int focusMin = 0;    // Minimum DMX value for focus
-    int focusMax = 255;  // Maximum DMX value for focus
-    
-    // Rigging parameters (mechanical calibration)
-    float panScale = 1.0f;    // Scale factor for pan movement
-    float tiltScale = 1.0f;   // Scale factor for tilt movement
-    float panDeadZone = 0.0f; // Dead zone threshold for pan (ignore small movements)
-    float tiltDeadZone = 0.0f; // Dead zone threshold for tilt
-    float panLimit = 1.0f;    // Maximum range multiplier for pan (0.0-1.0)
-    float tiltLimit = 1.0f;   // Maximum range multiplier for tilt (0.0-1.0)
-    float panGear = 1.0f;     // Gear ratio for pan (higher = slower movement)
-    float tiltGear = 1.0f;    // Gear ratio for tilt (higher = slower movement)
+
+// Output slots transmitted by sendDmxValues()
+enum OutputSlot { SLOT_PAN = 0, SLOT_TILT, SLOT_IRIS, SLOT_ZOOM, SLOT_FOCUS, SLOT_COUNT };
+
+// Transport used by sendDmxValues()
+enum OutputTransport { TRANSPORT_HTTP = 0, TRANSPORT_OSC, TRANSPORT_STREAM };
+
+// Last transmitted value per output slot (used to suppress unchanged sends)
+struct OutputState {
+    int lastChannel[SLOT_COUNT] = {0, 0, 0, 0, 0};
+    int lastValue[SLOT_COUNT] = {-1, -1, -1, -1, -1}; // -1 = never sent
+    OutputTransport lastTransport = TRANSPORT_HTTP;
+    bool keyframeSent = false; // First send is always a keyframe
+    std::chrono::steady_clock::time_point lastKeyframe;
+    // Counters are per channel value, not per request
+    uint64_t sentCount = 0;
+    uint64_t suppressedCount = 0;
+    uint64_t keyframeCount = 0;
+    uint64_t failedCount = 0;  // Sends that failed, per request/message
+    uint64_t httpErrors = 0;
+    uint64_t oscErrors = 0;
+    BinaryStream stream; // Used when config.useStream is set
+};
+
+// Theatre preview layout (camera image framed by curtains, header and stage floor)
+const int THEATRE_CURTAIN_WIDTH = 80; // Width of each curtain
+const int THEATRE_HEADER_HEIGHT = 60; // Height of theatrical header
+const int THEATRE_STAGE_HEIGHT = 40;  // Height of stage floor
+
+// Static theatre decoration, rendered once per camera frame size
+struct TheatreBackdrop {
+    Size frameSize;     // Camera frame size the layers were built for
+    Mat background;     // Curtains, header, titles and stage floor (stage area left black)
+    Mat spotlights;     // Spotlight arcs drawn over the camera image
+    Mat spotlightMask;  // Non-zero where `spotlights` covers the stage area
+};
+
+// Output used by the watchdog thread while tracking is stalled. The tracking
+// thread only refreshes `config`; `output` is the failsafe's own change tracking.
+struct FailsafeOutput {
+    std::mutex mutex;
+    Config config;      // Guarded by mutex
+    OutputState output; // Watchdog thread only
 };
 
 // Global state
@@ -119,12 +127,7 @@ struct FaceTrackerState {
 #endif
     std::vector<Point2f> landmarks;
     Point2f headCenter;
-    float currentPan = 0.0f;
-    float currentTilt = 0.0f;
-    float smoothedPan = 0.0f;
-    float smoothedTilt = 0.0f;
-    float panVelocity = 0.0f; // Velocity for smoother movement
-    float tiltVelocity = 0.0f; // Velocity for smoother movement
+    PoseFilter pose; // Raw and smoothed pose, gesture history
     bool faceDetected = false;
     // 3D visualization viewport
     float viewAngleX = 0.0f; // View rotation X (up/down)
@@ -137,21 +140,43 @@ struct FaceTrackerState {
     bool showXYZLattice = false; // Show XYZ coordinate axes
     int viewAngleXSlider = 0; // Slider value for viewAngleX (0-360, maps to -90 to +90)
     int viewAngleYSlider = 315; // Slider value for viewAngleY (0-360, maps to -180 to +180, default -45° = 315)
-    // Gesture/intent detection
-    std::vector<float> panHistory; // History of pan values for gesture detection
-    std::vector<float> tiltHistory; // History of tilt values for gesture detection
-    const size_t gestureHistorySize = 30; // Frames to track (about 1 second at 30fps)
-    std::string lastGesture = ""; // Last detected gesture
-    int gestureCooldown = 0; // Cooldown to prevent duplicate detections
     // Configuration is always visible in separate window
     Config config;
+    Config fileConfig;           // Last config read from disk (restart-only fields live here until restart)
+    ConfigWatcher configWatcher; // Live reload of face-tracker-config.json
+    bool cameraSettingsDirty = false; // Exposure/brightness changed; applied after the next frame's outputs
+    std::future<std::unique_ptr<VideoCapture>> cameraReopen; // Camera being opened for a new cameraIndex
+    int cameraReopenIndex = -1;
+    std::chrono::steady_clock::time_point cameraRetryTime; // Next reopen attempt after a failure
+    OutputState output; // Change tracking for DMX/OSC output
+    CaptureLatencyStats captureLatency; // Camera capture to pose, reported with the output stats
+    ShmRingWriter sharedMemory; // Used when config.useSharedMemory is set
+    Mat sharedPreview;          // Reused preview buffer for the shared memory ring
+    MjpegServer mjpeg;          // Used when config.mjpegEnabled is set
+    TrackerMetrics metrics;     // Updated by the tracking thread; served when config.metricsEnabled is set
+    uint64_t frameNumber = 0;   // Frame being tracked (metrics/trace spans)
+    MetricsServer metricsServer;
+    FrameWatchdog watchdog;     // Drives the fixtures to the failsafe position when frames stop
+    FailsafeOutput failsafe;
+    std::chrono::steady_clock::time_point failsafeSyncTime; // Last refresh of failsafe.config
+    SyntheticTruthLog syntheticTruth; // Used when syntheticTruthPath is set with the synthetic camera
+    PoseLogWriter poseLog;      // Used when config.poseLogPath is set
+    FrameRecorder recorder;     // Used when config.recordPath is set
+    PreviewWindows preview;     // OpenCV windows (own render thread) when config.previewWindows is set
+    std::chrono::steady_clock::time_point startTime; // Launch or last start command, for time-to-first-frame
+    const char* startEvent = "launch";
+    bool awaitingFirstFrame = true;
+    CommandServer commands;     // Used in daemon mode (--daemon)
+    DaemonMode mode = DAEMON_TRACKING;
+    OscControlServer control;   // Used when config.oscControlEnabled is set
     VideoCapture* cap;  // Pointer to camera for trackbar callbacks
     int brightnessSlider = 50;   // Trackbar position (0-100, represents 0.0-3.0)
     int contrastSlider = 33;     // Trackbar position (0-100, represents 0.0-3.0)
     int exposureSlider = 50;     // Trackbar position (0-100, represents exposure)
     int autoExposureSlider = 0;  // Trackbar position (0=OFF/Manual, 1=ON/Auto)
     int colorModeSlider = 1;     // Trackbar position (0=Grayscale, 1=Color)
-    Mat lastDisplayFrame;        // Store last display frame for mouse callback
+    Size theatreSize;            // Last composed theatre size (for the mouse callback)
+    TheatreBackdrop theatreBackdrop; // Cached theatre decoration
     // Config window sliders (for interactive editing)
     int panChannelSlider = 1;
     int tiltChannelSlider = 2;
@@ -199,109 +224,6 @@ static size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *use
     return size * nmemb;
 }
 
-// Forward declarations
-void saveConfig(const Config& config, const std::string& configPath);
-
-// Detect gestures from head movement history
-std::string detectGesture(std::vector<float>& panHistory, std::vector<float>& tiltHistory, float currentPan, float currentTilt) {
-    // Need at least 10 frames of history
-    if (panHistory.size() < 10 || tiltHistory.size() < 10) {
-        return "";
-    }
-    
-    // Calculate movement patterns
-    // For nodding: look for vertical (tilt) oscillation
-    // For shaking: look for horizontal (pan) oscillation
-    
-    // Analyze recent tilt changes for nodding
-    float tiltRange = 0.0f;
-    int tiltDirectionChanges = 0;
-    float lastTiltDir = 0.0f;
-    
-    for (size_t i = 1; i < tiltHistory.size(); i++) {
-        float tiltChange = tiltHistory[i] - tiltHistory[i-1];
-        float currentDir = (tiltChange > 0.05f) ? 1.0f : ((tiltChange < -0.05f) ? -1.0f : 0.0f);
-        
-        if (currentDir != 0 && currentDir != lastTiltDir && lastTiltDir != 0) {
-            tiltDirectionChanges++;
-        }
-        if (currentDir != 0) lastTiltDir = currentDir;
-        
-        tiltRange = std::max(tiltRange, std::abs(tiltChange));
-    }
-    
-    // Analyze recent pan changes for head shaking
-    float panRange = 0.0f;
-    int panDirectionChanges = 0;
-    float lastPanDir = 0.0f;
-    
-    for (size_t i = 1; i < panHistory.size(); i++) {
-        float panChange = panHistory[i] - panHistory[i-1];
-        float currentDir = (panChange > 0.05f) ? 1.0f : ((panChange < -0.05f) ? -1.0f : 0.0f);
-        
-        if (currentDir != 0 && currentDir != lastPanDir && lastPanDir != 0) {
-            panDirectionChanges++;
-        }
-        if (currentDir != 0) lastPanDir = currentDir;
-        
-        panRange = std::max(panRange, std::abs(panChange));
-    }
-    
-    // Detect nodding (vertical oscillation with direction changes)
-    if (tiltDirectionChanges >= 2 && tiltRange > 0.1f) {
-        return "NODDING";
-    }
-    
-    // Detect head shaking (horizontal oscillation with direction changes)
-    if (panDirectionChanges >= 2 && panRange > 0.1f) {
-        return "SHAKING";
-    }
-    
-    // Detect looking up (sustained upward tilt)
-    if (tiltHistory.size() >= 10) {
-        float avgRecentTilt = 0.0f;
-        for (size_t i = tiltHistory.size() - 10; i < tiltHistory.size(); i++) {
-            avgRecentTilt += tiltHistory[i];
-        }
-        avgRecentTilt /= 10.0f;
-        if (avgRecentTilt < -0.3f) { // Looking up
-            return "LOOKING_UP";
-        }
-        if (avgRecentTilt > 0.3f) { // Looking down
-            return "LOOKING_DOWN";
-        }
-    }
-    
-    // Detect looking left/right (sustained pan)
-    if (panHistory.size() >= 10) {
-        float avgRecentPan = 0.0f;
-        for (size_t i = panHistory.size() - 10; i < panHistory.size(); i++) {
-            avgRecentPan += panHistory[i];
-        }
-        avgRecentPan /= 10.0f;
-        if (avgRecentPan < -0.3f) { // Looking left
-            return "LOOKING_LEFT";
-        }
-        if (avgRecentPan > 0.3f) { // Looking right
-            return "LOOKING_RIGHT";
-        }
-    }
-    
-    return "";
-}
-
-// Helper function to pad OSC string to 4-byte boundary
-void padOSCString(std::vector<uint8_t>& buffer, const std::string& str) {
-    for (char c : str) {
-        buffer.push_back(static_cast<uint8_t>(c));
-    }
-    buffer.push_back(0); // Null terminator
-    // Pad to 4-byte boundary
-    while (buffer.size() % 4 != 0) {
-        buffer.push_back(0);
-    }
-}
-
 // Send OSC message via UDP
 bool sendOSCMessage(const std::string& host, int port, const std::string& path, float value) {
     int sock = socket(AF_INET, SOCK_DGRAM, 0);
@@ -325,34 +247,8 @@ bool sendOSCMessage(const std::string& host, int port, const std::string& path,
         return false;
     }
     
-    // Build OSC message: path + type tag + float value
     std::vector<uint8_t> message;
-    
-    // OSC address pattern (path)
-    padOSCString(message, path);
-    
-    // OSC type tag string (",f" for float)
-    padOSCString(message, ",f");
-    
-    // Float value (big-endian 32-bit float)
-    union {
-        float f;
-        uint8_t bytes[4];
-    } floatUnion;
-    floatUnion.f = value;
-    
-    // OSC uses big-endian byte order
-    #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-        message.push_back(floatUnion.bytes[3]);
-        message.push_back(floatUnion.bytes[2]);
-        message.push_back(floatUnion.bytes[1]);
-        message.push_back(floatUnion.bytes[0]);
-    #else
-        message.push_back(floatUnion.bytes[0]);
-        message.push_back(floatUnion.bytes[1]);
-        message.push_back(floatUnion.bytes[2]);
-        message.push_back(floatUnion.bytes[3]);
-    #endif
+    encodeOSCFloat(message, path, value);
     
     // Send message
 #ifdef _WIN32
@@ -378,62 +274,96 @@ bool sendOSCMessage(const std::string& host, int port, const std::string& path,
 }
 
 // Send DMX values via HTTP API or OSC (based on config)
-bool sendDmxValues(const Config& config, int panValue, int tiltValue) {
-    if (config.useOSC) {
-        // Send via OSC
-        bool panOK = sendOSCMessage(config.oscHost, config.oscPort, config.oscPanPath, 
-                                     static_cast<float>(panValue) / 255.0f); // Normalize to 0.0-1.0
-        bool tiltOK = sendOSCMessage(config.oscHost, config.oscPort, config.oscTiltPath, 
-                                      static_cast<float>(tiltValue) / 255.0f); // Normalize to 0.0-1.0
+// Only channels whose value moved by more than outputHysteresis are transmitted;
+// every keyframeInterval ms all channels are resent so receivers can recover from loss
+bool sendDmxValues(const Config& config, OutputState& output, int panValue, int tiltValue) {
+    const int channels[SLOT_COUNT] = {config.panChannel, config.tiltChannel, config.irisChannel,
+                                      config.zoomChannel, config.focusChannel};
+    const int values[SLOT_COUNT] = {panValue, tiltValue, config.irisValue, config.zoomValue, config.focusValue};
+    
+    // Decide whether this send is a full refresh
+    OutputTransport transport = config.useStream ? TRANSPORT_STREAM : (config.useOSC ? TRANSPORT_OSC : TRANSPORT_HTTP);
+    auto now = std::chrono::steady_clock::now();
+    bool keyframe = !output.keyframeSent || transport != output.lastTransport;
+    if (!keyframe && config.keyframeInterval > 0) {
+        auto sinceKeyframe = std::chrono::duration_cast<std::chrono::milliseconds>(now - output.lastKeyframe).count();
+        keyframe = sinceKeyframe >= config.keyframeInterval;
+    }
+    
+    // Select channels to transmit
+    bool transmit[SLOT_COUNT] = {false, false, false, false, false};
+    int transmitCount = 0;
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        // OSC always sends pan/tilt (paths, not channels); optional channels need a channel number
+        bool enabled = (transport == TRANSPORT_OSC && (i == SLOT_PAN || i == SLOT_TILT)) || channels[i] > 0;
+        if (!enabled) continue;
         
-        // Send optional channels if configured
-        if (config.irisChannel > 0) {
-            sendOSCMessage(config.oscHost, config.oscPort, config.oscIrisPath, 
-                          static_cast<float>(config.irisValue) / 255.0f);
+        bool changed = output.lastValue[i] < 0 ||
+                       channels[i] != output.lastChannel[i] ||
+                       std::abs(values[i] - output.lastValue[i]) > config.outputHysteresis;
+        if (keyframe || changed) {
+            transmit[i] = true;
+            transmitCount++;
+        } else {
+            output.suppressedCount++;
         }
-        if (config.zoomChannel > 0) {
-            sendOSCMessage(config.oscHost, config.oscPort, config.oscZoomPath, 
-                          static_cast<float>(config.zoomValue) / 255.0f);
+    }
+    
+    // Nothing moved - skip the request entirely
+    if (transmitCount == 0) {
+        return true;
+    }
+    
+    // Record a successfully transmitted slot
+    auto markSent = [&](int i) {
+        output.lastChannel[i] = channels[i];
+        output.lastValue[i] = values[i];
+        output.sentCount++;
+    };
+    
+    bool allOK = true;
+    
+    if (transport == TRANSPORT_STREAM) {
+        // Send via binary stream (Node applies the values directly, no HTTP round trip)
+        StreamDmxValue dmx[SLOT_COUNT];
+        size_t count = 0;
+        for (int i = 0; i < SLOT_COUNT; i++) {
+            if (transmit[i]) {
+                dmx[count++] = {static_cast<uint16_t>(channels[i] - 1), static_cast<uint8_t>(values[i])};
+            }
         }
-        if (config.focusChannel > 0) {
-            sendOSCMessage(config.oscHost, config.oscPort, config.oscFocusPath, 
-                          static_cast<float>(config.focusValue) / 255.0f);
+        if (output.stream.sendDmx(dmx, count)) {
+            for (int i = 0; i < SLOT_COUNT; i++) {
+                if (transmit[i]) markSent(i);
+            }
+        } else {
+            output.failedCount++;
+            allOK = false;
+        }
+    } else if (transport == TRANSPORT_OSC) {
+        // Send via OSC
+        const std::string* paths[SLOT_COUNT] = {&config.oscPanPath, &config.oscTiltPath, &config.oscIrisPath,
+                                                &config.oscZoomPath, &config.oscFocusPath};
+        for (int i = 0; i < SLOT_COUNT; i++) {
+            if (!transmit[i]) continue;
+            if (sendOSCMessage(config.oscHost, config.oscPort, *paths[i], 
+                               static_cast<float>(values[i]) / 255.0f)) { // Normalize to 0.0-1.0
+                markSent(i);
+            } else {
+                output.failedCount++;
+                output.oscErrors++;
+                allOK = false;
+            }
         }
-        
-        return panOK && tiltOK;
     } else {
         // Send via HTTP API (original implementation)
-        // Build JSON payload with all configured channels
+        // Build JSON payload with the changed channels
         // Validate channels are > 0 before sending (channels are 1-indexed in config, 0-indexed in API)
-        json payload;
-        if (config.panChannel > 0) {
-            payload[std::to_string(config.panChannel - 1)] = panValue;  // DMX channels are 0-indexed in API
-        }
-        if (config.tiltChannel > 0) {
-            payload[std::to_string(config.tiltChannel - 1)] = tiltValue;
-        }
-        
-        // Add optional channels if configured (0 = disabled)
-        if (config.irisChannel > 0) {
-            payload[std::to_string(config.irisChannel - 1)] = config.irisValue;
-        }
-        if (config.zoomChannel > 0) {
-            payload[std::to_string(config.zoomChannel - 1)] = config.zoomValue;
-        }
-        if (config.focusChannel > 0) {
-            payload[std::to_string(config.focusChannel - 1)] = config.focusValue;
-        }
-        
-        // Don't send if no channels are configured
-        if (payload.empty()) {
-            return true;  // No channels to send, but not an error
-        }
-        
-        std::string jsonStr = payload.dump();
+        std::string jsonStr = buildDmxPayload(channels, values, transmit, SLOT_COUNT);
         
         // Ensure jsonStr is valid JSON (should never be "null" string)
         if (jsonStr.empty() || jsonStr == "null") {
-            std::cerr << "Invalid JSON payload generated" << std::endl;
+            logMessage(LOG_ERROR, LOG_OUTPUT, "Invalid JSON payload generated");
             return false;
         }
         
@@ -443,7 +373,9 @@ bool sendDmxValues(const Config& config, int panValue, int tiltValue) {
         
         curl = curl_easy_init();
         if (!curl) {
-            std::cerr << "Failed to initialize curl" << std::endl;
+            logMessage(LOG_ERROR, LOG_OUTPUT, "Failed to initialize curl");
+            output.failedCount++;
+            output.httpErrors++;
             return false;
         }
         
@@ -464,682 +396,242 @@ bool sendDmxValues(const Config& config, int panValue, int tiltValue) {
         curl_easy_cleanup(curl);
         
         if (res != CURLE_OK) {
-            std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
+            logMessage(LOG_ERROR, LOG_OUTPUT, "curl_easy_perform() failed: %s", curl_easy_strerror(res));
+            output.failedCount++;
+            output.httpErrors++;
             return false;
         }
         
-        return true;
+        for (int i = 0; i < SLOT_COUNT; i++) {
+            if (transmit[i]) markSent(i);
+        }
     }
+    
+    // A keyframe only counts once it has gone out; a failed one is retried next tick
+    if (keyframe && allOK) {
+        output.keyframeSent = true;
+        output.lastKeyframe = now;
+        output.lastTransport = transport;
+        output.keyframeCount++;
+    }
+    
+    return allOK;
 }
 
-// Load configuration from JSON file
-Config loadConfig(const std::string& configPath = "face-tracker-config.json") {
-    Config config;
-    std::ifstream file(configPath);
-    
-    if (!file.is_open()) {
-        std::cout << "Config file not found, using defaults. Creating " << configPath << std::endl;
-        // Save default config
-        saveConfig(config, configPath);
-        return config;
-    }
-    
-    json j;
-    file >> j;
-    
-    if (j.contains("dmxApiUrl")) config.dmxApiUrl = j["dmxApiUrl"];
-    if (j.contains("panChannel")) config.panChannel = j["panChannel"];
-    if (j.contains("tiltChannel")) config.tiltChannel = j["tiltChannel"];
-    if (j.contains("irisChannel")) config.irisChannel = j["irisChannel"];
-    if (j.contains("zoomChannel")) config.zoomChannel = j["zoomChannel"];
-    if (j.contains("focusChannel")) config.focusChannel = j["focusChannel"];
-    if (j.contains("cameraIndex")) config.cameraIndex = j["cameraIndex"];
-    if (j.contains("updateRate")) config.updateRate = j["updateRate"];
-    if (j.contains("panSensitivity")) config.panSensitivity = j["panSensitivity"];
-    if (j.contains("tiltSensitivity")) config.tiltSensitivity = j["tiltSensitivity"];
-    if (j.contains("panOffset")) config.panOffset = j["panOffset"];
-    if (j.contains("tiltOffset")) config.tiltOffset = j["tiltOffset"];
-    if (j.contains("irisValue")) config.irisValue = j["irisValue"];
-    if (j.contains("zoomValue")) config.zoomValue = j["zoomValue"];
-    if (j.contains("focusValue")) config.focusValue = j["focusValue"];
-    if (j.contains("showPreview")) config.showPreview = j["showPreview"];
-    if (j.contains("show3DVisualization")) config.show3DVisualization = j["show3DVisualization"];
-    if (j.contains("smoothingFactor")) config.smoothingFactor = j["smoothingFactor"];
-    if (j.contains("maxVelocity")) config.maxVelocity = j["maxVelocity"];
-    if (j.contains("brightness")) config.brightness = j["brightness"];
-    if (j.contains("contrast")) config.contrast = j["contrast"];
-    if (j.contains("cameraExposure")) config.cameraExposure = j["cameraExposure"];
-    if (j.contains("cameraBrightness")) config.cameraBrightness = j["cameraBrightness"];
-    if (j.contains("autoExposure")) config.autoExposure = j["autoExposure"];
-    
-    // OSC configuration
-    if (j.contains("useOSC")) config.useOSC = j["useOSC"];
-    if (j.contains("oscHost")) config.oscHost = j["oscHost"];
-    if (j.contains("oscPort")) config.oscPort = j["oscPort"];
-    if (j.contains("oscPanPath")) config.oscPanPath = j["oscPanPath"];
-    if (j.contains("oscTiltPath")) config.oscTiltPath = j["oscTiltPath"];
-    if (j.contains("oscIrisPath")) config.oscIrisPath = j["oscIrisPath"];
-    if (j.contains("oscZoomPath")) config.oscZoomPath = j["oscZoomPath"];
-    if (j.contains("oscFocusPath")) config.oscFocusPath = j["oscFocusPath"];
-    
-    // Range cutoffs
-    if (j.contains("panMin")) config.panMin = j["panMin"];
-    if (j.contains("panMax")) config.panMax = j["panMax"];
-    if (j.contains("tiltMin")) config.tiltMin = j["tiltMin"];
-    if (j.contains("tiltMax")) config.tiltMax = j["tiltMax"];
-    if (j.contains("irisMin")) config.irisMin = j["irisMin"];
-    if (j.contains("irisMax")) config.irisMax = j["irisMax"];
-    if (j.contains("zoomMin")) config.zoomMin = j["zoomMin"];
-    if (j.contains("zoomMax")) config.zoomMax = j["zoomMax"];
-    if (j.contains("focusMin")) config.focusMin = j["focusMin"];
-    if (j.contains("focusMax")) config.focusMax = j["focusMax"];
-    
-    // Rigging parameters
-    if (j.contains("panScale")) config.panScale = j["panScale"];
-    if (j.contains("tiltScale")) config.tiltScale = j["tiltScale"];
-    if (j.contains("panDeadZone")) config.panDeadZone = j["panDeadZone"];
-    if (j.contains("tiltDeadZone")) config.tiltDeadZone = j["tiltDeadZone"];
-    if (j.contains("panLimit")) config.panLimit = j["panLimit"];
-    if (j.contains("tiltLimit")) config.tiltLimit = j["tiltLimit"];
-    if (j.contains("panGear")) config.panGear = j["panGear"];
-    if (j.contains("tiltGear")) config.tiltGear = j["tiltGear"];
-    
-    return config;
-}
-
-// Save configuration to JSON file
-void saveConfig(const Config& config, const std::string& configPath = "face-tracker-config.json") {
-    json j;
-    j["dmxApiUrl"] = config.dmxApiUrl;
-    j["panChannel"] = config.panChannel;
-    j["tiltChannel"] = config.tiltChannel;
-    j["irisChannel"] = config.irisChannel;
-    j["zoomChannel"] = config.zoomChannel;
-    j["focusChannel"] = config.focusChannel;
-    j["cameraIndex"] = config.cameraIndex;
-    j["updateRate"] = config.updateRate;
-    j["panSensitivity"] = config.panSensitivity;
-    j["tiltSensitivity"] = config.tiltSensitivity;
-    j["panOffset"] = config.panOffset;
-    j["tiltOffset"] = config.tiltOffset;
-    j["irisValue"] = config.irisValue;
-    j["zoomValue"] = config.zoomValue;
-    j["focusValue"] = config.focusValue;
-    j["showPreview"] = config.showPreview;
-    j["show3DVisualization"] = config.show3DVisualization;
-    j["smoothingFactor"] = config.smoothingFactor;
-    j["maxVelocity"] = config.maxVelocity;
-    j["brightness"] = config.brightness;
-    j["contrast"] = config.contrast;
-    j["cameraExposure"] = config.cameraExposure;
-    j["cameraBrightness"] = config.cameraBrightness;
-    j["autoExposure"] = config.autoExposure;
-    
-    // OSC configuration
-    j["useOSC"] = config.useOSC;
-    j["oscHost"] = config.oscHost;
-    j["oscPort"] = config.oscPort;
-    j["oscPanPath"] = config.oscPanPath;
-    j["oscTiltPath"] = config.oscTiltPath;
-    j["oscIrisPath"] = config.oscIrisPath;
-    j["oscZoomPath"] = config.oscZoomPath;
-    j["oscFocusPath"] = config.oscFocusPath;
-    
-    // Range cutoffs
-    j["panMin"] = config.panMin;
-    j["panMax"] = config.panMax;
-    j["tiltMin"] = config.tiltMin;
-    j["tiltMax"] = config.tiltMax;
-    j["irisMin"] = config.irisMin;
-    j["irisMax"] = config.irisMax;
-    j["zoomMin"] = config.zoomMin;
-    j["zoomMax"] = config.zoomMax;
-    j["focusMin"] = config.focusMin;
-    j["focusMax"] = config.focusMax;
-    
-    // Rigging parameters
-    j["panScale"] = config.panScale;
-    j["tiltScale"] = config.tiltScale;
-    j["panDeadZone"] = config.panDeadZone;
-    j["tiltDeadZone"] = config.tiltDeadZone;
-    j["panLimit"] = config.panLimit;
-    j["tiltLimit"] = config.tiltLimit;
-    j["panGear"] = config.panGear;
-    j["tiltGear"] = config.tiltGear;
-    
-    std::ofstream file(configPath);
-    file << j.dump(2);
-}
-
-// Estimate head pose from facial landmarks
-void estimateHeadPose(const std::vector<Point2f>& landmarks, 
-                      const Size& imageSize,
-                      float& pan, float& tilt) {
-    if (landmarks.size() < 68) return; // Need full 68-point model
-    
-    // Key facial landmark indices (for 68-point model)
-    // Left eye corner
-    Point2f leftEye = landmarks[36];
-    // Right eye corner
-    Point2f rightEye = landmarks[45];
-    
-    // Calculate face center
-    Point2f faceCenter = (leftEye + rightEye) / 2.0f;
-    
-    // Calculate image center
-    Point2f imageCenter(imageSize.width / 2.0f, imageSize.height / 2.0f);
-    
-    // Pan (horizontal) - based on face center offset from image center
-    float panOffset = (faceCenter.x - imageCenter.x) / imageCenter.x;
-    pan = panOffset; // -1.0 to 1.0
-    
-    // Tilt (vertical) - based on face center offset from image center
-    float tiltOffset = (faceCenter.y - imageCenter.y) / imageCenter.y;
-    tilt = tiltOffset; // -1.0 to 1.0
-    
-    // Optional: Use nose direction for better pan estimation
-    // Calculate face angle from eye alignment
-    Point2f eyeVector = rightEye - leftEye;
-    float eyeAngle = atan2(eyeVector.y, eyeVector.x);
-    // Normalize to -1 to 1 range
-    pan = pan * 0.7f + (eyeAngle / CV_PI) * 0.3f;
-}
-
-// Improved smoothing with velocity limiting
-void smoothWithVelocity(float& current, float target, float& velocity, float smoothing, float maxVel) {
-    // Calculate desired change
-    float error = target - current;
-    
-    // Update velocity (with damping)
-    velocity = velocity * smoothing + error * (1.0f - smoothing);
-    
-    // Limit velocity to max
-    if (velocity > maxVel) velocity = maxVel;
-    if (velocity < -maxVel) velocity = -maxVel;
-    
-    // Apply velocity to current position
-    current += velocity;
-    
-    // Optional: apply additional smoothing directly
-    current = current * smoothing + target * (1.0f - smoothing);
-}
-
-// Map head movement to DMX values (0-255) with rigging parameters
-void mapToDmx(const float pan, const float tilt, const Config& config, int& panValue, int& tiltValue) {
-    // Apply dead zone (ignore small movements)
-    float adjustedPan = pan;
-    float adjustedTilt = tilt;
-    
-    if (std::abs(pan) < config.panDeadZone) {
-        adjustedPan = 0.0f;
-    } else {
-        // Remove dead zone from value
-        float sign = pan > 0 ? 1.0f : -1.0f;
-        adjustedPan = sign * (std::abs(pan) - config.panDeadZone) / (1.0f - config.panDeadZone);
+// Print output counters (how many channel values change-driven output saved)
+void printOutputStats(const OutputState& output) {
+    uint64_t total = output.sentCount + output.suppressedCount;
+    int savedPercent = total > 0 ? static_cast<int>(output.suppressedCount * 100 / total) : 0;
+    logMessage(LOG_INFO, LOG_STATS, "Output stats - Sent: %llu | Suppressed: %llu | Keyframes: %llu (%d%% saved)",
+               static_cast<unsigned long long>(output.sentCount),
+               static_cast<unsigned long long>(output.suppressedCount),
+               static_cast<unsigned long long>(output.keyframeCount), savedPercent);
+}
+
+// Capture-to-pose latency since the last report, plus frames the V4L2 driver dropped
+void printCaptureStats(CaptureLatencyStats& latency, const VideoCapture& cap) {
+    if (latency.frames == 0) {
+        return;
     }
-    
-    if (std::abs(tilt) < config.tiltDeadZone) {
-        adjustedTilt = 0.0f;
+    double avgMs = latency.totalUs / static_cast<int64_t>(latency.frames) / 1000.0;
+    double maxMs = latency.maxUs / 1000.0;
+    if (const V4l2Capture* v4l2 = dynamic_cast<const V4l2Capture*>(&cap)) {
+        logMessage(LOG_INFO, LOG_STATS, "Capture latency - Avg: %g ms | Max: %g ms | Dropped frames: %llu",
+                   avgMs, maxMs, static_cast<unsigned long long>(v4l2->droppedFrames()));
     } else {
-        float sign = tilt > 0 ? 1.0f : -1.0f;
-        adjustedTilt = sign * (std::abs(tilt) - config.tiltDeadZone) / (1.0f - config.tiltDeadZone);
-    }
-    
-    // Apply rigging: scale, sensitivity, gear ratio, and limit
-    float panMovement = adjustedPan * config.panSensitivity * config.panScale / config.panGear * config.panLimit;
-    float tiltMovement = adjustedTilt * config.tiltSensitivity * config.tiltScale / config.tiltGear * config.tiltLimit;
-    
-    // Convert from -1.0 to 1.0 range to 0-255, with offset
-    panValue = static_cast<int>(config.panOffset + (panMovement * 127.0f));
-    tiltValue = static_cast<int>(config.tiltOffset + (tiltMovement * 127.0f));
-    
-    // Clamp to configured min/max ranges (not just 0-255)
-    panValue = std::max(config.panMin, std::min(config.panMax, panValue));
-    tiltValue = std::max(config.tiltMin, std::min(config.tiltMax, tiltValue));
-}
-
-// Helper: 3D point to 2D projection with viewport rotation
-Point project3D(float x, float y, float z, float viewAngleX, float viewAngleY, float viewDist, 
-                int centerX, int centerY, int scale) {
-    // Rotate around Y axis (pan rotation)
-    float cosY = std::cos(viewAngleY * CV_PI / 180.0f);
-    float sinY = std::sin(viewAngleY * CV_PI / 180.0f);
-    float x1 = x * cosY - z * sinY;
-    float z1 = x * sinY + z * cosY;
-    
-    // Rotate around X axis (tilt rotation)
-    float cosX = std::cos(viewAngleX * CV_PI / 180.0f);
-    float sinX = std::sin(viewAngleX * CV_PI / 180.0f);
-    float y1 = y * cosX - z1 * sinX;
-    float z2 = y * sinX + z1 * cosX;
-    
-    // Perspective projection
-    float perspective = 1.0f / (viewDist + z2 * 0.001f);
-    int px = centerX + static_cast<int>(x1 * scale * perspective);
-    int py = centerY - static_cast<int>(y1 * scale * perspective); // Flip Y for screen coordinates
-    
-    return Point(px, py);
-}
-
-// Draw XYZ coordinate axes/lattice
-void drawXYZAxes(Mat& canvas, float viewAngleX, float viewAngleY, float viewDist, int centerX, int centerY, int scale) {
-    // Draw coordinate axes (RGB = XYZ)
-    // X axis (red) - horizontal
-    Point xStart = project3D(0, 0, 0, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-    Point xEnd = project3D(0.3f, 0, 0, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-    line(canvas, xStart, xEnd, Scalar(0, 0, 255), 2); // Red (BGR)
-    putText(canvas, "X", xEnd, FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 0, 255), 1);
-    
-    // Y axis (green) - vertical
-    Point yStart = project3D(0, 0, 0, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-    Point yEnd = project3D(0, 0.3f, 0, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-    line(canvas, yStart, yEnd, Scalar(0, 255, 0), 2); // Green (BGR)
-    putText(canvas, "Y", yEnd, FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 255, 0), 1);
-    
-    // Z axis (blue) - depth
-    Point zStart = project3D(0, 0, 0, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-    Point zEnd = project3D(0, 0, 0.3f, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-    line(canvas, zStart, zEnd, Scalar(255, 0, 0), 2); // Blue (BGR)
-    putText(canvas, "Z", zEnd, FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 0, 0), 1);
-    
-    // Draw grid lines on XY plane (at Z=0)
-    int gridSize = 5;
-    float gridSpacing = 0.1f;
-    Scalar gridColor(100, 100, 100);
-    
-    for (int i = -gridSize; i <= gridSize; i++) {
-        // Lines parallel to X axis
-        Point g1 = project3D(-gridSize * gridSpacing, 0, i * gridSpacing, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-        Point g2 = project3D(gridSize * gridSpacing, 0, i * gridSpacing, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-        line(canvas, g1, g2, gridColor, 1);
-        
-        // Lines parallel to Z axis
-        Point g3 = project3D(i * gridSpacing, 0, -gridSize * gridSpacing, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-        Point g4 = project3D(i * gridSpacing, 0, gridSize * gridSpacing, viewAngleX, viewAngleY, viewDist, centerX, centerY, scale);
-        line(canvas, g3, g4, gridColor, 1);
-    }
-}
-
-// Render configuration window with all settings and visualization
-// Render rigging visualization preview only (configuration UI is now in React)
-void renderRiggingPreview(Mat& canvas, FaceTrackerState& state, float currentPan, float currentTilt) {
-    int width = canvas.cols;
-    int height = canvas.rows;
-    
-    // Clear with dark background
-    canvas = Scalar(30, 30, 40);
-    
-    int x = 20;
-    int lineHeight = 22;
-    Scalar textColor(255, 255, 255);
-    Scalar headerColor(150, 200, 255);
-    Scalar valueColor(200, 255, 200);
-    
-    int y = 20;
-    
-    // Title
-    putText(canvas, "Face Movement -> DMX Mapping Preview", Point(x, y),
-           FONT_HERSHEY_DUPLEX, 0.7, headerColor, 2);
-    y += lineHeight * 2;
-    
-    putText(canvas, "(Configure in React UI)", Point(x, y),
-           FONT_HERSHEY_SIMPLEX, 0.4, Scalar(150, 150, 150), 1);
-    y += lineHeight + 10;
-    
-    // Draw visualization area
-    int vizX = x + 20;
-    int vizY = y;
-    int vizWidth = width - 2 * x - 40;
-    int vizHeight = height - vizY - 60;
-    
-    // Background for visualization
-    rectangle(canvas, Point(vizX, vizY), Point(vizX + vizWidth, vizY + vizHeight), 
-             Scalar(20, 20, 30), -1);
-    rectangle(canvas, Point(vizX, vizY), Point(vizX + vizWidth, vizY + vizHeight), 
-             Scalar(100, 100, 100), 1);
-    
-    // Draw axes
-    int centerX = vizX + vizWidth / 2;
-    int centerY = vizY + vizHeight / 2;
-    
-    // Horizontal axis (Pan)
-    line(canvas, Point(vizX, centerY), Point(vizX + vizWidth, centerY), Scalar(100, 100, 100), 1);
-    putText(canvas, "Pan (-1.0)", Point(vizX + 5, centerY - 5), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
-    putText(canvas, "Pan (+1.0)", Point(vizX + vizWidth - 60, centerY - 5), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
-    
-    // Vertical axis (Tilt)
-    line(canvas, Point(centerX, vizY), Point(centerX, vizY + vizHeight), Scalar(100, 100, 100), 1);
-    putText(canvas, "Tilt (+1.0)", Point(centerX + 5, vizY + 15), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
-    putText(canvas, "Tilt (-1.0)", Point(centerX + 5, vizY + vizHeight - 5), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
-    
-    // Draw range boxes (min/max limits)
-    int panMinX = vizX + static_cast<int>((state.config.panMin / 255.0f) * vizWidth);
-    int panMaxX = vizX + static_cast<int>((state.config.panMax / 255.0f) * vizWidth);
-    rectangle(canvas, Point(vizX, vizY), Point(panMinX, vizY + vizHeight), 
-             Scalar(50, 0, 0), -1); // Red for clamped min
-    rectangle(canvas, Point(panMaxX, vizY), Point(vizX + vizWidth, vizY + vizHeight), 
-             Scalar(50, 0, 0), -1); // Red for clamped max
-    
-    // Draw current face position
-    if (state.faceDetected) {
-        // Map face position to visualization
-        int faceX = centerX + static_cast<int>(currentPan * (vizWidth / 2));
-        int faceY = centerY - static_cast<int>(currentTilt * (vizHeight / 2));
-        faceX = std::max(vizX, std::min(vizX + vizWidth, faceX));
-        faceY = std::max(vizY, std::min(vizY + vizHeight, faceY));
-        
-        // Draw face position indicator
-        circle(canvas, Point(faceX, faceY), 8, Scalar(0, 255, 255), -1); // Yellow circle
-        circle(canvas, Point(faceX, faceY), 8, Scalar(255, 255, 255), 2); // White border
-        
-        // Calculate and show DMX values
-        int panValue, tiltValue;
-        mapToDmx(currentPan, currentTilt, state.config, panValue, tiltValue);
-        
-        // Draw DMX output position
-        int dmxX = vizX + static_cast<int>((panValue / 255.0f) * vizWidth);
-        int dmxY = centerY - static_cast<int>(((tiltValue - 128) / 127.0f) * (vizHeight / 2));
-        dmxX = std::max(vizX, std::min(vizX + vizWidth, dmxX));
-        dmxY = std::max(vizY, std::min(vizY + vizHeight, dmxY));
-        
-        // Draw line from face to DMX output
-        line(canvas, Point(faceX, faceY), Point(dmxX, dmxY), Scalar(100, 255, 100), 2);
-        
-        // Draw DMX output indicator
-        circle(canvas, Point(dmxX, dmxY), 6, Scalar(0, 255, 0), -1); // Green circle
-        circle(canvas, Point(dmxX, dmxY), 6, Scalar(255, 255, 255), 2); // White border
-        
-        // Show values
-        putText(canvas, "Face: (" + std::to_string(currentPan).substr(0, 3) + "," + 
-               std::to_string(currentTilt).substr(0, 3) + ")", 
-               Point(faceX - 30, faceY - 15), FONT_HERSHEY_SIMPLEX, 0.35, Scalar(255, 255, 255), 1);
-        putText(canvas, "DMX: (" + std::to_string(panValue) + "," + std::to_string(tiltValue) + ")", 
-               Point(dmxX - 25, dmxY + 20), FONT_HERSHEY_SIMPLEX, 0.35, Scalar(200, 255, 200), 1);
+        logMessage(LOG_INFO, LOG_STATS, "Capture latency - Avg: %g ms | Max: %g ms", avgMs, maxMs);
     }
-    
-    // Legend
-    y = vizY + vizHeight + 15;
-    putText(canvas, "Legend: Yellow = Face Position | Green = DMX Output | Red = Clamped Range", 
-           Point(x, y), FONT_HERSHEY_SIMPLEX, 0.35, textColor, 1);
+    latency = CaptureLatencyStats();
 }
 
-// Helper function to reload config periodically (called from main loop)
-void reloadConfigIfChanged(Config& config) {
-    static std::chrono::steady_clock::time_point lastCheck = std::chrono::steady_clock::now();
-    static std::string lastConfigHash;
-    
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastCheck).count();
-    
-    // Check every 500ms
-    if (elapsed < 500) {
-        return;
+// Record a pipeline stage that began at startUs (metrics histogram and/or trace span);
+// returns now, the start of the next stage
+int64_t observeStage(FaceTrackerState& state, MetricsStage stage, int64_t startUs) {
+    int64_t now = static_cast<int64_t>(shmNowUs());
+    if (state.metricsServer.isRunning()) {
+        state.metrics.stages[stage].observeUs(now - startUs);
     }
-    
-    lastCheck = now;
-    
-    // Read config file
-    std::ifstream file("face-tracker-config.json");
-    if (!file.is_open()) {
-        return;
+    if (traceEnabled()) {
+        traceSpan(metricsStageName(stage), state.frameNumber, startUs, now);
     }
-    
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
-    
-    // Simple hash to detect changes
-    std::hash<std::string> hasher;
-    std::string currentHash = std::to_string(hasher(content));
-    
-    if (currentHash != lastConfigHash) {
-        lastConfigHash = currentHash;
-        
-        try {
-            json j = json::parse(content);
-            
-            // Reload all config values
-            if (j.contains("dmxApiUrl")) config.dmxApiUrl = j["dmxApiUrl"];
-            if (j.contains("panChannel")) config.panChannel = j["panChannel"];
-            if (j.contains("tiltChannel")) config.tiltChannel = j["tiltChannel"];
-            if (j.contains("irisChannel")) config.irisChannel = j["irisChannel"];
-            if (j.contains("zoomChannel")) config.zoomChannel = j["zoomChannel"];
-            if (j.contains("focusChannel")) config.focusChannel = j["focusChannel"];
-            if (j.contains("cameraIndex")) config.cameraIndex = j["cameraIndex"];
-            if (j.contains("updateRate")) config.updateRate = j["updateRate"];
-            if (j.contains("panSensitivity")) config.panSensitivity = j["panSensitivity"];
-            if (j.contains("tiltSensitivity")) config.tiltSensitivity = j["tiltSensitivity"];
-            if (j.contains("panOffset")) config.panOffset = j["panOffset"];
-            if (j.contains("tiltOffset")) config.tiltOffset = j["tiltOffset"];
-            if (j.contains("irisValue")) config.irisValue = j["irisValue"];
-            if (j.contains("zoomValue")) config.zoomValue = j["zoomValue"];
-            if (j.contains("focusValue")) config.focusValue = j["focusValue"];
-            if (j.contains("showPreview")) config.showPreview = j["showPreview"];
-            if (j.contains("show3DVisualization")) config.show3DVisualization = j["show3DVisualization"];
-            if (j.contains("smoothingFactor")) config.smoothingFactor = j["smoothingFactor"];
-            if (j.contains("maxVelocity")) config.maxVelocity = j["maxVelocity"];
-            if (j.contains("brightness")) config.brightness = j["brightness"];
-            if (j.contains("contrast")) config.contrast = j["contrast"];
-            if (j.contains("cameraExposure")) config.cameraExposure = j["cameraExposure"];
-            if (j.contains("cameraBrightness")) config.cameraBrightness = j["cameraBrightness"];
-            if (j.contains("autoExposure")) config.autoExposure = j["autoExposure"];
-            if (j.contains("useOSC")) config.useOSC = j["useOSC"];
-            if (j.contains("oscHost")) config.oscHost = j["oscHost"];
-            if (j.contains("oscPort")) config.oscPort = j["oscPort"];
-            if (j.contains("oscPanPath")) config.oscPanPath = j["oscPanPath"];
-            if (j.contains("oscTiltPath")) config.oscTiltPath = j["oscTiltPath"];
-            if (j.contains("oscIrisPath")) config.oscIrisPath = j["oscIrisPath"];
-            if (j.contains("oscZoomPath")) config.oscZoomPath = j["oscZoomPath"];
-            if (j.contains("oscFocusPath")) config.oscFocusPath = j["oscFocusPath"];
-            if (j.contains("panMin")) config.panMin = j["panMin"];
-            if (j.contains("panMax")) config.panMax = j["panMax"];
-            if (j.contains("tiltMin")) config.tiltMin = j["tiltMin"];
-            if (j.contains("tiltMax")) config.tiltMax = j["tiltMax"];
-            if (j.contains("irisMin")) config.irisMin = j["irisMin"];
-            if (j.contains("irisMax")) config.irisMax = j["irisMax"];
-            if (j.contains("zoomMin")) config.zoomMin = j["zoomMin"];
-            if (j.contains("zoomMax")) config.zoomMax = j["zoomMax"];
-            if (j.contains("focusMin")) config.focusMin = j["focusMin"];
-            if (j.contains("focusMax")) config.focusMax = j["focusMax"];
-            if (j.contains("panScale")) config.panScale = j["panScale"];
-            if (j.contains("tiltScale")) config.tiltScale = j["tiltScale"];
-            if (j.contains("panDeadZone")) config.panDeadZone = j["panDeadZone"];
-            if (j.contains("tiltDeadZone")) config.tiltDeadZone = j["tiltDeadZone"];
-            if (j.contains("panLimit")) config.panLimit = j["panLimit"];
-            if (j.contains("tiltLimit")) config.tiltLimit = j["tiltLimit"];
-            if (j.contains("panGear")) config.panGear = j["panGear"];
-            if (j.contains("tiltGear")) config.tiltGear = j["tiltGear"];
-            
-            std::cout << "Configuration reloaded from React UI" << std::endl;
-        } catch (const std::exception& e) {
-            std::cerr << "Error reloading config: " << e.what() << std::endl;
-        }
-    }
-}
-
-// Render detailed 3D moving head fixture visualization
-void render3DFixture(Mat& canvas, float /*panAngle*/, float /*tiltAngle*/, int panDmx, int tiltDmx, 
-                     float viewAngleX, float viewAngleY, float viewDist, bool showLattice) {
-    int width = canvas.cols;
-    int height = canvas.rows;
-    
-    // Center point
-    Point center(width / 2, height / 2);
-    int scale = std::min(width, height) / 4;
-    
-    // Convert pan/tilt to radians
-    float panRad = ((panDmx - 128) / 128.0f) * CV_PI / 2.0f;
-    float tiltRad = ((tiltDmx - 128) / 128.0f) * CV_PI / 4.0f;
-    
-    // Define 3D model coordinates (in fixture-local space)
-    // Base stand (cylindrical)
-    float baseHeight = 0.8f;
-    float baseRadius = 0.15f;
-    int baseSegments = 12;
-    
-    // Pan arm (horizontal bar)
-    float armLength = 0.4f;
-    
-    // Fixture head dimensions
-    float headLength = 0.35f;
-    float headWidth = 0.25f;
-    float headHeight = 0.2f;
-    
-    // Draw base stand (vertical cylinder from bottom)
-    Scalar baseColor(80, 80, 90); // Dark gray metallic
-    Scalar armColor(120, 120, 130); // Lighter gray
-    Scalar headColor(150, 150, 180); // Purple-tinted metallic
-    Scalar lensColor(255, 220, 100); // Warm yellow/orange
-    Scalar beamColor(255, 200, 50, 180); // Yellow beam with transparency
-    
-    // Base cylinder - draw top and bottom circles
-    std::vector<Point> baseBottom, baseTop;
-    for (int i = 0; i < baseSegments; i++) {
-        float angle = (i / float(baseSegments)) * 2.0f * CV_PI;
-        float x = std::cos(angle) * baseRadius;
-        float y = std::sin(angle) * baseRadius;
-        baseBottom.push_back(project3D(x, -baseHeight/2, y, viewAngleX, viewAngleY, viewDist, center.x, center.y, scale));
-        baseTop.push_back(project3D(x, baseHeight/2, y, viewAngleX, viewAngleY, viewDist, center.x, center.y, scale));
-    }
-    
-    // Draw base cylinder sides
-    for (size_t i = 0; i < baseBottom.size(); i++) {
-        line(canvas, baseBottom[i], baseTop[i], baseColor, 3);
-        line(canvas, baseBottom[i], baseBottom[(i+1) % baseBottom.size()], baseColor, 2);
-        line(canvas, baseTop[i], baseTop[(i+1) % baseTop.size()], baseColor, 2);
-    }
-    
-    // Pan rotation - rotate arm around Y axis
-    float cosPan = std::cos(panRad);
-    float sinPan = std::sin(panRad);
-    
-    // Pan arm (horizontal bar extending from base)
-    Point armStart = project3D(0, baseHeight/2 + 0.05f, 0, viewAngleX, viewAngleY, viewDist, center.x, center.y, scale);
-    Point armEnd = project3D(armLength * cosPan, baseHeight/2 + 0.05f, armLength * sinPan, 
-                             viewAngleX, viewAngleY, viewDist, center.x, center.y, scale);
-    
-    // Draw pan arm with thickness
-    line(canvas, armStart, armEnd, armColor, 8);
-    
-    // Pan joint (rotating connection)
-    circle(canvas, armStart, 6, Scalar(200, 200, 210), -1);
-    circle(canvas, armStart, 6, Scalar(255, 255, 255), 2);
-    
-    // Fixture head position (at end of arm, with tilt rotation)
-    float headX = armLength * cosPan;
-    float headZ = armLength * sinPan;
-    float headY = baseHeight/2 + 0.1f;
-    
-    // Tilt rotation (around local X axis)
-    float cosTilt = std::cos(tiltRad);
-    float sinTilt = std::sin(tiltRad);
-    
-    // Define head corners in local space (before tilt)
-    std::vector<std::vector<float>> headCornersLocal = {
-        {-headWidth/2, headHeight/2, -headLength/2}, // Front-bottom-left
-        {headWidth/2, headHeight/2, -headLength/2},  // Front-bottom-right
-        {headWidth/2, -headHeight/2, -headLength/2}, // Front-top-right
-        {-headWidth/2, -headHeight/2, -headLength/2},// Front-top-left
-        {-headWidth/2, headHeight/2, headLength/2},  // Back-bottom-left
-        {headWidth/2, headHeight/2, headLength/2},   // Back-bottom-right
-        {headWidth/2, -headHeight/2, headLength/2},  // Back-top-right
-        {-headWidth/2, -headHeight/2, headLength/2}  // Back-top-left
-    };
-    
-    // Apply tilt rotation, then translate to head position, then pan rotation
-    std::vector<Point> headCorners2D;
-    for (const auto& corner : headCornersLocal) {
-        // Apply tilt rotation (around X axis)
-        float x = corner[0];
-        float y = corner[1] * cosTilt - corner[2] * sinTilt;
-        float z = corner[1] * sinTilt + corner[2] * cosTilt;
-        
-        // Translate to head position
-        x += headX;
-        y += headY;
-        z += headZ;
-        
-        // Project to 2D
-        headCorners2D.push_back(project3D(x, y, z, viewAngleX, viewAngleY, viewDist, center.x, center.y, scale));
+    return now;
+}
+
+// Stage timing only reads the clock while metrics or tracing want it
+bool stageTimingEnabled(const FaceTrackerState& state) {
+    return state.metricsServer.isRunning() || traceEnabled();
+}
+
+// Copy counters and queue depths kept elsewhere into the metrics (tracking thread, once per frame)
+void publishMetrics(FaceTrackerState& state, const VideoCapture& cap, JpegDecodePool& decoder) {
+    TrackerMetrics& metrics = state.metrics;
+    const OutputState& output = state.output;
+    metrics.outputSent.store(output.sentCount, std::memory_order_relaxed);
+    metrics.outputSuppressed.store(output.suppressedCount, std::memory_order_relaxed);
+    metrics.outputKeyframes.store(output.keyframeCount, std::memory_order_relaxed);
+    metrics.outputFailures.store(output.failedCount, std::memory_order_relaxed);
+    metrics.curlErrors.store(output.httpErrors, std::memory_order_relaxed);
+    metrics.oscErrors.store(output.oscErrors, std::memory_order_relaxed);
+    if (const V4l2Capture* v4l2 = dynamic_cast<const V4l2Capture*>(&cap)) {
+        metrics.driverDroppedFrames.store(v4l2->droppedFrames(), std::memory_order_relaxed);
     }
-    
-    // Draw head faces (box)
-    // Front face (facing camera)
-    std::vector<Point> frontFace = {headCorners2D[2], headCorners2D[3], headCorners2D[0], headCorners2D[1]};
-    fillPoly(canvas, std::vector<std::vector<Point>>{frontFace}, headColor);
-    
-    // Top face
-    std::vector<Point> topFace = {headCorners2D[3], headCorners2D[2], headCorners2D[6], headCorners2D[7]};
-    fillPoly(canvas, std::vector<std::vector<Point>>{topFace}, Scalar(headColor[0]*1.2f, headColor[1]*1.2f, headColor[2]*1.2f));
-    
-    // Draw head edges
-    for (int i = 0; i < 4; i++) {
-        line(canvas, headCorners2D[i], headCorners2D[(i+1)%4], Scalar(255, 255, 255), 2); // Front face
-        line(canvas, headCorners2D[i+4], headCorners2D[((i+1)%4)+4], Scalar(200, 200, 200), 2); // Back face
-        line(canvas, headCorners2D[i], headCorners2D[i+4], Scalar(180, 180, 180), 2); // Connecting edges
+    if (decoder.isRunning()) {
+        metrics.decodeFailures.store(decoder.failedCount(), std::memory_order_relaxed);
+        metrics.decodeQueueDepth.store(decoder.pendingCount(), std::memory_order_relaxed);
     }
-    
-    // Draw lens (at front of head)
-    Point lensCenter2D = project3D(headX, headY, headZ - headLength/2, 
-                                    viewAngleX, viewAngleY, viewDist, center.x, center.y, scale);
-    int lensRadius = scale / 15;
-    circle(canvas, lensCenter2D, lensRadius, lensColor, -1);
-    circle(canvas, lensCenter2D, lensRadius, Scalar(255, 255, 255), 2);
-    
-    // Draw light beam (from lens)
-    float beamLength = 1.5f;
-    float beamX = headX + std::sin(panRad + tiltRad) * beamLength;
-    float beamY = headY - std::cos(tiltRad) * beamLength * 0.3f;
-    float beamZ = headZ - headLength/2 - std::cos(panRad + tiltRad) * beamLength;
-    Point beamEnd2D = project3D(beamX, beamY, beamZ, 
-                                viewAngleX, viewAngleY, viewDist, center.x, center.y, scale);
-    
-    // Draw beam with gradient effect (lines from center to edge)
-    for (int i = 0; i < 5; i++) {
-        float t = i / 4.0f;
-        int thickness = 5 - i;
-        Scalar beamColorScalar(255 - i*30, 200 - i*20, 50 - i*5);
-        Point beamMid = Point(lensCenter2D.x + (beamEnd2D.x - lensCenter2D.x) * t,
-                              lensCenter2D.y + (beamEnd2D.y - lensCenter2D.y) * t);
-        if (thickness > 0) {
-            line(canvas, lensCenter2D, beamMid, beamColorScalar, thickness);
-        }
+    metrics.previewClients.store(state.mjpeg.clientCount(), std::memory_order_relaxed);
+    metrics.faceDetected.store(state.faceDetected ? 1 : 0, std::memory_order_relaxed);
+    metrics.logDropped.store(droppedLogMessages(), std::memory_order_relaxed);
+    if (state.recorder.isOpen()) {
+        metrics.recordedFrames.store(state.recorder.recordedCount(), std::memory_order_relaxed);
+        metrics.recordDropped.store(state.recorder.droppedCount(), std::memory_order_relaxed);
     }
-    
-    // Draw tilt joint (at arm end)
-    circle(canvas, armEnd, 5, Scalar(180, 180, 190), -1);
-    circle(canvas, armEnd, 5, Scalar(255, 255, 255), 1);
-    
-    // Draw XYZ axes/lattice if enabled
-    if (showLattice) {
-        drawXYZAxes(canvas, viewAngleX, viewAngleY, viewDist, center.x, center.y, scale);
+}
+
+// Keep the failsafe's output settings current (the watchdog thread sends with them)
+void syncFailsafeConfig(FaceTrackerState& state) {
+    std::lock_guard<std::mutex> lock(state.failsafe.mutex);
+    state.failsafe.config = state.config;
+    state.failsafeSyncTime = std::chrono::steady_clock::now();
+}
+
+// Log the ground truth of a synthetic frame next to the tracked pose; true once
+// syntheticFrames frames of the script have been tracked
+bool recordSyntheticFrame(FaceTrackerState& state, const SyntheticCapture& synthetic, int64_t latencyUs) {
+    const SyntheticTruth& truth = synthetic.truth();
+    state.syntheticTruth.record(truth, state.faceDetected, state.pose.currentPan, state.pose.currentTilt,
+                                state.pose.smoothedPan, state.pose.smoothedTilt, latencyUs);
+    return state.config.syntheticFrames > 0 && truth.frame + 1 >= static_cast<uint64_t>(state.config.syntheticFrames);
+}
+
+// Preview overlay: landmarks (bright yellow) and face rectangle (bright orange), or
+// the face centre when the pose came from the rectangle alone.
+// Pan/tilt values are on the theatre overlay, not on the preview frame.
+void drawFaceOverlay(Mat& frame, const Rect& face, const std::vector<Point2f>& landmarks) {
+    for (const auto& point : landmarks) {
+        circle(frame, point, 3, Scalar(0, 255, 255), -1);
+    }
+    rectangle(frame, face, Scalar(0, 165, 255), 3);
+    if (landmarks.empty()) {
+        Point2f center(face.x + face.width / 2.0f, face.y + face.height / 2.0f);
+        circle(frame, center, 6, Scalar(0, 255, 255), -1);
+    }
+}
+
+// Queue the frame just tracked for the recorder, with its detections and output values.
+// MJPEG records the tracked frame's own JPEG (the capture buffer has moved on by now).
+void recordCameraFrame(FaceTrackerState& state, const VideoCapture& cap, CameraFrame& cameraFrame,
+                       const DecodedJpegFrame& decodedFrame, const std::vector<Rect>& faces,
+                       uint8_t poseFlags, int64_t timestampUs, FrameRecordInfo& info) {
+    bool mjpeg = cameraFrame.format() == CAPTURE_MJPEG;
+    info.frame = state.frameNumber;
+    info.timestampUs = timestampUs;
+    info.fps = cap.get(CAP_PROP_FPS);
+    
+    // Without a full-size decode, MJPEG detections are still in the reduced image
+    int scale = mjpeg && decodedFrame.full.empty() ? decodedFrame.scale : 1;
+    info.faces.clear();
+    for (const Rect& face : faces) {
+        info.faces.push_back(Rect(face.x * scale, face.y * scale, face.width * scale, face.height * scale));
+    }
+    if (poseFlags & SHM_POSE_LANDMARKS) {
+        info.landmarks = state.landmarks;
+    } else {
+        info.landmarks.clear();
+    }
+    info.face = (poseFlags & SHM_POSE_FACE) != 0;
+    info.pan = state.pose.currentPan;
+    info.tilt = state.pose.currentTilt;
+    info.smoothedPan = state.pose.smoothedPan;
+    info.smoothedTilt = state.pose.smoothedTilt;
+    mapToDmx(state.pose.smoothedPan, state.pose.smoothedTilt, state.config, info.panDmx, info.tiltDmx);
+    
+    if (mjpeg) {
+        Mat jpeg(1, static_cast<int>(decodedFrame.jpeg.size()), CV_8UC1, const_cast<uchar*>(decodedFrame.jpeg.data()));
+        state.recorder.submit(jpeg, CAPTURE_MJPEG, info);
+    } else if (cameraFrame.isRaw()) {
+        state.recorder.submit(cameraFrame.yuv(), cameraFrame.format(), info);
+    } else {
+        state.recorder.submit(cameraFrame.bgr(), CAPTURE_BGR, info);
+    }
+}
+
+// (Re)start the frame recorder after a record* change; an empty recordPath stops it
+void restartRecorder(FaceTrackerState& state) {
+    state.recorder.close();
+    if (!state.config.recordPath.empty()) {
+        state.recorder.open(state.config.recordPath, state.config.recordFormat, state.config.recordQueueFrames);
     }
-    
-    // Text overlay - moved to bottom to avoid title overlap
-    std::string dmxText = "Pan: " + std::to_string(panDmx) + " | Tilt: " + std::to_string(tiltDmx);
-    putText(canvas, dmxText, Point(10, height - 35), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 255, 200), 2);
-    
-    // Draw angles (moved lower)
-    std::string angleText = "Pan: " + std::to_string(static_cast<int>(panRad * 180.0f / CV_PI)) + 
-                           "° | Tilt: " + std::to_string(static_cast<int>(tiltRad * 180.0f / CV_PI)) + "°";
-    putText(canvas, angleText, Point(10, height - 10), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 255, 200), 2);
-    
 }
 
-// Apply brightness and contrast adjustments
-void adjustBrightnessContrast(const Mat& src, Mat& dst, float brightness, float contrast) {
-    // Brightness: add/subtract constant value
-    // Contrast: multiply pixel values
-    src.convertTo(dst, -1, contrast, (brightness - 1.0f) * 127.0f);
+// Tracking thread: the pipeline made progress (a frame, or an idle daemon tick)
+void watchdogHeartbeat(FaceTrackerState& state) {
+    int64_t stalledMs = state.watchdog.heartbeat();
+    if (stalledMs > 0) {
+        state.metrics.watchdogStalls.fetch_add(1, std::memory_order_relaxed);
+        state.output.keyframeSent = false; // Fixtures were moved behind our back: resend everything
+        logMessage(LOG_WARN, LOG_GENERAL, "Watchdog: tracking resumed after a %lld ms stall",
+                   static_cast<long long>(stalledMs));
+    }
+    if (std::chrono::steady_clock::now() - state.failsafeSyncTime >= std::chrono::seconds(1)) {
+        syncFailsafeConfig(state);
+    }
+}
+
+// Watchdog thread: tracking has stalled, send the fixtures to the failsafe position
+void sendFailsafe(FailsafeOutput& failsafe, int64_t stalledMs) {
+    // Copy under the lock and send without it: a slow endpoint (curl timeout) must not
+    // block the tracking thread's syncFailsafeConfig() if it recovers meanwhile
+    Config config;
+    {
+        std::lock_guard<std::mutex> lock(failsafe.mutex);
+        config = failsafe.config;
+    }
+    // The stream connection belongs to the (stalled) tracking thread and Node accepts only
+    // one, so the failsafe goes out over OSC or HTTP
+    config.useStream = false;
+    failsafe.output.keyframeSent = false; // Every channel, every time
+    
+    int panValue = 0;
+    int tiltValue = 0;
+    failsafePosition(config, panValue, tiltValue);
+    bool sent = sendDmxValues(config, failsafe.output, panValue, tiltValue);
+    logMessage(LOG_ERROR, LOG_GENERAL, "Watchdog: no frame for %lld ms, %s failsafe position (pan %d, tilt %d)",
+               static_cast<long long>(stalledMs), sent ? "sent fixtures to" : "failed to send",
+               panValue, tiltValue);
 }
 
-// Helper function to safely set camera property (checks if supported)
-bool setCameraProperty(VideoCapture& cap, int propId, double value, const std::string& propName = "") {
-    bool success = cap.set(propId, value);
-    if (!success && !propName.empty()) {
-        // Property not supported by this camera backend (e.g., GStreamer)
-        // This is normal for some properties on certain cameras
+// Configure camera exposure and brightness (may not be supported by all cameras)
+void applyCameraExposure(VideoCapture& cap, const Config& config) {
+    if (!config.autoExposure) {
+        // Disable auto exposure for manual control
+        setCameraProperty(cap, CAP_PROP_AUTO_EXPOSURE, 0.25, "auto exposure");
+        if (config.cameraExposure >= -13 && config.cameraExposure <= 1) {
+            bool success = setCameraProperty(cap, CAP_PROP_EXPOSURE, config.cameraExposure, "exposure");
+            if (success) {
+                std::cout << "Set camera exposure to: " << config.cameraExposure << " (manual mode)" << std::endl;
+            }
+        } else {
+            // Default exposure if not set
+            bool success = setCameraProperty(cap, CAP_PROP_EXPOSURE, -6.0, "exposure");
+            if (success) {
+                std::cout << "Set camera exposure to default: -6.0 (manual mode)" << std::endl;
+            }
+        }
+    } else {
+        // Enable auto exposure initially
+        bool success = setCameraProperty(cap, CAP_PROP_AUTO_EXPOSURE, 0.75, "auto exposure");
+        if (success) {
+            std::cout << "Auto exposure enabled (slider will switch to manual when adjusted)" << std::endl;
+        }
+    }
+    
+    if (config.cameraBrightness >= 0) {
+        bool success = setCameraProperty(cap, CAP_PROP_BRIGHTNESS, config.cameraBrightness, "brightness");
+        if (success) {
+            std::cout << "Set camera brightness to: " << config.cameraBrightness << std::endl;
+        }
     }
-    return success;
 }
 
 // Trackbar callback functions
@@ -1792,13 +1284,12 @@ void onMouse(int event, int x, int y, int flags, void* userdata) {
     }
     
     // Handle buttons in Theatre window (on stage floor)
-    if (event == EVENT_LBUTTONDOWN && !state->lastDisplayFrame.empty()) {
+    if (event == EVENT_LBUTTONDOWN && !state->theatreSize.empty()) {
         // Get theatre frame dimensions
-        int theatreWidth = state->lastDisplayFrame.cols;
-        int theatreHeight = state->lastDisplayFrame.rows;
-        int headerHeight = 60;
-        int stageHeight = 40;
-        int curtainWidth = 80;
+        int theatreWidth = state->theatreSize.width;
+        int theatreHeight = state->theatreSize.height;
+        int headerHeight = THEATRE_HEADER_HEIGHT;
+        int stageHeight = THEATRE_STAGE_HEIGHT;
         
         // Button dimensions and positions (on stage floor)
         int buttonWidth = 150;
@@ -1834,170 +1325,709 @@ void onMouse(int event, int x, int y, int flags, void* userdata) {
 }
 
 
-// Main tracking loop
-void trackFace(VideoCapture& cap, FaceTrackerState& state) {
-    Mat frame, gray, adjusted;
-    std::vector<Rect> faces;
-    std::vector<std::vector<Point2f>> shapes;
+// Smooth a raw pan/tilt estimate, detect gestures and send DMX at the configured rate
+// (shared by the landmark and face-center tracking paths)
+void updateTrackedPose(FaceTrackerState& state, float pan, float tilt, bool fromLandmarks,
+                       std::chrono::steady_clock::time_point& lastUpdate) {
+    int64_t poseStartUs = traceEnabled() ? traceNowUs() : 0;
+    std::string gesture;
+    uint8_t gestureEvent = 0; // Pose log code of a newly detected gesture
+    if (state.pose.update(pan, tilt, state.config, gesture)) {
+        logMessage(LOG_INFO, LOG_GESTURE, "Gesture detected: %s", gesture.c_str());
+        gestureEvent = poseLogGestureCode(gesture);
+        if (state.config.useStream) {
+            state.output.stream.sendGesture(gesture);
+        }
+    }
     
-    int frameCount = 0;
-    bool trackbarsCreated = false;  // Flag to ensure trackbars are created only once
+    // Map to DMX values
+    int panValue, tiltValue;
+    mapToDmx(state.pose.smoothedPan, state.pose.smoothedTilt, state.config, panValue, tiltValue);
     
-    auto lastUpdate = std::chrono::steady_clock::now();
+    if (state.config.useStream) {
+        uint8_t flags = STREAM_POSE_FACE | (fromLandmarks ? STREAM_POSE_LANDMARKS : 0);
+        state.output.stream.sendPose(pan, tilt, state.pose.smoothedPan, state.pose.smoothedTilt, panValue, tiltValue, flags);
+    }
     
-    while (true) {
-        cap >> frame;
-        if (frame.empty()) {
-            std::cerr << "Failed to capture frame" << std::endl;
-            break;
+    if (state.poseLog.isOpen()) {
+        PoseLogRecord record;
+        record.pan = pan;
+        record.tilt = tilt;
+        record.smoothedPan = state.pose.smoothedPan;
+        record.smoothedTilt = state.pose.smoothedTilt;
+        record.panDmx = static_cast<uint8_t>(panValue);
+        record.tiltDmx = static_cast<uint8_t>(tiltValue);
+        record.flags = POSE_LOG_FACE | (fromLandmarks ? POSE_LOG_LANDMARKS : 0) | (gestureEvent ? POSE_LOG_GESTURE : 0);
+        record.gesture = gestureEvent;
+        state.poseLog.append(record);
+    }
+    
+    // Send DMX update at configured rate
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate).count();
+    int updateInterval = 1000 / state.config.updateRate;
+    
+    if (elapsed >= updateInterval) {
+        int64_t sendStartUs = stageTimingEnabled(state) ? static_cast<int64_t>(shmNowUs()) : 0;
+        sendDmxValues(state.config, state.output, panValue, tiltValue);
+        if (sendStartUs > 0) {
+            observeStage(state, STAGE_OUTPUT, sendStartUs);
         }
+        lastUpdate = now;
         
-        // Create separate windows for each configuration category
-        if (state.config.showPreview && !trackbarsCreated) {
-            // Window 1: Theatre preview (RESIZABLE - user can drag corners to resize)
-            namedWindow("ArtBastard Puppet Theatre", WINDOW_NORMAL);
-            resizeWindow("ArtBastard Puppet Theatre", 900, 700);
-            moveWindow("ArtBastard Puppet Theatre", 0, 0);
-            setMouseCallback("ArtBastard Puppet Theatre", onMouse, &state);
-            
-            // Window 2: 3D Visualization (RESIZABLE)
-            namedWindow("3D Fixture Visualization", WINDOW_NORMAL);
-            resizeWindow("3D Fixture Visualization", 800, 600);
-            moveWindow("3D Fixture Visualization", 920, 0);
-            setMouseCallback("3D Fixture Visualization", onMouse, &state);
-            
-            // Window 3: Rigging Preview (configuration UI is now in React)
-            namedWindow("Rigging Preview", WINDOW_NORMAL);
-            resizeWindow("Rigging Preview", 600, 500);
-            moveWindow("Rigging Preview", 1740, 0);
-            
-            // Initialize button states
-            state.autoExposureSlider = state.config.autoExposure ? 1 : 0;
-            state.colorModeSlider = 1; // Default to color mode
-            // Configuration window is separate and always visible
-            
-            // Camera control trackbars on theatre window (descriptive labels)
-            createTrackbar("Camera Brightness (0-100, multiplies image brightness)", "ArtBastard Puppet Theatre", 
-                          &state.brightnessSlider, 100, onBrightnessTrackbar, &state);
-            setTrackbarPos("Camera Brightness (0-100, multiplies image brightness)", "ArtBastard Puppet Theatre", state.brightnessSlider);
-            
-            createTrackbar("Camera Contrast (0-100, multiplies image contrast)", "ArtBastard Puppet Theatre", 
-                          &state.contrastSlider, 100, onContrastTrackbar, &state);
-            setTrackbarPos("Camera Contrast (0-100, multiplies image contrast)", "ArtBastard Puppet Theatre", state.contrastSlider);
-            
-            createTrackbar("Camera Exposure (0=dark, 100=bright, manual mode)", "ArtBastard Puppet Theatre", 
-                          &state.exposureSlider, 100, onExposureTrackbar, &state);
-            setTrackbarPos("Camera Exposure (0=dark, 100=bright, manual mode)", "ArtBastard Puppet Theatre", state.exposureSlider);
-            
-            // 3D viewport trackbars on 3D window (descriptive labels)
-            if (state.config.show3DVisualization) {
-                createTrackbar("3D View Rotation X (up/down angle, 0-360)", "3D Fixture Visualization", &state.viewAngleXSlider, 360, onViewAngleXTrackbar, &state);
-                setTrackbarPos("3D View Rotation X (up/down angle, 0-360)", "3D Fixture Visualization", 180);
-                
-                createTrackbar("3D View Rotation Y (left/right angle, 0-360)", "3D Fixture Visualization", &state.viewAngleYSlider, 360, onViewAngleYTrackbar, &state);
-                setTrackbarPos("3D View Rotation Y (left/right angle, 0-360)", "3D Fixture Visualization", 180);
-            }
-            
-            trackbarsCreated = true;
-            std::cout << "Windows created: Theatre, 3D Visualization, Rigging Preview!" << std::endl;
+        if (!gesture.empty()) {
+            logMessage(LOG_INFO, LOG_POSE, "Face tracked - Pan: %d, Tilt: %d | Gesture: %s",
+                       panValue, tiltValue, gesture.c_str());
+        } else if (fromLandmarks) {
+            logMessage(LOG_INFO, LOG_POSE, "Face tracked - Pan: %d, Tilt: %d (raw: %g, %g)",
+                       panValue, tiltValue, state.pose.smoothedPan, state.pose.smoothedTilt);
+        }
+    }
+    
+    if (poseStartUs > 0) {
+        traceSpan("pose", state.frameNumber, poseStartUs, traceNowUs());
+    }
+}
+
+// Publish this frame's pose, landmarks and DMX values (plus an optional preview) to the shared memory ring
+void publishSharedState(FaceTrackerState& state, const Mat& frame, uint64_t frameNumber, uint8_t flags) {
+    const Config& config = state.config;
+    
+    ShmPoseSample sample;
+    std::memset(&sample, 0, sizeof(sample));
+    sample.frame = frameNumber;
+    sample.timestampUs = shmNowUs();
+    sample.rawPan = (flags & SHM_POSE_FACE) ? state.pose.currentPan : state.pose.smoothedPan;
+    sample.rawTilt = (flags & SHM_POSE_FACE) ? state.pose.currentTilt : state.pose.smoothedTilt;
+    sample.smoothedPan = state.pose.smoothedPan;
+    sample.smoothedTilt = state.pose.smoothedTilt;
+    sample.frameWidth = static_cast<uint16_t>(frame.cols);
+    sample.frameHeight = static_cast<uint16_t>(frame.rows);
+    sample.flags = flags;
+    
+    if (flags & SHM_POSE_LANDMARKS) {
+        size_t count = std::min<size_t>(state.landmarks.size(), SHM_MAX_LANDMARKS);
+        sample.landmarkCount = static_cast<uint8_t>(count);
+        for (size_t i = 0; i < count; i++) {
+            sample.landmarks[i][0] = state.landmarks[i].x;
+            sample.landmarks[i][1] = state.landmarks[i].y;
+        }
+    }
+    
+    int panValue, tiltValue;
+    mapToDmx(state.pose.smoothedPan, state.pose.smoothedTilt, config, panValue, tiltValue);
+    const int channels[SLOT_COUNT] = {config.panChannel, config.tiltChannel, config.irisChannel,
+                                      config.zoomChannel, config.focusChannel};
+    const int values[SLOT_COUNT] = {panValue, tiltValue, config.irisValue, config.zoomValue, config.focusValue};
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        sample.dmxChannel[i] = static_cast<uint16_t>(std::max(0, channels[i]));
+        sample.dmxValue[i] = static_cast<uint8_t>(std::max(0, std::min(255, values[i])));
+    }
+    state.sharedMemory.publishPose(sample);
+    
+    // Preview frames cost a resize per frame, so only produce them while a reader is asking
+    int previewWidth = std::min(config.sharedMemoryPreviewWidth, static_cast<int>(SHM_PREVIEW_MAX_WIDTH));
+    if (previewWidth > 0 && frame.cols > 0 && frame.channels() == 3 && state.sharedMemory.previewRequested()) {
+        int previewHeight = std::min(frame.rows * previewWidth / frame.cols, static_cast<int>(SHM_PREVIEW_MAX_HEIGHT));
+        resize(frame, state.sharedPreview, Size(previewWidth, previewHeight), 0, 0, INTER_AREA);
+        if (state.sharedPreview.isContinuous()) {
+            state.sharedMemory.publishPreview(frameNumber, previewWidth, previewHeight, state.sharedPreview.data);
+        }
+    }
+}
+
+// Save the running config without losing edits to restart-only fields
+void saveRunningConfig(const FaceTrackerState& state) {
+    Config toSave = state.config;
+    for (const auto& field : configFields()) {
+        if (field.apply == APPLY_RESTART) {
+            copyConfigField(field, state.fileConfig, toSave);
+        }
+    }
+    saveConfig(toSave);
+}
+
+// Synthetic camera settings from the synthetic* config fields
+SyntheticSettings syntheticSettings(const Config& config) {
+    SyntheticSettings settings;
+    settings.motion = config.syntheticMotion;
+    settings.periodMs = config.syntheticPeriodMs;
+    settings.amplitude = config.syntheticAmplitude;
+    settings.faceImage = config.syntheticFaceImage;
+    settings.faceSize = config.syntheticFaceSize;
+    settings.noise = config.syntheticNoise;
+    settings.blur = config.syntheticBlur;
+    settings.lighting = config.syntheticLighting;
+    settings.lightDrift = config.syntheticLightDrift;
+    settings.realtime = config.syntheticRealtime;
+    settings.seed = static_cast<uint64_t>(config.syntheticSeed);
+    return settings;
+}
+
+// Open and configure a camera (blocking, can take seconds). `testFrame`, if given,
+// receives one frame grabbed before exposure is applied to check the pixel format.
+std::unique_ptr<VideoCapture> openConfiguredCamera(const Config& config, CameraFrame* testFrame = nullptr) {
+    std::unique_ptr<VideoCapture> cap;
+    if (config.captureBackend == "synthetic") {
+        // No fallback to a real camera: a test run must not silently track someone
+        auto synthetic = std::make_unique<SyntheticCapture>();
+        if (!synthetic->openSynthetic(syntheticSettings(config))) {
+            return std::unique_ptr<VideoCapture>();
+        }
+        cap = std::move(synthetic);
+    } else if (config.captureBackend == "v4l2") {
+        auto v4l2 = std::make_unique<V4l2Capture>();
+        if (v4l2->openDevice(config.cameraIndex, config.v4l2Buffers)) {
+            cap = std::move(v4l2);
+        } else {
+            logMessage(LOG_ERROR, LOG_CAPTURE, "Direct V4L2 capture unavailable, falling back to OpenCV capture");
+        }
+    }
+    if (!cap) {
+        cap = std::make_unique<VideoCapture>(config.cameraIndex);
+    }
+    if (!cap->isOpened()) {
+        return std::unique_ptr<VideoCapture>();
+    }
+    configureCameraFormat(*cap, config);
+    if (testFrame) {
+        testFrame->read(*cap);
+    }
+    applyCameraExposure(*cap, config);
+    return cap;
+}
+
+// Open a camera for a new cameraIndex on a worker thread (can take seconds); swapped in by trackFace()
+void startCameraReopen(FaceTrackerState& state) {
+    if (state.cameraReopen.valid()) {
+        return; // One at a time; trackFace() retries if the index moved on meanwhile
+    }
+    Config config = state.config;
+    state.cameraReopenIndex = config.cameraIndex;
+    logMessage(LOG_INFO, LOG_CAPTURE, "Opening camera %d in the background...", config.cameraIndex);
+    state.cameraReopen = std::async(std::launch::async, [config]() {
+        return openConfiguredCamera(config);
+    });
+}
+
+// Hand the logging fields to the log writer
+void applyLogConfig(const Config& config) {
+    setLogLevel(parseLogLevel(config.logLevel.c_str()));
+    setLogRateLimit(config.logRateLimit);
+}
+
+// Side effects of a live field change that was just copied into state.config
+void applyConfigFieldChange(FaceTrackerState& state, const ConfigField& field) {
+    if (field.apply == APPLY_CAMERA) {
+        state.cameraSettingsDirty = true;
+    } else if (field.apply == APPLY_CAMERA_REOPEN) {
+        if (std::strncmp(field.name, "synthetic", 9) != 0 || state.config.captureBackend == "synthetic") {
+            startCameraReopen(state);
+        }
+    } else if (std::strncmp(field.name, "log", 3) == 0) {
+        applyLogConfig(state.config);
+    } else if (std::strcmp(field.name, "traceEnabled") == 0) {
+        setTraceEnabled(state.config.traceEnabled, static_cast<size_t>(std::max(256, state.config.traceSpans)));
+    } else if (std::strcmp(field.name, "watchdogTimeoutMs") == 0) {
+        state.watchdog.setTimeout(state.config.watchdogTimeoutMs);
+    } else if (std::strcmp(field.name, "poseLogPath") == 0) {
+        state.poseLog.close();
+        if (!state.config.poseLogPath.empty()) {
+            state.poseLog.open(state.config.poseLogPath);
+        }
+    } else if (std::strncmp(field.name, "record", 6) == 0) {
+        restartRecorder(state);
+    }
+}
+
+// Keep the theatre trackbars in step with values edited elsewhere
+void syncTrackbarsToConfig(FaceTrackerState& state) {
+    state.brightnessSlider = std::max(0, std::min(100, static_cast<int>(state.config.brightness * 33.33f)));
+    state.contrastSlider = std::max(0, std::min(100, static_cast<int>(state.config.contrast * 33.33f)));
+}
+
+// Apply an edited config file between frames: only fields that actually changed are touched
+void applyConfigUpdate(FaceTrackerState& state, const json& j) {
+    Config next = state.config;
+    applyConfigJson(j, next);
+    state.fileConfig = state.config;
+    applyConfigJson(j, state.fileConfig);
+    
+    std::vector<const ConfigField*> changed = diffConfig(state.config, next);
+    if (changed.empty()) {
+        return;
+    }
+    
+    std::string applied;
+    std::string deferred;
+    for (const ConfigField* field : changed) {
+        std::string entry = std::string(field->name) + "=" + configFieldToString(*field, next);
+        if (field->apply == APPLY_RESTART) {
+            deferred += (deferred.empty() ? "" : ", ") + entry;
+            continue;
+        }
+        copyConfigField(*field, next, state.config);
+        applied += (applied.empty() ? "" : ", ") + entry;
+        applyConfigFieldChange(state, *field);
+    }
+    syncTrackbarsToConfig(state);
+    
+    if (!applied.empty()) {
+        logMessage(LOG_INFO, LOG_GENERAL, "Configuration updated: %s", applied.c_str());
+    }
+    if (!deferred.empty()) {
+        logMessage(LOG_INFO, LOG_GENERAL, "Configuration saved, applies after restart: %s", deferred.c_str());
+    }
+}
+
+// Apply queued OSC control changes (decoded on the listener thread) between frames.
+// Not logged: a fader sends dozens of messages per second.
+void applyControlUpdates(FaceTrackerState& state) {
+    ControlUpdate update;
+    bool changed = false;
+    while (state.control.poll(update)) {
+        const ConfigField& field = *update.field;
+        json value;
+        if (field.type == CONFIG_BOOL) {
+            value = update.number != 0.0;
+        } else if (field.type == CONFIG_INT) {
+            value = static_cast<int>(std::lround(update.number));
+        } else {
+            value = update.number;
         }
         
-        // Apply brightness/contrast adjustments (always apply to use trackbar values)
-        adjustBrightnessContrast(frame, adjusted, state.config.brightness, state.config.contrast);
-        frame = adjusted;
+        Config next = state.config;
+        if (!readConfigField(field, value, next) || configFieldEquals(field, state.config, next)) {
+            continue;
+        }
+        copyConfigField(field, next, state.config);
+        applyConfigFieldChange(state, field);
+        changed = true;
+    }
+    if (changed) {
+        syncTrackbarsToConfig(state);
+    }
+}
+
+// Begin tracking (daemon start/resume); `reset` starts again from the home position
+void beginTracking(FaceTrackerState& state, bool reset) {
+    if (reset) {
+        state.pose.reset();
+    }
+    state.output.keyframeSent = false; // Full refresh on the first send
+    state.mode = DAEMON_TRACKING;
+    state.startTime = std::chrono::steady_clock::now();
+    state.startEvent = "start command";
+    state.awaitingFirstFrame = true;
+}
+
+// Apply queued daemon commands between frames; returns false on shutdown
+bool applyDaemonCommands(FaceTrackerState& state) {
+    DaemonCommand command;
+    while (state.commands.poll(command)) {
+        switch (command.type) {
+            case DAEMON_START:
+                beginTracking(state, true);
+                break;
+            case DAEMON_RESUME:
+                beginTracking(state, state.mode == DAEMON_STANDBY);
+                break;
+            case DAEMON_PAUSE:
+                if (state.mode == DAEMON_TRACKING) {
+                    state.mode = DAEMON_PAUSED; // Output stops; fixtures hold their last position
+                }
+                break;
+            case DAEMON_STOP: {
+                state.mode = DAEMON_STANDBY;
+                int homePan = 0, homeTilt = 0;
+                mapToDmx(0.0f, 0.0f, state.config, homePan, homeTilt);
+                state.output.keyframeSent = false;
+                sendDmxValues(state.config, state.output, homePan, homeTilt);
+                break;
+            }
+            case DAEMON_RECONFIGURE:
+                applyConfigUpdate(state, command.config);
+                break;
+            case DAEMON_TRACE:
+                if (!traceEnabled()) {
+                    logMessage(LOG_WARN, LOG_GENERAL, "Trace requested but traceEnabled is off");
+                } else if (!requestTraceDump(state.config.tracePath)) {
+                    logMessage(LOG_WARN, LOG_GENERAL, "Trace dump already in progress");
+                }
+                continue; // Mode unchanged
+            case DAEMON_SHUTDOWN:
+                return false;
+        }
+        logMessage(LOG_INFO, LOG_GENERAL, "Daemon: %s", state.mode == DAEMON_TRACKING ? "tracking" :
+                                                        state.mode == DAEMON_PAUSED ? "paused" : "standby");
+    }
+    state.commands.setMode(state.mode);
+    return true;
+}
+
+// Swap in a camera opened by startCameraReopen() once it is ready (never blocks)
+void pollCameraReopen(std::unique_ptr<VideoCapture>& camera, FaceTrackerState& state) {
+    if (!state.cameraReopen.valid() ||
+        state.cameraReopen.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    
+    std::unique_ptr<VideoCapture> opened = state.cameraReopen.get();
+    if (opened) {
+        std::swap(camera, opened); // Old camera is released with `opened`
+        state.cap = camera.get();
+        state.cameraSettingsDirty = false; // Applied by the worker
+        logMessage(LOG_INFO, LOG_CAPTURE, "Switched to camera %d", state.cameraReopenIndex);
+    } else {
+        logMessage(LOG_ERROR, LOG_CAPTURE, "Error: Could not open camera %d, keeping current camera", state.cameraReopenIndex);
+    }
+    
+    // The index changed again while the worker was busy
+    if (state.cameraReopenIndex != state.config.cameraIndex) {
+        startCameraReopen(state);
+    }
+}
+
+// Open the OpenCV windows; their mouse/trackbar callbacks come back through applyPreviewEvents()
+void startPreviewWindows(FaceTrackerState& state) {
+    // Initialize button states
+    state.autoExposureSlider = state.config.autoExposure ? 1 : 0;
+    state.colorModeSlider = 1; // Default to color mode
+    
+    // Camera control trackbars on theatre window (descriptive labels)
+    std::vector<PreviewTrackbar> trackbars = {
+        {"Camera Brightness (0-100, multiplies image brightness)", PREVIEW_THEATRE_WINDOW,
+         state.brightnessSlider, state.brightnessSlider, 100, onBrightnessTrackbar},
+        {"Camera Contrast (0-100, multiplies image contrast)", PREVIEW_THEATRE_WINDOW,
+         state.contrastSlider, state.contrastSlider, 100, onContrastTrackbar},
+        {"Camera Exposure (0=dark, 100=bright, manual mode)", PREVIEW_THEATRE_WINDOW,
+         state.exposureSlider, state.exposureSlider, 100, onExposureTrackbar},
+    };
+    
+    // 3D viewport trackbars on 3D window (descriptive labels)
+    if (state.config.show3DVisualization) {
+        trackbars.push_back({"3D View Rotation X (up/down angle, 0-360)", PREVIEW_FIXTURE_WINDOW,
+                             state.viewAngleXSlider, 180, 360, onViewAngleXTrackbar});
+        trackbars.push_back({"3D View Rotation Y (left/right angle, 0-360)", PREVIEW_FIXTURE_WINDOW,
+                             state.viewAngleYSlider, 180, 360, onViewAngleYTrackbar});
+    }
+    
+    state.preview.start(state.config.previewFps, onMouse, trackbars);
+}
+
+// Replay window callbacks (queued on the render thread) between frames
+void applyPreviewEvents(FaceTrackerState& state) {
+    PreviewInputEvent event;
+    while (state.preview.poll(event)) {
+        event.dispatch(&state);
+    }
+}
+
+// Render the static theatre decoration for a camera frame size. Per frame the
+// tracker only copies this, drops the camera image into the stage area and
+// draws the live overlays.
+void buildTheatreBackdrop(TheatreBackdrop& backdrop, Size frameSize) {
+    int curtainWidth = THEATRE_CURTAIN_WIDTH;
+    int headerHeight = THEATRE_HEADER_HEIGHT;
+    int stageHeight = THEATRE_STAGE_HEIGHT;
+    
+    Mat& theatreFrame = backdrop.background;
+    theatreFrame = Mat::zeros(frameSize.height + headerHeight + stageHeight,
+                              frameSize.width + (curtainWidth * 2), CV_8UC3);
+    
+    // ArtBastard colors (BGR format)
+    Scalar curtainRed = Scalar(0, 0, 180);      // Deep red velvet
+    Scalar curtainAccent = Scalar(0, 0, 220);   // Lighter red
+    Scalar headerPurple = Scalar(236, 56, 131); // ArtBastard purple #8338ec
+    Scalar accentYellow = Scalar(42, 211, 255); // ArtBastard yellow #ffd32a
+    Scalar accentTeal = Scalar(165, 255, 6);    // ArtBastard teal #06ffa5
+    Scalar stageBrown = Scalar(25, 60, 120);    // Wooden stage
+    
+    // Curtains with folds (one column at a time; this only runs when the size changes)
+    int curtainBottom = headerHeight + frameSize.height + stageHeight;
+    for (int i = 0; i < curtainWidth; i++) {
+        Scalar leftColor = ((i / 20) % 2) ? curtainRed : curtainAccent;
+        rectangle(theatreFrame, Point(i, headerHeight), Point(i + 1, curtainBottom), leftColor, -1);
         
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
-        equalizeHist(gray, gray);
+        Scalar rightColor = (((curtainWidth - i) / 20) % 2) ? curtainRed : curtainAccent;
+        int x = frameSize.width + curtainWidth + i;
+        rectangle(theatreFrame, Point(x, headerHeight), Point(x + 1, curtainBottom), rightColor, -1);
+    }
+    // Curtain tassels/fringe at bottom
+    for (int i = 0; i < curtainWidth; i += 5) {
+        line(theatreFrame, Point(i, curtainBottom), Point(i, curtainBottom + 10), curtainAccent, 2);
+        int x = frameSize.width + curtainWidth + i;
+        line(theatreFrame, Point(x, curtainBottom), Point(x, curtainBottom + 10), curtainAccent, 2);
+    }
+    
+    // Theatrical header (top backdrop) with decorative border
+    rectangle(theatreFrame, Point(0, 0), Point(theatreFrame.cols, headerHeight), headerPurple, -1);
+    rectangle(theatreFrame, Point(0, 0), Point(theatreFrame.cols, headerHeight), accentYellow, 3);
+    
+    // "ArtBastard Puppet Theatre" title (top, larger, white)
+    std::string title = "ArtBastard Puppet Theatre";
+    int baseline = 0;
+    Size titleSize = getTextSize(title, FONT_HERSHEY_DUPLEX, 0.9, 2, &baseline);
+    Point titlePos((theatreFrame.cols - titleSize.width) / 2, 35);
+    putText(theatreFrame, title, titlePos, FONT_HERSHEY_DUPLEX, 0.9, Scalar(255, 255, 255), 2);
+    
+    // "Le Theatre des Marionnettes" subtitle (below title, smaller, teal)
+    std::string subtitle = "* Le Theatre des Marionnettes *";
+    Size subtitleSize = getTextSize(subtitle, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
+    Point subtitlePos((theatreFrame.cols - subtitleSize.width) / 2, 52);
+    putText(theatreFrame, subtitle, subtitlePos, FONT_HERSHEY_SIMPLEX, 0.4, accentTeal, 1);
+    
+    // Decorative spotlight arcs: drawn on the backdrop (where they cross the header)
+    // and kept as a masked layer for the part that lies over the camera image
+    backdrop.spotlights = Mat::zeros(theatreFrame.size(), CV_8UC3);
+    for (int i = 0; i < 3; i++) {
+        int x = curtainWidth + (frameSize.width / 4) * (i + 1);
+        for (Mat* target : {&theatreFrame, &backdrop.spotlights}) {
+            ellipse(*target, Point(x, headerHeight + 20), Size(150, 80), 0, 180, 360,
+                   Scalar(255, 211, 42), 1, LINE_AA); // Yellow glow
+            ellipse(*target, Point(x, headerHeight + 20), Size(120, 60), 0, 180, 360,
+                   Scalar(165, 255, 6), 1, LINE_AA); // Teal glow
+        }
+    }
+    Rect stageRect(curtainWidth, headerHeight, frameSize.width, frameSize.height);
+    Mat spotlightGray;
+    cvtColor(backdrop.spotlights(stageRect), spotlightGray, COLOR_BGR2GRAY);
+    backdrop.spotlightMask = spotlightGray > 0;
+    
+    // Stage floor with wooden planks
+    Rect stageFloorRect(0, headerHeight + frameSize.height, theatreFrame.cols, stageHeight);
+    rectangle(theatreFrame, stageFloorRect, stageBrown, -1);
+    for (int i = 0; i < theatreFrame.cols; i += 20) {
+        line(theatreFrame, Point(i, headerHeight + frameSize.height),
+             Point(i, headerHeight + frameSize.height + stageHeight),
+             Scalar(15, 40, 80), 1);
+    }
+    
+    backdrop.frameSize = frameSize;
+}
+
+// Main tracking loop
+void trackFace(std::unique_ptr<VideoCapture>& camera, FaceTrackerState& state) {
+    Mat frame, gray, adjusted;
+    CameraFrame cameraFrame;         // BGR, or raw YUV/MJPEG when captureFormat asks for it
+    JpegDecodePool jpegDecoder;      // MJPEG frames decode here (started by the first one)
+    DecodedJpegFrame decodedFrame;   // MJPEG frame being tracked
+    FramePreprocessor preprocessor;  // Cached brightness/contrast table
+    Mat displayGray;                 // Preview buffer, reused across frames
+    PreviewSnapshot previewSnapshot; // Theatre is composed into this; submit() swaps in older buffers
+    std::vector<Rect> faces;
+    std::vector<std::vector<Point2f>> shapes;
+    FrameRecordInfo recordInfo;      // Reused so recording does not allocate per frame
+    
+    int frameCount = 0;
+    
+    // OpenCV windows live on their own render thread (showPreview/previewWindows only apply at startup)
+    if (state.config.showPreview && state.config.previewWindows) {
+        startPreviewWindows(state);
+    }
+    
+    auto lastUpdate = std::chrono::steady_clock::now();
+    auto lastStatsPrint = lastUpdate;
+    
+    while (true) {
+        // Config edits (parsed on the watcher thread) take effect between frames
+        json configUpdate;
+        if (state.configWatcher.takeUpdate(configUpdate)) {
+            applyConfigUpdate(state, configUpdate);
+        }
+        if (state.control.isRunning()) {
+            applyControlUpdates(state);
+        }
+        if (state.preview.isRunning()) {
+            applyPreviewEvents(state);
+            
+            // If main theatre window is closed, exit application
+            if (state.preview.theatreClosed()) {
+                saveRunningConfig(state);
+                logMessage(LOG_INFO, LOG_GENERAL, "Theatre window closed. Settings saved.");
+                break;
+            }
+            
+            // If 3D window is closed, disable 3D visualization
+            if (state.preview.fixtureClosed()) {
+                state.config.show3DVisualization = false;
+            }
+            state.preview.setFps(state.config.previewFps);
+        }
+        if (state.commands.isRunning() && !applyDaemonCommands(state)) {
+            logMessage(LOG_INFO, LOG_GENERAL, "Daemon: shutdown requested");
+            break;
+        }
+        pollCameraReopen(camera, state);
+        VideoCapture& cap = *camera; // Either backend (OpenCV or V4L2) behind the same interface
+        
+        // Daemon standby/pause: models stay loaded; the camera keeps streaming (cheap grab,
+        // no decode) unless daemonKeepCameraOpen is off, so resuming costs one frame
+        if (state.mode != DAEMON_TRACKING) {
+            if (state.config.daemonKeepCameraOpen && cap.isOpened()) {
+                cap.grab();
+            } else {
+                if (cap.isOpened()) {
+                    cap.release();
+                    logMessage(LOG_INFO, LOG_CAPTURE, "Camera released while idle");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            jpegDecoder.clear(); // Resume with fresh frames
+            state.preview.pump();
+            watchdogHeartbeat(state); // Idle on purpose: output is meant to stop
+            continue;
+        }
+        if (!cap.isOpened()) {
+            // Released while idle (or an earlier reopen failed): open again in the background
+            auto now = std::chrono::steady_clock::now();
+            if (!state.cameraReopen.valid() && now >= state.cameraRetryTime) {
+                startCameraReopen(state);
+                state.cameraRetryTime = now + std::chrono::seconds(1);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        
+        bool timed = stageTimingEnabled(state);
+        int64_t frameStartUs = timed ? static_cast<int64_t>(shmNowUs()) : 0;
+        int64_t stageStartUs = frameStartUs;
+        
+        if (!cameraFrame.read(cap)) {
+            state.metrics.captureFailures.fetch_add(1, std::memory_order_relaxed);
+            // Camera unplugged or wedged: reopen it (the watchdog covers the fixtures meanwhile)
+            logMessage(LOG_ERROR, LOG_CAPTURE, "Failed to capture frame, reopening the camera");
+            jpegDecoder.clear();
+            cap.release();
+            continue;
+        }
+        state.metrics.framesCaptured.fetch_add(1, std::memory_order_relaxed);
+        state.frameNumber = frameCount;
+        if (timed) {
+            stageStartUs = observeStage(state, STAGE_GRAB, stageStartUs);
+        }
+        
+        if (state.config.useStream) {
+            state.output.stream.setSocketPath(state.config.streamSocketPath);
+        }
+        
+        // The theatre is only composed when a preview frame is due (windows or MJPEG)
+        bool previewDue = state.preview.wantsSnapshot();
+        bool composeTheatre = state.config.showPreview && (previewDue || state.mjpeg.wantsFrame());
+        state.preview.pump();
+        
+        bool sharedPreview = state.sharedMemory.isOpen() && state.config.sharedMemoryPreviewWidth > 0 &&
+                             state.sharedMemory.previewRequested();
+        int64_t frameTimestampUs = cameraFrame.timestampUs();
+        int detectScale = 1; // gray is 1/detectScale of the camera frame (MJPEG reduced decode)
+        
+        // Brightness/contrast (trackbar values), grayscale and equalization in one fused pass
+        if (cameraFrame.format() == CAPTURE_MJPEG) {
+            // Compressed frames decode on the worker pool while earlier ones are tracked
+            if (!jpegDecoder.isRunning()) {
+                jpegDecoder.start(state.config.captureDecodeThreads);
+                logMessage(LOG_INFO, LOG_CAPTURE, "MJPEG capture: decoding on %d threads, detection at 1/%d size",
+                           jpegDecoder.threadCount(), state.config.captureDecodeScale);
+            }
+            bool wantFull = composeTheatre || sharedPreview || (state.faceDetected && state.facemark);
+            jpegDecoder.submit(cameraFrame.jpeg(), cameraFrame.timestampUs(), state.config.captureDecodeScale, wantFull);
+            if (!jpegDecoder.next(decodedFrame)) {
+                continue; // Pipeline filling: grab the next frame while this one decodes
+            }
+            if (!decodedFrame.ok) {
+                continue; // Corrupt JPEG (USB bandwidth hiccup), counted by the pool
+            }
+            if (decodedFrame.full.empty()) {
+                // Full size was not wanted when this frame was captured; the preview waits for one that has it
+                previewDue = false;
+                composeTheatre = false;
+            }
+            frameTimestampUs = decodedFrame.timestampUs;
+            detectScale = decodedFrame.scale;
+            preprocessor.process(decodedFrame.gray, state.config.brightness, state.config.contrast, adjusted, gray);
+            frame = adjusted; // Replaced by the full-size image after detection if one is needed
+        } else if (cameraFrame.isRaw()) {
+            // The Y plane already is the gray image; color is only converted for a preview
+            preprocessor.process(cameraFrame.luma(), state.config.brightness, state.config.contrast, adjusted, gray);
+            if (composeTheatre || sharedPreview) {
+                preprocessor.adjust(cameraFrame.bgr(), state.config.brightness, state.config.contrast, frame);
+            } else {
+                frame = adjusted;
+            }
+        } else {
+            preprocessor.process(cameraFrame.bgr(), state.config.brightness, state.config.contrast, adjusted, gray);
+            frame = adjusted;
+        }
+        
+        if (timed) {
+            stageStartUs = observeStage(state, STAGE_PREPROCESS, stageStartUs);
+        }
         
         // Detect faces
-        state.faceCascade->detectMultiScale(gray, faces, 1.1, 3, 0, Size(50, 50));
+        state.faceCascade->detectMultiScale(gray, faces, 1.1, 3, 0, Size(50 / detectScale, 50 / detectScale));
+        
+        if (cameraFrame.format() == CAPTURE_MJPEG) {
+            // Full size only when it is looked at: a preview, or landmarks on a detected face
+            if (decodedFrame.full.empty() && !faces.empty() && state.facemark) {
+                decodedFrame.full = JpegDecodePool::decodeFull(decodedFrame);
+            }
+            if (!decodedFrame.full.empty()) {
+                preprocessor.adjust(decodedFrame.full, state.config.brightness, state.config.contrast, frame);
+                double scaleX = static_cast<double>(frame.cols) / gray.cols;
+                double scaleY = static_cast<double>(frame.rows) / gray.rows;
+                for (Rect& face : faces) {
+                    face = Rect(cvRound(face.x * scaleX), cvRound(face.y * scaleY),
+                                cvRound(face.width * scaleX), cvRound(face.height * scaleY));
+                }
+            }
+        }
+        if (timed) {
+            observeStage(state, STAGE_DETECT, stageStartUs);
+        }
+        state.metrics.framesProcessed.fetch_add(1, std::memory_order_relaxed);
+        uint8_t poseFlags = 0; // SHM_POSE_* bits for the shared memory ring
+        
+        if (state.awaitingFirstFrame) {
+            auto firstFrameMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - state.startTime);
+            logMessage(LOG_INFO, LOG_GENERAL, "First frame tracked %lld ms after %s",
+                       static_cast<long long>(firstFrameMs.count()), state.startEvent);
+            state.awaitingFirstFrame = false;
+        }
+        
+        // Drawn on the preview only after recording (see below)
+        Rect faceRect;
+        std::vector<Point2f> landmarks;
         
         if (faces.size() > 0) {
             state.faceDetected = true;
-            Rect faceRect = faces[0]; // Use first detected face
+            state.metrics.framesWithFace.fetch_add(1, std::memory_order_relaxed);
+            faceRect = faces[0]; // Use first detected face
             
             // Detect facial landmarks
-            std::vector<Point2f> landmarks;
             bool landmarksDetected = false;
             
 #ifdef HAVE_OPENCV_FACE
             if (state.facemark && state.facemark.get()) {
                 std::vector<std::vector<Point2f>> shapes;
-                if (state.facemark->fit(frame, faces, shapes)) {
+                int64_t fitStartUs = timed ? static_cast<int64_t>(shmNowUs()) : 0;
+                bool fitted = state.facemark->fit(frame, faces, shapes);
+                state.metrics.landmarkFits.fetch_add(1, std::memory_order_relaxed);
+                if (timed) {
+                    observeStage(state, STAGE_LANDMARKS, fitStartUs);
+                }
+                if (fitted) {
                     if (shapes.size() > 0 && shapes[0].size() >= 68) {
                         landmarks = shapes[0];
                         state.landmarks = landmarks;
                         landmarksDetected = true;
+                        state.metrics.landmarkFitsOk.fetch_add(1, std::memory_order_relaxed);
                         
                         // Estimate head pose
                         float pan = 0.0f, tilt = 0.0f;
                         estimateHeadPose(landmarks, frame.size(), pan, tilt);
-                    
-                    // Apply smoothing
-                    // Improved smoothing with velocity limiting
-                    smoothWithVelocity(state.smoothedPan, pan, state.panVelocity, 
-                                      state.config.smoothingFactor, state.config.maxVelocity / 127.0f);
-                    smoothWithVelocity(state.smoothedTilt, tilt, state.tiltVelocity, 
-                                      state.config.smoothingFactor, state.config.maxVelocity / 127.0f);
-                    
-                    // Add to gesture history
-                    state.panHistory.push_back(state.smoothedPan);
-                    state.tiltHistory.push_back(state.smoothedTilt);
-                    
-                    // Keep history size limited
-                    if (state.panHistory.size() > state.gestureHistorySize) {
-                        state.panHistory.erase(state.panHistory.begin());
-                    }
-                    if (state.tiltHistory.size() > state.gestureHistorySize) {
-                        state.tiltHistory.erase(state.tiltHistory.begin());
-                    }
-                    
-                    // Detect gestures
-                    if (state.gestureCooldown > 0) {
-                        state.gestureCooldown--;
-                    }
-                    
-                    std::string gesture = "";
-                    if (state.gestureCooldown == 0 && state.panHistory.size() >= 10) {
-                        gesture = detectGesture(state.panHistory, state.tiltHistory, state.smoothedPan, state.smoothedTilt);
-                        
-                        if (!gesture.empty() && gesture != state.lastGesture) {
-                            std::cout << "Gesture detected: " << gesture << std::endl;
-                            state.lastGesture = gesture;
-                            state.gestureCooldown = 30; // Cooldown to prevent duplicate detections
-                        }
-                    }
-                    
-                    // Map to DMX values
-                    int panValue, tiltValue;
-                    mapToDmx(state.smoothedPan, state.smoothedTilt, state.config, panValue, tiltValue);
-                    
-                    // Send DMX update at configured rate
-                    auto now = std::chrono::steady_clock::now();
-                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate).count();
-                    int updateInterval = 1000 / state.config.updateRate;
-                    
-                    if (elapsed >= updateInterval) {
-                        sendDmxValues(state.config, panValue, tiltValue);
-                        lastUpdate = now;
-                        
-                        if (!gesture.empty()) {
-                            std::cout << "Face tracked - Pan: " << panValue << ", Tilt: " << tiltValue 
-                                      << " | Gesture: " << gesture << std::endl;
-                        } else {
-                            std::cout << "Face tracked - Pan: " << panValue << ", Tilt: " << tiltValue 
-                                      << " (raw: " << state.smoothedPan << ", " << state.smoothedTilt << ")" << std::endl;
-                        }
-                    }
-                    
-                    // Draw landmarks on preview (bright yellow/orange)
-                    if (state.config.showPreview) {
-                        for (const auto& point : landmarks) {
-                            circle(frame, point, 3, Scalar(0, 255, 255), -1); // Bright yellow (BGR)
-                        }
-                        // Draw face rectangle (bright orange)
-                        rectangle(frame, faceRect, Scalar(0, 165, 255), 3); // Bright orange (BGR)
-                        // Pan/tilt values moved to theatre overlay, not on preview frame
+                        updateTrackedPose(state, pan, tilt, true, lastUpdate);
+                        poseFlags = SHM_POSE_FACE | SHM_POSE_LANDMARKS;
                     }
                 }
             }
@@ -2006,199 +2036,106 @@ void trackFace(VideoCapture& cap, FaceTrackerState& state) {
             if (!landmarksDetected) {
                 // Face detected but landmarks failed - use face center for basic tracking
                 state.faceDetected = true;
-                Point2f faceCenter(faceRect.x + faceRect.width / 2.0f, faceRect.y + faceRect.height / 2.0f);
-                Point2f imageCenter(frame.size().width / 2.0f, frame.size().height / 2.0f);
-                
-                float pan = (faceCenter.x - imageCenter.x) / imageCenter.x;
-                float tilt = (faceCenter.y - imageCenter.y) / imageCenter.y;
-                
-                // Improved smoothing with velocity limiting
-                smoothWithVelocity(state.smoothedPan, pan, state.panVelocity, 
-                                  state.config.smoothingFactor, state.config.maxVelocity / 127.0f);
-                smoothWithVelocity(state.smoothedTilt, tilt, state.tiltVelocity, 
-                                  state.config.smoothingFactor, state.config.maxVelocity / 127.0f);
-                
-                // Add to gesture history
-                state.panHistory.push_back(state.smoothedPan);
-                state.tiltHistory.push_back(state.smoothedTilt);
-                
-                // Keep history size limited
-                if (state.panHistory.size() > state.gestureHistorySize) {
-                    state.panHistory.erase(state.panHistory.begin());
-                }
-                if (state.tiltHistory.size() > state.gestureHistorySize) {
-                    state.tiltHistory.erase(state.tiltHistory.begin());
-                }
-                
-                // Detect gestures
-                if (state.gestureCooldown > 0) {
-                    state.gestureCooldown--;
-                }
-                
-                std::string gesture = "";
-                if (state.gestureCooldown == 0 && state.panHistory.size() >= 10) {
-                    gesture = detectGesture(state.panHistory, state.tiltHistory, state.smoothedPan, state.smoothedTilt);
-                    
-                    if (!gesture.empty() && gesture != state.lastGesture) {
-                        std::cout << "Gesture detected: " << gesture << std::endl;
-                        state.lastGesture = gesture;
-                        state.gestureCooldown = 30; // Cooldown to prevent duplicate detections
-                    }
-                }
-                
-                int panValue, tiltValue;
-                mapToDmx(state.smoothedPan, state.smoothedTilt, state.config, panValue, tiltValue);
-                
-                auto now = std::chrono::steady_clock::now();
-                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate).count();
-                int updateInterval = 1000 / state.config.updateRate;
-                
-                if (elapsed >= updateInterval) {
-                    sendDmxValues(state.config, panValue, tiltValue);
-                    lastUpdate = now;
-                    
-                    if (!gesture.empty()) {
-                        std::cout << "Face tracked - Pan: " << panValue << ", Tilt: " << tiltValue 
-                                  << " | Gesture: " << gesture << std::endl;
-                    }
-                }
-                
-                if (state.config.showPreview) {
-                    // Draw face rectangle (bright orange)
-                    rectangle(frame, faceRect, Scalar(0, 165, 255), 3); // Bright orange (BGR)
-                    circle(frame, faceCenter, 6, Scalar(0, 255, 255), -1); // Bright yellow (BGR)
-                    // Pan/tilt values moved to theatre overlay, not on preview frame
-                }
+                float pan = 0.0f, tilt = 0.0f;
+                faceCenterPose(faceRect, frame.size(), pan, tilt);
+                updateTrackedPose(state, pan, tilt, false, lastUpdate);
+                poseFlags = SHM_POSE_FACE;
             }
         } else {
             state.faceDetected = false;
             // "No face detected" text moved to theatre overlay, not on preview frame
+            if (state.config.useStream) {
+                int panValue, tiltValue;
+                mapToDmx(state.pose.smoothedPan, state.pose.smoothedTilt, state.config, panValue, tiltValue);
+                state.output.stream.sendPose(state.pose.smoothedPan, state.pose.smoothedTilt,
+                                             state.pose.smoothedPan, state.pose.smoothedTilt, panValue, tiltValue, 0);
+            }
+        }
+        
+        // Exact with the v4l2 backend (kernel capture timestamp, same clock as shmNowUs)
+        int64_t captureLatencyUs = static_cast<int64_t>(shmNowUs()) - frameTimestampUs;
+        if (captureLatencyUs >= 0) {
+            state.captureLatency.add(captureLatencyUs);
+        }
+        if (state.metricsServer.isRunning()) {
+            state.metrics.stages[STAGE_FRAME].observeUs(static_cast<int64_t>(shmNowUs()) - frameStartUs);
+            if (captureLatencyUs >= 0) {
+                state.metrics.captureToPose.observeUs(captureLatencyUs);
+            }
+            publishMetrics(state, cap, jpegDecoder);
+        }
+        if (state.recorder.isOpen()) {
+            recordCameraFrame(state, cap, cameraFrame, decodedFrame, faces, poseFlags, frameTimestampUs, recordInfo);
+        }
+        
+        // Overlays only now: at identity brightness/contrast `frame` shares the camera
+        // buffer the recorder just copied, so drawing earlier would record them
+        if (state.config.showPreview && (poseFlags & SHM_POSE_FACE)) {
+            drawFaceOverlay(frame, faceRect, landmarks);
+        }
+        watchdogHeartbeat(state);
+        if (const SyntheticCapture* synthetic = dynamic_cast<const SyntheticCapture*>(&cap)) {
+            if (recordSyntheticFrame(state, *synthetic, captureLatencyUs)) {
+                logMessage(LOG_INFO, LOG_GENERAL, "Synthetic run complete (%d frames)", state.config.syntheticFrames);
+                break;
+            }
+        }
+        
+        // Publish before drawing the theatre so readers get the freshest pose
+        if (state.sharedMemory.isOpen()) {
+            publishSharedState(state, frame, frameCount, poseFlags);
+        }
+        
+        // Queued exposure/brightness changes go to the camera once this frame's pose is out:
+        // a UVC control transfer can take tens of ms. Still on this thread, because
+        // VideoCapture::set() is not safe while another thread is in read()
+        if (state.cameraSettingsDirty) {
+            applyCameraExposure(cap, state.config);
+            state.cameraSettingsDirty = false;
         }
         
         // Check quit flag
         if (!state.config.showPreview) {
-            saveConfig(state.config);
-            std::cout << "Application exiting. Settings saved." << std::endl;
+            saveRunningConfig(state);
+            logMessage(LOG_INFO, LOG_GENERAL, "Application exiting. Settings saved.");
             break;
         }
         
-        if (state.config.showPreview) {
-            // Determine which frame to show based on color mode
-            // Force color format - ensure frame is BGR (3 channels)
-            Mat displayFrame;
-            if (frame.channels() == 1) {
-                // Camera is outputting grayscale - convert to BGR
-                cvtColor(frame, displayFrame, COLOR_GRAY2BGR);
-                std::cout << "Warning: Camera is outputting grayscale. Forcing color conversion." << std::endl;
-            } else if (frame.channels() == 3) {
-                // Frame is already color (BGR)
-                displayFrame = frame.clone();
-            } else {
-                // Unexpected format - try to clone anyway
-                displayFrame = frame.clone();
-                std::cout << "Warning: Unexpected frame format (" << frame.channels() << " channels)" << std::endl;
-            }
-            
-            // Apply color/grayscale mode toggle (only for display, not camera)
-            if (state.colorModeSlider == 0) {
-                // Grayscale mode - convert to grayscale for display only
-                Mat gray;
-                cvtColor(displayFrame, gray, COLOR_BGR2GRAY);
-                cvtColor(gray, displayFrame, COLOR_GRAY2BGR); // Convert back to BGR for drawing
+        int64_t composeStartUs = traceEnabled() ? traceNowUs() : 0;
+        if (composeTheatre) {
+            // Static decoration comes from the cached backdrop (rebuilt only when the camera size changes)
+            int curtainWidth = THEATRE_CURTAIN_WIDTH;
+            int headerHeight = THEATRE_HEADER_HEIGHT;
+            int stageHeight = THEATRE_STAGE_HEIGHT;
+            if (state.theatreBackdrop.frameSize != frame.size()) {
+                buildTheatreBackdrop(state.theatreBackdrop, frame.size());
             }
-            // When colorModeSlider == 1, we keep displayFrame as color
-            
-            // Create theatrical backdrop with curtains
-            int curtainWidth = 80; // Width of each curtain
-            int headerHeight = 60; // Height of theatrical header
-            int stageHeight = 40;  // Height of stage floor
-            
-            // Create larger frame with theatre backdrop
-            Mat theatreFrame = Mat::zeros(displayFrame.rows + headerHeight + stageHeight, 
-                                         displayFrame.cols + (curtainWidth * 2), CV_8UC3);
+            Mat& theatreFrame = previewSnapshot.theatre;
+            state.theatreBackdrop.background.copyTo(theatreFrame); // Reuses the buffer
+            state.theatreSize = theatreFrame.size();
             
-            // ArtBastard colors (BGR format)
-            Scalar curtainRed = Scalar(0, 0, 180);      // Deep red velvet
-            Scalar curtainAccent = Scalar(0, 0, 220);   // Lighter red
-            Scalar headerPurple = Scalar(236, 56, 131); // ArtBastard purple #8338ec
             Scalar accentYellow = Scalar(42, 211, 255); // ArtBastard yellow #ffd32a
             Scalar accentTeal = Scalar(165, 255, 6);    // ArtBastard teal #06ffa5
-            Scalar stageBrown = Scalar(25, 60, 120);    // Wooden stage
-            
-            // Draw left curtain with folds
-            for (int i = 0; i < curtainWidth; i++) {
-                int foldPos = (i / 20) % 2; // Create fold pattern
-                int x = i;
-                Scalar color = foldPos ? curtainRed : curtainAccent;
-                rectangle(theatreFrame, Point(x, headerHeight), 
-                        Point(x + 1, headerHeight + displayFrame.rows + stageHeight), color, -1);
-            }
-            // Draw curtain tassels/fringe at bottom
-            for (int i = 0; i < curtainWidth; i += 5) {
-                line(theatreFrame, Point(i, headerHeight + displayFrame.rows + stageHeight),
-                     Point(i, headerHeight + displayFrame.rows + stageHeight + 10), curtainAccent, 2);
-            }
-            
-            // Draw right curtain with folds
-            for (int i = 0; i < curtainWidth; i++) {
-                int foldPos = ((curtainWidth - i) / 20) % 2;
-                int x = displayFrame.cols + curtainWidth + i;
-                Scalar color = foldPos ? curtainRed : curtainAccent;
-                rectangle(theatreFrame, Point(x, headerHeight), 
-                        Point(x + 1, headerHeight + displayFrame.rows + stageHeight), color, -1);
-            }
-            // Draw curtain tassels/fringe at bottom
-            for (int i = 0; i < curtainWidth; i += 5) {
-                int x = displayFrame.cols + curtainWidth + i;
-                line(theatreFrame, Point(x, headerHeight + displayFrame.rows + stageHeight),
-                     Point(x, headerHeight + displayFrame.rows + stageHeight + 10), curtainAccent, 2);
-            }
-            
-            // Draw theatrical header (top backdrop)
-            rectangle(theatreFrame, Point(0, 0), 
-                     Point(theatreFrame.cols, headerHeight), headerPurple, -1);
-            
-            // Draw decorative border on header
-            rectangle(theatreFrame, Point(0, 0), 
-                     Point(theatreFrame.cols, headerHeight), accentYellow, 3);
-            
-            // Draw "ArtBastard Puppet Theatre" title (top, larger, white)
-            std::string title = "ArtBastard Puppet Theatre";
             int baseline = 0;
-            Size titleSize = getTextSize(title, FONT_HERSHEY_DUPLEX, 0.9, 2, &baseline);
-            Point titlePos((theatreFrame.cols - titleSize.width) / 2, 35);
-            putText(theatreFrame, title, titlePos, FONT_HERSHEY_DUPLEX, 0.9, Scalar(255, 255, 255), 2);
-            
-            // Draw "Le Theatre des Marionnettes" subtitle (below title, smaller, teal, with spacing)
-            std::string subtitle = "* Le Theatre des Marionnettes *";
-            Size subtitleSize = getTextSize(subtitle, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
-            Point subtitlePos((theatreFrame.cols - subtitleSize.width) / 2, 52);
-            putText(theatreFrame, subtitle, subtitlePos, FONT_HERSHEY_SIMPLEX, 0.4, accentTeal, 1);
             
-            // Place camera preview in center (stage)
-            Rect stageRect(curtainWidth, headerHeight, displayFrame.cols, displayFrame.rows);
-            displayFrame.copyTo(theatreFrame(stageRect));
-            
-            // Draw decorative spotlight effects on preview
-            for (int i = 0; i < 3; i++) {
-                int x = curtainWidth + (displayFrame.cols / 4) * (i + 1);
-                ellipse(theatreFrame, Point(x, headerHeight + 20), Size(150, 80), 0, 180, 360,
-                       Scalar(255, 211, 42), 1, LINE_AA); // Yellow glow
-                ellipse(theatreFrame, Point(x, headerHeight + 20), Size(120, 60), 0, 180, 360,
-                       Scalar(165, 255, 6), 1, LINE_AA); // Teal glow
-            }
-            
-            // Draw stage floor
-            Rect stageFloorRect(0, headerHeight + displayFrame.rows, 
-                               theatreFrame.cols, stageHeight);
-            rectangle(theatreFrame, stageFloorRect, stageBrown, -1);
-            
-            // Draw wooden planks on stage
-            for (int i = 0; i < theatreFrame.cols; i += 20) {
-                line(theatreFrame, Point(i, headerHeight + displayFrame.rows),
-                     Point(i, headerHeight + displayFrame.rows + stageHeight),
-                     Scalar(15, 40, 80), 1);
+            // Place camera preview in center (stage), converted straight into the theatre buffer
+            Rect stageRect(curtainWidth, headerHeight, frame.cols, frame.rows);
+            Mat stage = theatreFrame(stageRect);
+            if (frame.channels() == 1) {
+                // Camera is outputting grayscale - convert to BGR
+                cvtColor(frame, stage, COLOR_GRAY2BGR);
+                logMessage(LOG_WARN, LOG_CAPTURE, "Warning: Camera is outputting grayscale. Forcing color conversion.");
+            } else if (state.colorModeSlider == 0) {
+                // Grayscale mode - for display only, not camera
+                cvtColor(frame, displayGray, COLOR_BGR2GRAY);
+                cvtColor(displayGray, stage, COLOR_GRAY2BGR);
+            } else if (frame.channels() == 3) {
+                frame.copyTo(stage);
+            } else {
+                cvtColor(frame, stage, COLOR_BGRA2BGR);
+                logMessage(LOG_WARN, LOG_CAPTURE, "Warning: Unexpected frame format (%d channels)", frame.channels());
             }
+            state.theatreBackdrop.spotlights(stageRect).copyTo(stage, state.theatreBackdrop.spotlightMask);
             
             // Draw control buttons on stage floor (make sure they're visible!)
             int buttonWidth = 150;
@@ -2208,7 +2145,7 @@ void trackFace(VideoCapture& cap, FaceTrackerState& state) {
             int totalButtonWidth = numButtons * buttonWidth + (numButtons - 1) * buttonSpacing;
             int startX = (theatreFrame.cols - totalButtonWidth) / 2;
             // Ensure buttons are centered vertically in stage floor area
-            int buttonY = headerHeight + displayFrame.rows + (stageHeight - buttonHeight) / 2;
+            int buttonY = headerHeight + frame.rows + (stageHeight - buttonHeight) / 2;
             
             // Helper to draw theatrical button
             auto drawTheatreButton = [&](int x, int y, const std::string& text, bool active) {
@@ -2270,7 +2207,7 @@ void trackFace(VideoCapture& cap, FaceTrackerState& state) {
             if (state.faceDetected) {
                 // Get pan/tilt values from the last frame
                 int panValue, tiltValue;
-                mapToDmx(state.smoothedPan, state.smoothedTilt, state.config, panValue, tiltValue);
+                mapToDmx(state.pose.smoothedPan, state.pose.smoothedTilt, state.config, panValue, tiltValue);
                 
                 std::string panTiltText = "Pan: " + std::to_string(panValue) + " Tilt: " + std::to_string(tiltValue);
                 Size panTiltSize = getTextSize(panTiltText, FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseline);
@@ -2295,8 +2232,8 @@ void trackFace(VideoCapture& cap, FaceTrackerState& state) {
                        FONT_HERSHEY_SIMPLEX, 0.6, Scalar(100, 255, 100), 2); // Bright green text
                 
                 // Display gesture if detected (bright orange/yellow)
-                if (!state.lastGesture.empty()) {
-                    std::string gestureText = "Gesture: " + state.lastGesture;
+                if (!state.pose.lastGesture.empty()) {
+                    std::string gestureText = "Gesture: " + state.pose.lastGesture;
                     Size gestureSize = getTextSize(gestureText, FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseline);
                     // Bright background for gesture
                     rectangle(theatreFrame,
@@ -2320,169 +2257,176 @@ void trackFace(VideoCapture& cap, FaceTrackerState& state) {
                        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(180, 180, 180), 2); // Light gray text
             }
             
-            // Store frame for mouse callback (update dimensions for theatre frame)
-            state.lastDisplayFrame = theatreFrame.clone();
-            
-            // Show Theatre window (separate window)
-            imshow("ArtBastard Puppet Theatre", theatreFrame);
-            
-            // Show 3D Visualization window (SEPARATE RESIZABLE WINDOW - always shown)
-            int vizWidth = 800;
-            int vizHeight = 600;
-            Mat vizCanvas(vizHeight, vizWidth, CV_8UC3, Scalar(20, 20, 40));
-            
-            if (state.config.show3DVisualization) {
-                // Auto-orbit logic
-                if (state.autoOrbit) {
-                    state.viewAngleY += state.autoOrbitSpeed;
-                    if (state.viewAngleY > 360) state.viewAngleY -= 360;
-                    if (state.viewAngleY < -360) state.viewAngleY += 360;
-                }
-                
-                int panValue, tiltValue;
-                mapToDmx(state.smoothedPan, state.smoothedTilt, state.config, panValue, tiltValue);
-                
-                render3DFixture(vizCanvas, state.smoothedPan, state.smoothedTilt, panValue, tiltValue,
-                               state.viewAngleX, state.viewAngleY, state.viewDistance, state.showXYZLattice);
-                
-                // Add title
-                putText(vizCanvas, "3D Fixture Visualization", 
-                       Point(10, 25), FONT_HERSHEY_SIMPLEX, 0.6, Scalar(255, 255, 255), 2);
-                
-                // Display DMX values at bottom
-                std::string dmxText = "Pan: " + std::to_string(panValue) + " / Tilt: " + std::to_string(tiltValue);
-                putText(vizCanvas, dmxText, 
-                       Point(10, vizCanvas.rows - 30),
-                       FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 200, 255), 1);
-                
-                // Display angle values
-                std::string angleText = "Pan Angle: " + std::to_string((int)(state.smoothedPan * 90)) + 
-                                       " / Tilt Angle: " + std::to_string((int)(state.smoothedTilt * 90));
-                putText(vizCanvas, angleText, 
-                       Point(10, vizCanvas.rows - 10),
-                       FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 200, 255), 1);
-                
-                // Draw Auto-Orbit and XYZ Lattice buttons (top-right)
-                int buttonWidth = 120;
-                int buttonHeight = 25;
-                int buttonSpacing = 5;
-                int margin = 10;
-                int startX = vizCanvas.cols - margin - buttonWidth;
-                int startY = 60;
-                
-                // Button 1: Auto-Orbit
-                Scalar orbitColor = state.autoOrbit ? Scalar(100, 255, 100) : Scalar(40, 40, 40);
-                rectangle(vizCanvas, Point(startX, startY), Point(startX + buttonWidth, startY + buttonHeight), orbitColor, -1);
-                rectangle(vizCanvas, Point(startX, startY), Point(startX + buttonWidth, startY + buttonHeight), Scalar(255, 255, 255), 1);
-                std::string orbitText = "Auto-Orbit: " + std::string(state.autoOrbit ? "ON" : "OFF");
-                int baseline = 0;
-                Size textSize = getTextSize(orbitText, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
-                putText(vizCanvas, orbitText, Point(startX + (buttonWidth - textSize.width) / 2, startY + (buttonHeight + textSize.height) / 2),
-                       FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-                
-                // Button 2: XYZ Lattice
-                int button2Y = startY + buttonHeight + buttonSpacing;
-                Scalar latticeColor = state.showXYZLattice ? Scalar(100, 150, 255) : Scalar(40, 40, 40);
-                rectangle(vizCanvas, Point(startX, button2Y), Point(startX + buttonWidth, button2Y + buttonHeight), latticeColor, -1);
-                rectangle(vizCanvas, Point(startX, button2Y), Point(startX + buttonWidth, button2Y + buttonHeight), Scalar(255, 255, 255), 1);
-                std::string latticeText = "XYZ Lattice: " + std::string(state.showXYZLattice ? "ON" : "OFF");
-                textSize = getTextSize(latticeText, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
-                putText(vizCanvas, latticeText, Point(startX + (buttonWidth - textSize.width) / 2, button2Y + (buttonHeight + textSize.height) / 2),
-                       FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-                
-                // Button 3: Reset View
-                int button3Y = button2Y + buttonHeight + buttonSpacing;
-                rectangle(vizCanvas, Point(startX, button3Y), Point(startX + buttonWidth, button3Y + buttonHeight), Scalar(60, 60, 150), -1);
-                rectangle(vizCanvas, Point(startX, button3Y), Point(startX + buttonWidth, button3Y + buttonHeight), Scalar(255, 255, 255), 1);
-                std::string resetText = "Reset View";
-                textSize = getTextSize(resetText, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
-                putText(vizCanvas, resetText, Point(startX + (buttonWidth - textSize.width) / 2, button3Y + (buttonHeight + textSize.height) / 2),
-                       FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-                
-                // Zoom buttons (left side)
-                int zoomButtonWidth = 80;
-                int zoomButtonHeight = 25;
-                int zoomX = 10;
-                int zoomY = vizCanvas.rows - 80;
-                
-                // Zoom In
-                rectangle(vizCanvas, Point(zoomX, zoomY), Point(zoomX + zoomButtonWidth, zoomY + zoomButtonHeight), Scalar(60, 150, 60), -1);
-                rectangle(vizCanvas, Point(zoomX, zoomY), Point(zoomX + zoomButtonWidth, zoomY + zoomButtonHeight), Scalar(255, 255, 255), 1);
-                std::string zoomInText = "Zoom +";
-                textSize = getTextSize(zoomInText, FONT_HERSHEY_SIMPLEX, 0.35, 1, &baseline);
-                putText(vizCanvas, zoomInText, Point(zoomX + (zoomButtonWidth - textSize.width) / 2, zoomY + (zoomButtonHeight + textSize.height) / 2),
-                       FONT_HERSHEY_SIMPLEX, 0.35, Scalar(255, 255, 255), 1);
-                
-                // Zoom Out
-                int zoomOutY = zoomY + zoomButtonHeight + buttonSpacing;
-                rectangle(vizCanvas, Point(zoomX, zoomOutY), Point(zoomX + zoomButtonWidth, zoomOutY + zoomButtonHeight), Scalar(150, 60, 60), -1);
-                rectangle(vizCanvas, Point(zoomX, zoomOutY), Point(zoomX + zoomButtonWidth, zoomOutY + zoomButtonHeight), Scalar(255, 255, 255), 1);
-                std::string zoomOutText = "Zoom -";
-                textSize = getTextSize(zoomOutText, FONT_HERSHEY_SIMPLEX, 0.35, 1, &baseline);
-                putText(vizCanvas, zoomOutText, Point(zoomX + (zoomButtonWidth - textSize.width) / 2, zoomOutY + (zoomButtonHeight + textSize.height) / 2),
-                       FONT_HERSHEY_SIMPLEX, 0.35, Scalar(255, 255, 255), 1);
-                
-                // Rotate buttons (below zoom)
-                int rotateButtonWidth = 60;
-                int rotateButtonHeight = 22;
-                int rotateStartY = zoomOutY + zoomButtonHeight + 10;
-                int rotateX = 10;
-                
-                // Rotate Left
-                rectangle(vizCanvas, Point(rotateX, rotateStartY), Point(rotateX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(60, 60, 150), -1);
-                rectangle(vizCanvas, Point(rotateX, rotateStartY), Point(rotateX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(255, 255, 255), 1);
-                putText(vizCanvas, "Left", Point(rotateX + 5, rotateStartY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
-                
-                // Rotate Right
-                int rotateRightX = rotateX + rotateButtonWidth + 5;
-                rectangle(vizCanvas, Point(rotateRightX, rotateStartY), Point(rotateRightX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(60, 60, 150), -1);
-                rectangle(vizCanvas, Point(rotateRightX, rotateStartY), Point(rotateRightX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(255, 255, 255), 1);
-                putText(vizCanvas, "Right", Point(rotateRightX + 5, rotateStartY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
-                
-                // Rotate Up
-                int rotateUpY = rotateStartY + rotateButtonHeight + 5;
-                rectangle(vizCanvas, Point(rotateX, rotateUpY), Point(rotateX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(60, 60, 150), -1);
-                rectangle(vizCanvas, Point(rotateX, rotateUpY), Point(rotateX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(255, 255, 255), 1);
-                putText(vizCanvas, "Up", Point(rotateX + 18, rotateUpY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
-                
-                // Rotate Down
-                rectangle(vizCanvas, Point(rotateRightX, rotateUpY), Point(rotateRightX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(60, 60, 150), -1);
-                rectangle(vizCanvas, Point(rotateRightX, rotateUpY), Point(rotateRightX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(255, 255, 255), 1);
-                putText(vizCanvas, "Down", Point(rotateRightX + 2, rotateUpY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
+            // Hand the composited theatre to the MJPEG encoder thread
+            if (state.mjpeg.wantsFrame()) {
+                state.mjpeg.submitFrame(theatreFrame);
+            }
+            if (composeStartUs > 0) {
+                traceSpan("compose", frameCount, composeStartUs, traceNowUs());
+            }
+        }
+        
+        if (previewDue) {
+            // Everything else the windows draw is copied into the snapshot here
+            if (state.config.show3DVisualization && state.autoOrbit) {
+                state.viewAngleY += state.autoOrbitSpeed;
+                if (state.viewAngleY > 360) state.viewAngleY -= 360;
+                if (state.viewAngleY < -360) state.viewAngleY += 360;
             }
-            // Show 3D Visualization window (SEPARATE RESIZABLE WINDOW - always shown)
-            imshow("3D Fixture Visualization", vizCanvas);
             
-            // Render and show rigging preview window (configuration UI is now in React)
-            Mat riggingCanvas(500, 600, CV_8UC3);
-            renderRiggingPreview(riggingCanvas, state, state.smoothedPan, state.smoothedTilt);
-            imshow("Rigging Preview", riggingCanvas);
+            int panValue, tiltValue;
+            mapToDmx(state.pose.smoothedPan, state.pose.smoothedTilt, state.config, panValue, tiltValue);
             
-            // Process window events
-            waitKey(1);
+            FixtureViewKey& fixtureKey = previewSnapshot.fixture;
+            fixtureKey = FixtureViewKey();
+            fixtureKey.visible = state.config.show3DVisualization;
+            if (fixtureKey.visible) {
+                fixtureKey.panDmx = panValue;
+                fixtureKey.tiltDmx = tiltValue;
+                fixtureKey.panAngle = static_cast<int>(state.pose.smoothedPan * 90);
+                fixtureKey.tiltAngle = static_cast<int>(state.pose.smoothedTilt * 90);
+                fixtureKey.viewAngleX = state.viewAngleX;
+                fixtureKey.viewAngleY = state.viewAngleY;
+                fixtureKey.viewDistance = state.viewDistance;
+                fixtureKey.showLattice = state.showXYZLattice;
+                fixtureKey.autoOrbit = state.autoOrbit;
+            }
             
-            // Handle window close buttons
-            int theatreVisible = getWindowProperty("ArtBastard Puppet Theatre", WND_PROP_VISIBLE);
-            int vizVisible = getWindowProperty("3D Fixture Visualization", WND_PROP_VISIBLE);
+            RiggingViewKey& riggingKey = previewSnapshot.rigging;
+            riggingKey.faceDetected = state.faceDetected;
+            riggingKey.panDmx = panValue;
+            riggingKey.tiltDmx = tiltValue;
+            riggingKey.pan = static_cast<int>(std::lround(state.pose.smoothedPan * 1000.0f));
+            riggingKey.tilt = static_cast<int>(std::lround(state.pose.smoothedTilt * 1000.0f));
+            riggingKey.panMin = state.config.panMin;
+            riggingKey.panMax = state.config.panMax;
             
-            // If main theatre window is closed, exit application
-            if (theatreVisible < 0) {
-                saveConfig(state.config);
-                std::cout << "Theatre window closed. Settings saved." << std::endl;
-                break;
+            previewSnapshot.frame = frameCount;
+            state.preview.submit(previewSnapshot);
+        }
+        
+        // The whole iteration, with what happened in it (attached to every span of the frame)
+        if (frameStartUs > 0 && traceEnabled()) {
+            TraceFrameInfo info;
+            info.faces = static_cast<int>(faces.size());
+            info.landmarks = (poseFlags & SHM_POSE_LANDMARKS) != 0;
+            info.output = state.config.useStream ? "stream" : (state.config.useOSC ? "osc" : "http");
+            info.capture = captureFormatName(cameraFrame.format());
+            traceFrame(frameCount, frameStartUs, traceNowUs(), info);
+        }
+        if (takeTraceSignal()) {
+            if (!traceEnabled()) {
+                logMessage(LOG_WARN, LOG_GENERAL, "Trace requested but traceEnabled is off");
+            } else if (!requestTraceDump(state.config.tracePath)) {
+                logMessage(LOG_WARN, LOG_GENERAL, "Trace dump already in progress");
             }
-            
-            // If 3D window is closed, disable 3D visualization
-            if (vizVisible < 0) {
-                state.config.show3DVisualization = false;
+        }
+        
+        // Report change-driven output savings every 10 seconds
+        auto statsNow = std::chrono::steady_clock::now();
+        if (std::chrono::duration_cast<std::chrono::seconds>(statsNow - lastStatsPrint).count() >= 10) {
+            printOutputStats(state.output);
+            printCaptureStats(state.captureLatency, cap);
+            if (state.config.useStream) {
+                state.output.stream.sendStats(frameCount, state.output.sentCount,
+                                              state.output.suppressedCount, state.output.keyframeCount);
             }
+            lastStatsPrint = statsNow;
         }
         
         frameCount++;
     }
 }
 
-int main(int /*argc*/, char** /*argv*/) {
+// --replay: stream a recorded pose log through mapToDmx() and the configured output, no camera.
+// speed 1 = as recorded, 2 = twice as fast, 0 = as fast as the output takes it (load test)
+int replayPoseLog(const Config& config, const std::string& path, double speed) {
+    PoseLogReader reader;
+    if (!reader.open(path)) {
+        return 1;
+    }
+    OutputState output;
+    if (config.useStream) {
+        output.stream.setSocketPath(config.streamSocketPath);
+    }
+    std::cout << "Replaying " << path << (speed > 0.0 ? "" : " as fast as possible") << std::endl;
+    
+    // Same output rate limit as live tracking, in log time (so it scales with speed)
+    int64_t updateIntervalUs = 1000000 / std::max(1, config.updateRate);
+    int64_t lastSendUs = -updateIntervalUs;
+    uint64_t records = 0;
+    uint64_t sends = 0;
+    int64_t logTimeUs = 0;
+    auto start = std::chrono::steady_clock::now();
+    PoseLogRecord record;
+    while (reader.next(record)) {
+        records++;
+        logTimeUs = record.timeUs;
+        if (speed > 0.0) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<int64_t>(record.timeUs / speed)));
+        }
+        
+        // Re-mapped with the current rigging, so a rehearsal can be replayed on a different rig
+        int panValue, tiltValue;
+        mapToDmx(record.smoothedPan, record.smoothedTilt, config, panValue, tiltValue);
+        if (record.flags & POSE_LOG_GESTURE) {
+            const char* gesture = poseLogGestureName(record.gesture);
+            logMessage(LOG_INFO, LOG_GESTURE, "Gesture detected: %s", gesture);
+            if (config.useStream) {
+                output.stream.sendGesture(gesture);
+            }
+        }
+        if (config.useStream) {
+            uint8_t flags = STREAM_POSE_FACE | ((record.flags & POSE_LOG_LANDMARKS) ? STREAM_POSE_LANDMARKS : 0);
+            output.stream.sendPose(record.pan, record.tilt, record.smoothedPan, record.smoothedTilt,
+                                   panValue, tiltValue, flags);
+        }
+        if (speed <= 0.0 || record.timeUs - lastSendUs >= updateIntervalUs) {
+            sendDmxValues(config, output, panValue, tiltValue);
+            lastSendUs = record.timeUs;
+            sends++;
+            logMessage(LOG_INFO, LOG_POSE, "Replay - Pan: %d, Tilt: %d", panValue, tiltValue);
+        }
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Replay finished: " << records << " poses (" << logTimeUs / 1000000.0 << " s recorded) in "
+              << seconds << " s, " << sends << " sends";
+    if (seconds > 0.0) {
+        std::cout << " (" << static_cast<int>(sends / seconds) << "/s)";
+    }
+    std::cout << ", " << output.failedCount << " failed" << std::endl;
+    printOutputStats(output);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    auto startTime = std::chrono::steady_clock::now();
+    
+    // --daemon: stay resident and wait for commands (see command_server.h)
+    bool daemonMode = false;
+    std::string commandSocketPath = DEFAULT_COMMAND_SOCKET_PATH;
+    // --replay: play a pose log (see pose_log.h) to the outputs instead of tracking
+    std::string replayPath;
+    double replaySpeed = 1.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--daemon") {
+            daemonMode = true;
+        } else if (arg == "--command-socket" && i + 1 < argc) {
+            commandSocketPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--replay-speed" && i + 1 < argc) {
+            replaySpeed = std::max(0.0, std::atof(argv[++i]));
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            std::cerr << "Usage: face-tracker [--daemon [--command-socket <path>]]" << std::endl;
+            std::cerr << "       face-tracker --replay <pose log> [--replay-speed <x, 0 = unpaced>]" << std::endl;
+            return 1;
+        }
+    }
+    
     std::cout << "=== ArtBastard DMX Face Tracker ===" << std::endl;
     std::cout << "OpenCV Face Tracking for Moving Head Control" << std::endl;
     std::cout << "====================================" << std::endl;
@@ -2497,90 +2441,120 @@ int main(int /*argc*/, char** /*argv*/) {
     }
 #endif
     
-    // Initialize curl
+    // Initialize curl (first: not thread-safe in older libcurl)
     curl_global_init(CURL_GLOBAL_DEFAULT);
     
     // Load configuration
     Config config = loadConfig();
+    applyLogConfig(config);
+    if (config.traceEnabled) {
+        setTraceEnabled(true, static_cast<size_t>(std::max(256, config.traceSpans)));
+    }
+    installTraceSignal();
     std::cout << "Configuration loaded:" << std::endl;
     std::cout << "  DMX API URL: " << config.dmxApiUrl << std::endl;
     std::cout << "  Pan Channel: " << config.panChannel << std::endl;
     std::cout << "  Tilt Channel: " << config.tiltChannel << std::endl;
     std::cout << "  Camera Index: " << config.cameraIndex << std::endl;
+    std::cout << "  Capture Format: " << captureFormatName(parseCaptureFormat(config.captureFormat))
+              << " (" << config.captureBackend << " backend)" << std::endl;
     std::cout << "  Update Rate: " << config.updateRate << " Hz" << std::endl;
     
-    // Initialize face detection
+    if (!replayPath.empty()) {
+        int result = replayPoseLog(config, replayPath, replaySpeed);
+        curl_global_cleanup();
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return result;
+    }
+    
     FaceTrackerState state;
     state.config = config;
-    
-    // Load face cascade - try multiple possible locations
-    std::vector<std::string> cascadePaths = {
-        "haarcascade_frontalface_alt.xml",  // Current directory
-        "../haarcascade_frontalface_alt.xml",  // Parent (if run from build/bin)
-        "../../haarcascade_frontalface_alt.xml",  // Face-tracker root
-        "../face-tracker/haarcascade_frontalface_alt.xml",  // If run from build
-        "face-tracker/haarcascade_frontalface_alt.xml"  // Alternative
-    };
-    
-    state.faceCascade = makePtr<CascadeClassifier>();
-    bool cascadeLoaded = false;
-    std::string loadedPath;
-    
-    for (const auto& cascadePath : cascadePaths) {
-        if (state.faceCascade->load(cascadePath)) {
-            cascadeLoaded = true;
-            loadedPath = cascadePath;
-            break;
+    state.fileConfig = config;
+    state.startTime = startTime;
+    
+    // Model loading and camera open are independent and each can take seconds: run them side by side
+    std::future<DetectionModels> modelsTask = std::async(std::launch::async, loadDetectionModels);
+    CameraFrame testFrame;
+    std::future<std::unique_ptr<VideoCapture>> cameraTask = std::async(std::launch::async, [config, &testFrame]() {
+        return openConfiguredCamera(config, &testFrame);
+    });
+    
+    // Network and local servers meanwhile; fixtures are held at home until tracking is ready
+    state.configWatcher.start();
+    if (config.useStream) {
+        state.output.stream.setSocketPath(config.streamSocketPath);
+    }
+    if (config.useSharedMemory) {
+        state.sharedMemory.open(config.sharedMemoryName);
+    }
+    if (config.mjpegEnabled) {
+        state.mjpeg.start(config.mjpegPort, config.mjpegFps, config.mjpegWidth, config.mjpegQuality);
+    }
+    if (config.metricsEnabled) {
+        state.metricsServer.start(config.metricsPort, state.metrics);
+    }
+    if (config.oscControlEnabled) {
+        state.control.start(config.oscControlPort, config.oscControlBind);
+    }
+    if (!config.poseLogPath.empty()) {
+        state.poseLog.open(config.poseLogPath);
+    }
+    if (!config.recordPath.empty()) {
+        state.recorder.open(config.recordPath, config.recordFormat, config.recordQueueFrames);
+    }
+    if (config.captureBackend == "synthetic" && !config.syntheticTruthPath.empty()) {
+        state.syntheticTruth.open(config.syntheticTruthPath);
+    }
+    if (daemonMode) {
+        if (state.commands.start(commandSocketPath)) {
+            state.mode = DAEMON_STANDBY; // Tracking begins on "start"
+            state.commands.setMode(state.mode);
+        } else {
+            std::cerr << "Daemon mode unavailable, tracking immediately" << std::endl;
         }
     }
     
-    if (!cascadeLoaded) {
+    int homePan = 0, homeTilt = 0;
+    mapToDmx(0.0f, 0.0f, config, homePan, homeTilt);
+    std::cout << "Holding fixtures at home (Pan: " << homePan << ", Tilt: " << homeTilt << ") during startup" << std::endl;
+    do {
+        sendDmxValues(config, state.output, homePan, homeTilt); // Only keyframes actually go out
+    } while (modelsTask.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready ||
+             cameraTask.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready);
+    
+    DetectionModels models = modelsTask.get();
+    std::unique_ptr<VideoCapture> camera = cameraTask.get();
+    
+    if (!models.faceCascade) {
         std::cerr << "Error: Could not load face cascade from any location!" << std::endl;
         std::cerr << "Tried:" << std::endl;
-        for (const auto& path : cascadePaths) {
-            std::cerr << "  - " << path << std::endl;
+        for (const auto& dir : modelSearchDirs()) {
+            std::cerr << "  - " << dir << "/haarcascade_frontalface_alt.xml" << std::endl;
         }
         std::cerr << std::endl;
         std::cerr << "Please ensure haarcascade_frontalface_alt.xml is in:" << std::endl;
         std::cerr << "  - Current directory, OR" << std::endl;
         std::cerr << "  - face-tracker/ directory" << std::endl;
         std::cerr << "You can download it from: https://github.com/opencv/opencv/tree/master/data/haarcascades" << std::endl;
+        state.configWatcher.stop();
         curl_global_cleanup();
         return -1;
     }
     
-    std::cout << "Loaded face cascade from: " << loadedPath << std::endl;
+    std::cout << "Loaded face cascade from: " << models.cascadePath << std::endl;
+    state.faceCascade = models.faceCascade;
     
-    // Initialize facemark detector (for landmarks)
 #ifdef HAVE_OPENCV_FACE
-    state.facemark = FacemarkLBF::create();
-    std::vector<std::string> facemarkPaths = {
-        "lbfmodel.yaml",  // Current directory
-        "../lbfmodel.yaml",  // Parent (if run from build/bin)
-        "../../lbfmodel.yaml",  // Face-tracker root
-        "../face-tracker/lbfmodel.yaml",  // If run from build
-        "face-tracker/lbfmodel.yaml"  // Alternative
-    };
-    
-    bool facemarkLoaded = false;
-    for (const auto& facemarkPath : facemarkPaths) {
-        try {
-            state.facemark->loadModel(facemarkPath);
-            std::cout << "Facial landmark model loaded from: " << facemarkPath << std::endl;
-            facemarkLoaded = true;
-            break;
-        } catch (const cv::Exception& e) {
-            // Try next path
-            continue;
-        }
-    }
-    
-    if (!facemarkLoaded) {
+    if (models.facemark) {
+        std::cout << "Facial landmark model loaded from: " << models.facemarkPath << " (" << models.facemarkLoadMs << " ms)" << std::endl;
+    } else {
         std::cout << "Warning: Could not load facial landmark model" << std::endl;
         std::cout << "Face detection will work but without detailed landmark tracking" << std::endl;
         std::cout << "You can download the model from OpenCV's face module" << std::endl;
-        state.facemark = Ptr<Facemark>(); // Will use basic face center tracking
     }
+    state.facemark = models.facemark; // Empty = basic face center tracking
 #else
     std::cout << "OpenCV face module not available - using basic face center tracking" << std::endl;
     std::cout << "To enable facial landmark tracking, install OpenCV with contrib modules:" << std::endl;
@@ -2588,81 +2562,52 @@ int main(int /*argc*/, char** /*argv*/) {
     state.facemark = nullptr; // Will use basic face center tracking
 #endif
     
-    // Open camera
-    VideoCapture cap(config.cameraIndex);
-    if (!cap.isOpened()) {
+    if (!camera) {
         std::cerr << "Error: Could not open camera " << config.cameraIndex << std::endl;
+        state.configWatcher.stop();
         curl_global_cleanup();
         return -1;
     }
-    
-    // Set camera resolution for better performance (these are usually well-supported)
-    setCameraProperty(cap, CAP_PROP_FRAME_WIDTH, 640);
-    setCameraProperty(cap, CAP_PROP_FRAME_HEIGHT, 480);
-    setCameraProperty(cap, CAP_PROP_FPS, 30);
-    
-    // Try to force color format (before grabbing frame)
-    // Some backends require this to be set before opening, but we try anyway
-    cap.set(CAP_PROP_CONVERT_RGB, 1);
-    
-    // Check if camera outputs color or grayscale - grab a test frame
-    Mat testFrame;
-    cap >> testFrame;
-    if (!testFrame.empty()) {
-        if (testFrame.channels() == 1) {
+    VideoCapture& cap = *camera;
+    
+    // Check if camera outputs color or grayscale (test frame grabbed by the open task)
+    if (testFrame.format() == CAPTURE_MJPEG) {
+        std::cout << "Camera is outputting MJPEG frames (decoded on " << config.captureDecodeThreads
+                  << " threads, detection at 1/" << config.captureDecodeScale << " size)." << std::endl;
+    } else if (testFrame.isRaw()) {
+        std::cout << "Camera is outputting raw " << captureFormatName(testFrame.format())
+                  << " frames (detection reads the Y plane, color is converted for previews only)." << std::endl;
+    } else if (!testFrame.empty()) {
+        if (parseCaptureFormat(config.captureFormat) != CAPTURE_BGR) {
+            std::cout << "Camera ignored captureFormat \"" << config.captureFormat << "\", capturing BGR." << std::endl;
+        }
+        if (testFrame.bgr().channels() == 1) {
             std::cout << "WARNING: Camera is outputting GRAYSCALE frames (1 channel)." << std::endl;
             std::cout << "This is likely a camera driver limitation. The application will" << std::endl;
             std::cout << "convert frames to color, but quality may be reduced." << std::endl;
             std::cout << "Try a different camera or check camera settings." << std::endl;
-        } else if (testFrame.channels() == 3) {
+        } else if (testFrame.bgr().channels() == 3) {
             std::cout << "Camera is outputting COLOR frames (3 channels - BGR format)." << std::endl;
         } else {
-            std::cout << "WARNING: Camera output has " << testFrame.channels() << " channels (unexpected format)." << std::endl;
-        }
-    }
-    // Note: testFrame will be discarded, we'll capture fresh frames in the loop
-    
-    // Configure camera exposure and brightness (may not be supported by all cameras)
-    if (!config.autoExposure) {
-        // Disable auto exposure for manual control
-        setCameraProperty(cap, CAP_PROP_AUTO_EXPOSURE, 0.25, "auto exposure");
-        if (config.cameraExposure >= -13 && config.cameraExposure <= 1) {
-            bool success = setCameraProperty(cap, CAP_PROP_EXPOSURE, config.cameraExposure, "exposure");
-            if (success) {
-                std::cout << "Set camera exposure to: " << config.cameraExposure << " (manual mode)" << std::endl;
-            }
-        } else {
-            // Default exposure if not set
-            bool success = setCameraProperty(cap, CAP_PROP_EXPOSURE, -6.0, "exposure");
-            if (success) {
-                std::cout << "Set camera exposure to default: -6.0 (manual mode)" << std::endl;
-            }
-        }
-    } else {
-        // Enable auto exposure initially
-        bool success = setCameraProperty(cap, CAP_PROP_AUTO_EXPOSURE, 0.75, "auto exposure");
-        if (success) {
-            std::cout << "Auto exposure enabled (slider will switch to manual when adjusted)" << std::endl;
+            std::cout << "WARNING: Camera output has " << testFrame.bgr().channels() << " channels (unexpected format)." << std::endl;
         }
     }
-    
-    if (config.cameraBrightness >= 0) {
-        bool success = setCameraProperty(cap, CAP_PROP_BRIGHTNESS, config.cameraBrightness, "brightness");
-        if (success) {
-            std::cout << "Set camera brightness to: " << config.cameraBrightness << std::endl;
-        }
-    }
-    
-    // Try to set other camera properties for better image (may not be supported)
-    setCameraProperty(cap, CAP_PROP_AUTOFOCUS, 1, "autofocus");
-    setCameraProperty(cap, CAP_PROP_AUTO_WB, 1, "auto white balance");
+    testFrame = CameraFrame();
     
     std::cout << "Camera opened successfully" << std::endl;
     std::cout << "Camera settings applied:" << std::endl;
     std::cout << "  Brightness multiplier: " << config.brightness << std::endl;
     std::cout << "  Contrast multiplier: " << config.contrast << std::endl;
     std::cout << "  Auto exposure: " << (config.autoExposure ? "enabled" : "disabled") << std::endl;
-    std::cout << "Starting face tracking..." << std::endl;
+    
+    // Single line the Node service waits for
+    auto readyMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+    std::cout << "READY (startup " << readyMs.count() << " ms)" << std::endl;
+    if (state.mode == DAEMON_STANDBY) {
+        std::cout << "Daemon standby: send \"start\" to " << commandSocketPath << " to begin tracking" << std::endl;
+    } else {
+        std::cout << "Starting face tracking..." << std::endl;
+    }
     
     // Set up trackbars in preview window (will be done after first frame is captured)
     if (config.showPreview) {
@@ -2694,21 +2639,43 @@ int main(int /*argc*/, char** /*argv*/) {
     }
     
     // Initialize smoothed values to center
-    state.smoothedPan = 0.0f;
-    state.smoothedTilt = 0.0f;
-    
-    // Start tracking
+    state.pose.smoothedPan = 0.0f;
+    state.pose.smoothedTilt = 0.0f;
+    
+    // Start tracking; from here per-frame messages go through the log writer thread
+    startLogWriter();
+    traceThreadName("tracking");
+    syncFailsafeConfig(state);
+    FailsafeOutput& failsafe = state.failsafe;
+    state.watchdog.start(state.config.watchdogTimeoutMs, [&failsafe](int64_t stalledMs) {
+        sendFailsafe(failsafe, stalledMs);
+    });
     try {
-        trackFace(cap, state);
+        trackFace(camera, state);
     } catch (const std::exception& e) {
-        std::cerr << "Error during tracking: " << e.what() << std::endl;
+        logMessage(LOG_ERROR, LOG_GENERAL, "Error during tracking: %s", e.what());
     }
+    state.watchdog.stop();
+    stopLogWriter();
+    
+    printOutputStats(state.output);
+    state.syntheticTruth.close();
+    state.poseLog.close();
+    state.recorder.close();
     
     // Cleanup
-    cap.release();
-    if (config.showPreview) {
-        destroyAllWindows();
+    state.configWatcher.stop();
+    state.commands.stop();
+    state.control.stop();
+    if (state.cameraReopen.valid()) {
+        state.cameraReopen.wait();
     }
+    state.preview.stop();
+    state.mjpeg.stop();
+    state.metricsServer.stop();
+    finishTraceDump();
+    state.sharedMemory.close();
+    camera->release();
     curl_global_cleanup();
     
 #ifdef _WIN32
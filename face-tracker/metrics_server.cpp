@@ -0,0 +1,285 @@
+#ifdef _WIN32
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+#endif
+
+#include "metrics_server.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #define closeSocket(s) closesocket(s)
+    typedef int socklen_t;
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    #define closeSocket(s) close(s)
+#endif
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0
+#endif
+
+static const char* STAGE_NAMES[STAGE_COUNT] = {"grab", "preprocess", "detect", "landmarks", "output", "frame"};
+
+const char* metricsStageName(MetricsStage stage) {
+    return STAGE_NAMES[stage];
+}
+
+void LatencyHistogram::observeUs(int64_t us) {
+    int bucket = 0;
+    while (bucket < METRICS_BUCKET_COUNT && us > METRICS_BUCKET_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumUs_.fetch_add(us, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::render(std::string& out, const char* name, const char* labels) const {
+    char line[256];
+    const char* separator = labels[0] ? "," : "";
+    uint64_t cumulative = 0;
+    for (int i = 0; i <= METRICS_BUCKET_COUNT; i++) {
+        cumulative += buckets_[i].load(std::memory_order_relaxed);
+        if (i < METRICS_BUCKET_COUNT) {
+            std::snprintf(line, sizeof(line), "%s_bucket{%s%sle=\"%g\"} %llu\n", name, labels, separator,
+                          METRICS_BUCKET_BOUNDS_US[i] / 1e6, static_cast<unsigned long long>(cumulative));
+        } else {
+            std::snprintf(line, sizeof(line), "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels, separator,
+                          static_cast<unsigned long long>(cumulative));
+        }
+        out += line;
+    }
+    // Count from the same bucket reads so it always equals the +Inf bucket
+    const char* open = labels[0] ? "{" : "";
+    const char* close = labels[0] ? "}" : "";
+    std::snprintf(line, sizeof(line), "%s_sum%s%s%s %g\n%s_count%s%s%s %llu\n",
+                  name, open, labels, close, sumUs_.load(std::memory_order_relaxed) / 1e6,
+                  name, open, labels, close, static_cast<unsigned long long>(cumulative));
+    out += line;
+}
+
+static void renderHeader(std::string& out, const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+static void renderValue(std::string& out, const char* name, const char* type, const char* help, long long value) {
+    renderHeader(out, name, type, help);
+    out += name;
+    out += ' ';
+    out += std::to_string(value);
+    out += '\n';
+}
+
+static void renderCounter(std::string& out, const char* name, const char* help, const std::atomic<uint64_t>& value) {
+    renderValue(out, name, "counter", help, static_cast<long long>(value.load(std::memory_order_relaxed)));
+}
+
+static void renderGauge(std::string& out, const char* name, const char* help, const std::atomic<int64_t>& value) {
+    renderValue(out, name, "gauge", help, static_cast<long long>(value.load(std::memory_order_relaxed)));
+}
+
+std::string renderMetrics(const TrackerMetrics& m) {
+    std::string out;
+    out.reserve(8192);
+    renderCounter(out, "facetracker_frames_captured_total", "Frames read from the camera", m.framesCaptured);
+    renderCounter(out, "facetracker_frames_processed_total", "Frames run through detection", m.framesProcessed);
+    renderCounter(out, "facetracker_frames_with_face_total", "Processed frames with at least one face", m.framesWithFace);
+    renderCounter(out, "facetracker_frames_dropped_total", "Frames the V4L2 driver dropped before they were read", m.driverDroppedFrames);
+    renderCounter(out, "facetracker_decode_failures_total", "MJPEG frames that failed to decode", m.decodeFailures);
+    renderCounter(out, "facetracker_capture_failures_total", "Camera reads that returned no frame", m.captureFailures);
+    renderCounter(out, "facetracker_watchdog_stalls_total", "Tracking stalls that sent the fixtures to the failsafe position", m.watchdogStalls);
+    renderCounter(out, "facetracker_landmark_fits_total", "Facemark fits attempted", m.landmarkFits);
+    renderCounter(out, "facetracker_landmark_fits_ok_total", "Facemark fits that returned a 68-point shape", m.landmarkFitsOk);
+    renderCounter(out, "facetracker_output_sent_total", "DMX channel values transmitted", m.outputSent);
+    renderCounter(out, "facetracker_output_suppressed_total", "DMX channel values skipped as unchanged", m.outputSuppressed);
+    renderCounter(out, "facetracker_output_keyframes_total", "Full DMX refreshes", m.outputKeyframes);
+    renderCounter(out, "facetracker_output_failures_total", "Output sends that failed on any transport", m.outputFailures);
+    renderCounter(out, "facetracker_curl_errors_total", "HTTP output requests that failed", m.curlErrors);
+    renderCounter(out, "facetracker_osc_errors_total", "OSC output messages that failed", m.oscErrors);
+    renderCounter(out, "facetracker_log_dropped_total", "Log lines dropped because the log buffer was full", m.logDropped);
+    renderCounter(out, "facetracker_recorded_frames_total", "Camera frames written by the frame recorder", m.recordedFrames);
+    renderCounter(out, "facetracker_record_dropped_total", "Camera frames the frame recorder dropped because its queue was full", m.recordDropped);
+    renderGauge(out, "facetracker_decode_queue_depth", "MJPEG frames waiting in or being decoded by the decode pool", m.decodeQueueDepth);
+    renderGauge(out, "facetracker_preview_clients", "Connected MJPEG preview viewers", m.previewClients);
+    renderGauge(out, "facetracker_face_detected", "1 while a face is being tracked", m.faceDetected);
+
+    renderHeader(out, "facetracker_stage_seconds", "histogram", "Time spent per frame in each pipeline stage");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        std::string labels = std::string("stage=\"") + STAGE_NAMES[i] + "\"";
+        m.stages[i].render(out, "facetracker_stage_seconds", labels.c_str());
+    }
+    renderHeader(out, "facetracker_capture_to_pose_seconds", "histogram", "Camera capture timestamp to pose published");
+    m.captureToPose.render(out, "facetracker_capture_to_pose_seconds", "");
+    return out;
+}
+
+static bool sendAll(intptr_t sock, const char* data, size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        int sent = send(static_cast<SOCKET>(sock), data, static_cast<int>(size), 0);
+#else
+        ssize_t sent = send(static_cast<int>(sock), data, size, MSG_NOSIGNAL);
+#endif
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static void setSocketTimeouts(intptr_t sock, int seconds) {
+#ifdef _WIN32
+    DWORD timeout = seconds * 1000;
+    setsockopt(static_cast<SOCKET>(sock), SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    setsockopt(static_cast<SOCKET>(sock), SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+    struct timeval timeout;
+    timeout.tv_sec = seconds;
+    timeout.tv_usec = 0;
+    setsockopt(static_cast<int>(sock), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(static_cast<int>(sock), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(static_cast<int>(sock), SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+#endif
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(int port, const TrackerMetrics& metrics) {
+    if (running_) return true;
+    metrics_ = &metrics;
+
+#ifdef _WIN32
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) {
+#else
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+#endif
+        std::cerr << "Failed to create metrics socket" << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    // Localhost only - scrape through a local Prometheus/agent
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(sock, 4) < 0) {
+        std::cerr << "Failed to listen for metrics on port " << port << std::endl;
+        closeSocket(sock);
+        return false;
+    }
+
+    listenSocket_ = static_cast<intptr_t>(sock);
+    running_ = true;
+    acceptThread_ = std::thread(&MetricsServer::acceptLoop, this);
+
+    std::cout << "Metrics: http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_) return;
+    running_ = false;
+
+    // Unblock accept()
+    if (listenSocket_ != -1) {
+#ifndef _WIN32
+        shutdown(static_cast<int>(listenSocket_), SHUT_RDWR);
+#endif
+        closeSocket(listenSocket_);
+        listenSocket_ = -1;
+    }
+    if (acceptThread_.joinable()) acceptThread_.join();
+}
+
+void MetricsServer::acceptLoop() {
+    while (running_) {
+        struct sockaddr_in clientAddr;
+        socklen_t addrLen = sizeof(clientAddr);
+#ifdef _WIN32
+        SOCKET client = accept(static_cast<SOCKET>(listenSocket_), (struct sockaddr*)&clientAddr, &addrLen);
+        if (client == INVALID_SOCKET) {
+#else
+        int client = accept(static_cast<int>(listenSocket_), (struct sockaddr*)&clientAddr, &addrLen);
+        if (client < 0) {
+#endif
+            if (!running_) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        // Scrapes are small and infrequent: serve them one at a time on this thread
+        serveClient(static_cast<intptr_t>(client));
+    }
+}
+
+void MetricsServer::serveClient(intptr_t client) {
+    setSocketTimeouts(client, 1);
+
+    // Read the request head (only the request line matters)
+    std::string request;
+    char chunk[512];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 4096) {
+#ifdef _WIN32
+        int received = recv(static_cast<SOCKET>(client), chunk, sizeof(chunk), 0);
+#else
+        ssize_t received = recv(static_cast<int>(client), chunk, sizeof(chunk), 0);
+#endif
+        if (received <= 0) break;
+        request.append(chunk, static_cast<size_t>(received));
+    }
+
+    std::string path;
+    if (request.compare(0, 4, "GET ") == 0) {
+        size_t end = request.find(' ', 4);
+        path = request.substr(4, end == std::string::npos ? std::string::npos : end - 4);
+        size_t query = path.find('?');
+        if (query != std::string::npos) path.resize(query);
+    }
+
+    if (path == "/metrics") {
+        std::string body = renderMetrics(*metrics_);
+        std::string head = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n";
+        if (sendAll(client, head.data(), head.size())) {
+            sendAll(client, body.data(), body.size());
+        }
+    } else {
+        const char* notFound = "HTTP/1.1 404 Not Found\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+        sendAll(client, notFound, std::strlen(notFound));
+    }
+
+    closeSocket(client);
+}
@@ -0,0 +1,107 @@
+// Tracker health metrics over HTTP in Prometheus text format (metricsEnabled)
+//
+//   GET http://127.0.0.1:<metricsPort>/metrics
+//
+// The tracking thread updates TrackerMetrics with relaxed atomic adds and
+// stores only (no locks, no allocation), so recording costs a few
+// nanoseconds per frame. The server thread reads the atomics and formats the
+// page when scraped; scraping every second costs one short-lived connection
+// and a few kilobytes of text.
+//
+// Rates are left to Prometheus, e.g. detection hit rate:
+//   rate(facetracker_frames_with_face_total[1m]) / rate(facetracker_frames_processed_total[1m])
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Upper bounds in microseconds; a final +Inf bucket catches the rest
+const int METRICS_BUCKET_COUNT = 12;
+const int64_t METRICS_BUCKET_BOUNDS_US[METRICS_BUCKET_COUNT] = {
+    250, 500, 1000, 2000, 5000, 10000, 20000, 33000, 50000, 100000, 250000, 1000000
+};
+
+class LatencyHistogram {
+public:
+    // Tracking thread (any single writer)
+    void observeUs(int64_t us);
+    // Prometheus histogram lines (cumulative buckets, seconds) for name{labels}
+    void render(std::string& out, const char* name, const char* labels) const;
+
+private:
+    std::atomic<uint64_t> buckets_[METRICS_BUCKET_COUNT + 1] = {};
+    std::atomic<int64_t> sumUs_{0};
+};
+
+// Pipeline stages timed per frame
+enum MetricsStage {
+    STAGE_GRAB,        // Camera read (includes waiting for the next frame)
+    STAGE_PREPROCESS,  // Decode/convert, brightness/contrast, equalization
+    STAGE_DETECT,      // Cascade detection
+    STAGE_LANDMARKS,   // Facemark fit (only when a face was found)
+    STAGE_OUTPUT,      // DMX/OSC/stream send
+    STAGE_FRAME,       // Whole iteration, grab to pose published
+    STAGE_COUNT
+};
+
+struct TrackerMetrics {
+    // Counters, incremented by the tracking thread
+    std::atomic<uint64_t> framesCaptured{0};
+    std::atomic<uint64_t> framesProcessed{0};
+    std::atomic<uint64_t> framesWithFace{0};
+    std::atomic<uint64_t> landmarkFits{0};         // Attempts
+    std::atomic<uint64_t> landmarkFitsOk{0};       // 68-point shape returned
+    std::atomic<uint64_t> captureFailures{0};
+    std::atomic<uint64_t> watchdogStalls{0};       // Stalls that sent the fixtures to the failsafe position
+
+    // Mirrors of counters kept elsewhere, stored by the tracking thread once per frame
+    std::atomic<uint64_t> driverDroppedFrames{0};  // V4L2 sequence gaps
+    std::atomic<uint64_t> decodeFailures{0};       // Corrupt MJPEG frames
+    std::atomic<uint64_t> outputSent{0};           // Channel values
+    std::atomic<uint64_t> outputSuppressed{0};
+    std::atomic<uint64_t> outputKeyframes{0};
+    std::atomic<uint64_t> outputFailures{0};       // Sends that failed (any transport)
+    std::atomic<uint64_t> curlErrors{0};
+    std::atomic<uint64_t> oscErrors{0};
+    std::atomic<uint64_t> logDropped{0};
+    std::atomic<uint64_t> recordedFrames{0};       // Frame recorder (recordPath)
+    std::atomic<uint64_t> recordDropped{0};        // Frames the recorder had no queue room for
+
+    // Gauges
+    std::atomic<int64_t> decodeQueueDepth{0};      // MJPEG frames in the decode pool
+    std::atomic<int64_t> previewClients{0};        // MJPEG preview viewers
+    std::atomic<int64_t> faceDetected{0};
+
+    LatencyHistogram stages[STAGE_COUNT];
+    LatencyHistogram captureToPose;                // Camera timestamp to pose published
+};
+
+// "grab", "preprocess", ... (label values, also used as trace span names)
+const char* metricsStageName(MetricsStage stage);
+
+// The whole page for one scrape
+std::string renderMetrics(const TrackerMetrics& metrics);
+
+class MetricsServer {
+public:
+    MetricsServer() = default;
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Listen on 127.0.0.1:port and serve `metrics` (which must outlive the server)
+    bool start(int port, const TrackerMetrics& metrics);
+    void stop();
+    bool isRunning() const { return running_; }
+
+private:
+    void acceptLoop();
+    void serveClient(intptr_t client);
+
+    std::atomic<bool> running_{false};
+    intptr_t listenSocket_ = -1;
+    const TrackerMetrics* metrics_ = nullptr;
+    std::thread acceptThread_;
+};
@@ -0,0 +1,370 @@
+#ifdef _WIN32
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+#endif
+
+#include "mjpeg_server.h"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #define closeSocket(s) closesocket(s)
+    typedef int socklen_t;
+    #define pollSockets WSAPoll
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #define closeSocket(s) close(s)
+    #define pollSockets poll
+#endif
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0
+#endif
+
+// More viewers than this is almost certainly a leak (e.g. a reloading page)
+static const int MJPEG_MAX_CLIENTS = 8;
+static const char* MJPEG_BOUNDARY = "artbastardframe";
+
+static int64_t nowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+// Blocking send of the whole buffer (client sockets have a send timeout)
+static bool sendAll(intptr_t sock, const char* data, size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        int sent = send(static_cast<SOCKET>(sock), data, static_cast<int>(size), 0);
+#else
+        ssize_t sent = send(static_cast<int>(sock), data, size, MSG_NOSIGNAL);
+#endif
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static bool sendString(intptr_t sock, const std::string& text) {
+    return sendAll(sock, text.data(), text.size());
+}
+
+// True once the client closed its end (or the connection broke). Anything the
+// client sends after its request is read and ignored.
+static bool clientHungUp(intptr_t sock) {
+#ifdef _WIN32
+    WSAPOLLFD fd;
+    fd.fd = static_cast<SOCKET>(sock);
+#else
+    struct pollfd fd;
+    fd.fd = static_cast<int>(sock);
+#endif
+    fd.events = POLLIN;
+    fd.revents = 0;
+    if (pollSockets(&fd, 1, 0) <= 0) return false;
+    if (fd.revents & (POLLERR | POLLHUP | POLLNVAL)) return true;
+    char discard[256];
+#ifdef _WIN32
+    int received = recv(static_cast<SOCKET>(sock), discard, sizeof(discard), 0);
+#else
+    ssize_t received = recv(static_cast<int>(sock), discard, sizeof(discard), 0);
+#endif
+    return received <= 0;
+}
+
+static void setSocketTimeouts(intptr_t sock, int seconds) {
+#ifdef _WIN32
+    DWORD timeout = seconds * 1000;
+    setsockopt(static_cast<SOCKET>(sock), SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    setsockopt(static_cast<SOCKET>(sock), SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+    struct timeval timeout;
+    timeout.tv_sec = seconds;
+    timeout.tv_usec = 0;
+    setsockopt(static_cast<int>(sock), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(static_cast<int>(sock), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(static_cast<int>(sock), SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+#endif
+}
+
+MjpegServer::~MjpegServer() {
+    stop();
+}
+
+bool MjpegServer::start(int port, int fps, int width, int quality) {
+    if (running_) return true;
+
+    fps_ = std::max(1, std::min(fps, 60));
+    width_ = std::max(0, width);
+    quality_ = std::max(10, std::min(quality, 100));
+
+#ifdef _WIN32
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) {
+#else
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+#endif
+        std::cerr << "Failed to create MJPEG server socket" << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    // Localhost only - the Node backend/React app runs on the same machine
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(sock, 4) < 0) {
+        std::cerr << "Failed to listen for MJPEG preview on port " << port << std::endl;
+        closeSocket(sock);
+        return false;
+    }
+
+    listenSocket_ = static_cast<intptr_t>(sock);
+    running_ = true;
+    acceptThread_ = std::thread(&MjpegServer::acceptLoop, this);
+    encodeThread_ = std::thread(&MjpegServer::encodeLoop, this);
+
+    std::cout << "MJPEG preview: http://127.0.0.1:" << port << "/stream.mjpg ("
+              << fps_ << " fps, quality " << quality_ << ")" << std::endl;
+    return true;
+}
+
+void MjpegServer::stop() {
+    if (!running_) return;
+    running_ = false;
+
+    // Unblock accept() and the encoder/client waits
+    if (listenSocket_ != -1) {
+#ifndef _WIN32
+        shutdown(static_cast<int>(listenSocket_), SHUT_RDWR);
+#endif
+        closeSocket(listenSocket_);
+        listenSocket_ = -1;
+    }
+    frameReady_.notify_all();
+    jpegReady_.notify_all();
+
+    if (acceptThread_.joinable()) acceptThread_.join();
+    if (encodeThread_.joinable()) encodeThread_.join();
+
+    // Unblock clients stuck in send()/recv(), then wait for every one of them
+    for (const auto& client : clientThreads_) {
+#ifdef _WIN32
+        shutdown(static_cast<SOCKET>(client->socket), SD_BOTH);
+#else
+        shutdown(static_cast<int>(client->socket), SHUT_RDWR);
+#endif
+    }
+    reapClients(true);
+}
+
+// Join finished client threads (all of them when `all` is set) and close their sockets
+void MjpegServer::reapClients(bool all) {
+    for (auto it = clientThreads_.begin(); it != clientThreads_.end();) {
+        Client& client = **it;
+        if (!all && !client.finished) {
+            ++it;
+            continue;
+        }
+        client.thread.join();
+        closeSocket(client.socket);
+        it = clientThreads_.erase(it);
+    }
+}
+
+bool MjpegServer::wantsFrame() const {
+    return running_ && clients_ > 0 && nowUs() >= nextFrameUs_;
+}
+
+void MjpegServer::submitFrame(const cv::Mat& bgr) {
+    if (!running_ || bgr.empty()) return;
+    nextFrameUs_ = nowUs() + 1000000 / fps_;
+    {
+        std::lock_guard<std::mutex> lock(frameMutex_);
+        if (hasPendingFrame_) {
+            skipped_++;
+        }
+        bgr.copyTo(pendingFrame_); // Reuses the buffer once sizes settle
+        hasPendingFrame_ = true;
+    }
+    frameReady_.notify_one();
+}
+
+void MjpegServer::encodeLoop() {
+    cv::Mat frame, scaled;
+    std::vector<uint8_t> buffer;
+    const std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, quality_};
+
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(frameMutex_);
+            frameReady_.wait(lock, [this] { return hasPendingFrame_ || !running_; });
+            if (!running_) break;
+            std::swap(frame, pendingFrame_);
+            hasPendingFrame_ = false;
+        }
+
+        const cv::Mat* source = &frame;
+        if (width_ > 0 && frame.cols > width_) {
+            int height = frame.rows * width_ / frame.cols;
+            cv::resize(frame, scaled, cv::Size(width_, height), 0, 0, cv::INTER_AREA);
+            source = &scaled;
+        }
+
+        if (!cv::imencode(".jpg", *source, buffer, params)) {
+            continue;
+        }
+
+        auto jpeg = std::make_shared<const std::vector<uint8_t>>(buffer);
+        {
+            std::lock_guard<std::mutex> lock(jpegMutex_);
+            jpeg_ = jpeg;
+            jpegSequence_++;
+        }
+        encoded_++;
+        jpegReady_.notify_all();
+    }
+}
+
+bool MjpegServer::waitForJpeg(uint64_t afterSequence, std::shared_ptr<const std::vector<uint8_t>>& jpeg,
+                              uint64_t& sequence, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(jpegMutex_);
+    bool ready = jpegReady_.wait_for(lock, timeout, [&] {
+        return jpegSequence_ > afterSequence || !running_;
+    });
+    if (!ready || !running_ || !jpeg_) return false;
+    jpeg = jpeg_;
+    sequence = jpegSequence_;
+    return true;
+}
+
+void MjpegServer::acceptLoop() {
+    intptr_t listenSocket = listenSocket_; // stop() resets the member while accept() blocks
+    while (running_) {
+        struct sockaddr_in clientAddr;
+        socklen_t addrLen = sizeof(clientAddr);
+#ifdef _WIN32
+        SOCKET client = accept(static_cast<SOCKET>(listenSocket), (struct sockaddr*)&clientAddr, &addrLen);
+        if (client == INVALID_SOCKET) {
+#else
+        int client = accept(static_cast<int>(listenSocket), (struct sockaddr*)&clientAddr, &addrLen);
+        if (client < 0) {
+#endif
+            if (!running_) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        reapClients(false);
+        if (static_cast<int>(clientThreads_.size()) >= MJPEG_MAX_CLIENTS) {
+            sendString(static_cast<intptr_t>(client), "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n");
+            closeSocket(client);
+            continue;
+        }
+
+        auto entry = std::make_unique<Client>();
+        entry->socket = static_cast<intptr_t>(client);
+        entry->thread = std::thread(&MjpegServer::serveClient, this, entry.get());
+        clientThreads_.push_back(std::move(entry));
+    }
+}
+
+void MjpegServer::serveClient(Client* entry) {
+    intptr_t client = entry->socket;
+    setSocketTimeouts(client, 2);
+
+    // Read the request head (only the request line matters)
+    std::string request;
+    char chunk[512];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 4096) {
+#ifdef _WIN32
+        int received = recv(static_cast<SOCKET>(client), chunk, sizeof(chunk), 0);
+#else
+        ssize_t received = recv(static_cast<int>(client), chunk, sizeof(chunk), 0);
+#endif
+        if (received <= 0) break;
+        request.append(chunk, static_cast<size_t>(received));
+    }
+
+    std::string path;
+    if (request.compare(0, 4, "GET ") == 0) {
+        size_t end = request.find(' ', 4);
+        path = request.substr(4, end == std::string::npos ? std::string::npos : end - 4);
+        size_t query = path.find('?');
+        if (query != std::string::npos) path.resize(query);
+    }
+
+    const std::string commonHeaders = "Cache-Control: no-cache, no-store\r\n"
+                                      "Pragma: no-cache\r\n"
+                                      "Access-Control-Allow-Origin: *\r\n"
+                                      "Connection: close\r\n";
+
+    if (path == "/" || path == "/stream.mjpg") {
+        clients_++;
+        std::shared_ptr<const std::vector<uint8_t>> jpeg;
+        uint64_t sequence = 0;
+        bool ok = sendString(client, "HTTP/1.1 200 OK\r\n" + commonHeaders +
+                             "Content-Type: multipart/x-mixed-replace; boundary=" + MJPEG_BOUNDARY + "\r\n\r\n");
+        while (ok && running_) {
+            if (!waitForJpeg(sequence, jpeg, sequence, std::chrono::milliseconds(500))) {
+                // No new frame yet (tracker paused or preview idle): notice a closed tab meanwhile
+                ok = !clientHungUp(client);
+                continue;
+            }
+            ok = sendString(client, std::string("--") + MJPEG_BOUNDARY + "\r\n"
+                            "Content-Type: image/jpeg\r\n"
+                            "Content-Length: " + std::to_string(jpeg->size()) + "\r\n\r\n") &&
+                 sendAll(client, reinterpret_cast<const char*>(jpeg->data()), jpeg->size()) &&
+                 sendString(client, "\r\n");
+        }
+        clients_--;
+    } else if (path == "/snapshot.jpg") {
+        clients_++;
+        std::shared_ptr<const std::vector<uint8_t>> jpeg;
+        uint64_t current;
+        {
+            std::lock_guard<std::mutex> lock(jpegMutex_);
+            current = jpegSequence_;
+        }
+        // Wait for a frame composed after the request so the snapshot is not stale
+        uint64_t sequence = 0;
+        if (waitForJpeg(current, jpeg, sequence, std::chrono::seconds(2))) {
+            sendString(client, "HTTP/1.1 200 OK\r\n" + commonHeaders +
+                       "Content-Type: image/jpeg\r\n"
+                       "Content-Length: " + std::to_string(jpeg->size()) + "\r\n\r\n");
+            sendAll(client, reinterpret_cast<const char*>(jpeg->data()), jpeg->size());
+        } else {
+            sendString(client, "HTTP/1.1 503 Service Unavailable\r\n" + commonHeaders + "\r\n");
+        }
+        clients_--;
+    } else {
+        sendString(client, "HTTP/1.1 404 Not Found\r\n" + commonHeaders + "\r\n");
+    }
+
+    entry->finished = true; // The accept thread (or stop()) joins and closes
+}
@@ -0,0 +1,89 @@
+// MJPEG-over-HTTP preview server
+//
+// Serves the composited theatre preview to browsers (the React app embeds it
+// with a plain <img> tag):
+//
+//   GET /stream.mjpg   multipart/x-mixed-replace JPEG stream
+//   GET /snapshot.jpg  single JPEG
+//
+// The tracking thread only hands over raw frames via submitFrame(); resizing
+// and JPEG encoding happen on a background encoder thread, and each client is
+// served by its own thread so a slow browser only slows itself (stop() joins
+// them all). wantsFrame() is false while no client is connected (or the next
+// frame is not due yet), so the tracker can skip composing the preview
+// entirely.
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MjpegServer {
+public:
+    MjpegServer() = default;
+    ~MjpegServer();
+    MjpegServer(const MjpegServer&) = delete;
+    MjpegServer& operator=(const MjpegServer&) = delete;
+
+    // Listen on 127.0.0.1:port; width 0 keeps the submitted size
+    bool start(int port, int fps, int width, int quality);
+    void stop();
+    bool isRunning() const { return running_; }
+    int clientCount() const { return clients_; }
+
+    // Cheap check for the tracking thread: a client is watching and the next frame is due
+    bool wantsFrame() const;
+    // Copy a BGR frame for the encoder (replaces any frame not yet encoded)
+    void submitFrame(const cv::Mat& bgr);
+
+    uint64_t encodedCount() const { return encoded_; }
+    uint64_t skippedCount() const { return skipped_; }
+
+private:
+    void acceptLoop();
+    void encodeLoop();
+    struct Client {
+        intptr_t socket = -1;            // Closed by the owner after the thread is joined
+        std::thread thread;
+        std::atomic<bool> finished{false};
+    };
+
+    void serveClient(Client* client);
+    void reapClients(bool all);
+    bool waitForJpeg(uint64_t afterSequence, std::shared_ptr<const std::vector<uint8_t>>& jpeg, uint64_t& sequence,
+                     std::chrono::milliseconds timeout);
+
+    std::atomic<bool> running_{false};
+    std::atomic<int> clients_{0};
+    std::vector<std::unique_ptr<Client>> clientThreads_; // Accept thread only (then stop())
+    intptr_t listenSocket_ = -1;
+    int fps_ = 15;
+    int width_ = 640;
+    int quality_ = 75;
+    std::thread acceptThread_;
+    std::thread encodeThread_;
+
+    // Raw frame handed over by the tracking thread
+    std::mutex frameMutex_;
+    std::condition_variable frameReady_;
+    cv::Mat pendingFrame_;
+    bool hasPendingFrame_ = false;
+    std::atomic<int64_t> nextFrameUs_{0};
+
+    // Latest encoded JPEG shared by all clients
+    std::mutex jpegMutex_;
+    std::condition_variable jpegReady_;
+    std::shared_ptr<const std::vector<uint8_t>> jpeg_;
+    uint64_t jpegSequence_ = 0;
+
+    std::atomic<uint64_t> encoded_{0};
+    std::atomic<uint64_t> skipped_{0}; // Submitted frames replaced before the encoder got to them
+};
@@ -0,0 +1,142 @@
+#include "model_cache.h"
+
+#include <opencv2/core.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+const std::vector<std::string>& modelSearchDirs() {
+    static const std::vector<std::string> dirs = {
+        ".",                // Current directory
+        "..",               // Parent (if run from build/bin)
+        "../..",            // Face-tracker root
+        "../face-tracker",  // If run from build
+        "face-tracker"      // Alternative
+    };
+    return dirs;
+}
+
+std::string findModelFile(const std::string& fileName) {
+    std::error_code ec;
+    for (const auto& dir : modelSearchDirs()) {
+        std::string path = dir == "." ? fileName : dir + "/" + fileName;
+        if (std::filesystem::is_regular_file(path, ec)) {
+            return path;
+        }
+    }
+    return "";
+}
+
+std::string modelCachePath(const std::string& modelPath) {
+    std::filesystem::path path(modelPath);
+    path.replace_extension(".cache.yml");
+    return path.string();
+}
+
+// True when every element of a sequence is a plain number
+static bool isNumericSeq(const cv::FileNode& node, bool& allInt) {
+    allInt = true;
+    for (const auto& item : node) {
+        if (item.isInt()) continue;
+        if (!item.isReal()) return false;
+        allInt = false;
+    }
+    return node.size() > 0;
+}
+
+static bool isMatNode(const cv::FileNode& node) {
+    return node.isMap() && !node["rows"].empty() && !node["cols"].empty() &&
+           !node["dt"].empty() && !node["data"].empty();
+}
+
+// Copy one node; `name` is empty for sequence elements
+static void copyNode(const cv::FileNode& node, const std::string& name, cv::FileStorage& out) {
+    bool allInt;
+    if (isMatNode(node)) {
+        cv::Mat mat;
+        node >> mat;
+        out.write(name, mat);
+    } else if (node.isMap()) {
+        out.startWriteStruct(name, cv::FileNode::MAP);
+        for (const auto& child : node) {
+            copyNode(child, child.name(), out);
+        }
+        out.endWriteStruct();
+    } else if (node.isSeq() && isNumericSeq(node, allInt)) {
+        // Numeric lists (tree thresholds, feature indices) become base64 blocks
+        if (allInt) {
+            std::vector<int> values;
+            node >> values;
+            cv::write(out, name, values);
+        } else {
+            std::vector<double> values;
+            node >> values;
+            cv::write(out, name, values);
+        }
+    } else if (node.isSeq()) {
+        out.startWriteStruct(name, cv::FileNode::SEQ);
+        for (const auto& child : node) {
+            copyNode(child, "", out);
+        }
+        out.endWriteStruct();
+    } else if (node.isInt()) {
+        out.write(name, static_cast<int>(node));
+    } else if (node.isReal()) {
+        out.write(name, static_cast<double>(node));
+    } else if (node.isString()) {
+        out.write(name, node.string());
+    }
+}
+
+static bool buildModelCache(const std::string& modelPath, const std::string& cachePath) {
+    auto start = std::chrono::steady_clock::now();
+    std::string tempPath = cachePath + ".tmp";
+    try {
+        cv::FileStorage in(modelPath, cv::FileStorage::READ);
+        if (!in.isOpened()) return false;
+        cv::FileStorage out(tempPath, cv::FileStorage::WRITE_BASE64);
+        if (!out.isOpened()) return false;
+        for (const auto& node : in.root()) {
+            copyNode(node, node.name(), out);
+        }
+        out.release();
+    } catch (const cv::Exception& e) {
+        std::cerr << "Could not build model cache: " << e.what() << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // Rename so a crash mid-write never leaves a truncated cache behind
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Built landmark model cache " << cachePath << " (" << elapsed.count() << " ms, one time)" << std::endl;
+    return true;
+}
+
+std::string prepareModelCache(const std::string& modelPath) {
+    std::string cachePath = modelCachePath(modelPath);
+    std::error_code ec;
+    auto modelTime = std::filesystem::last_write_time(modelPath, ec);
+    if (ec) return modelPath;
+
+    auto cacheTime = std::filesystem::last_write_time(cachePath, ec);
+    if (!ec && cacheTime >= modelTime) {
+        return cachePath;
+    }
+
+    // Read-only install directory: keep parsing the original
+    return buildModelCache(modelPath, cachePath) ? cachePath : modelPath;
+}
+
+void discardModelCache(const std::string& modelPath) {
+    std::error_code ec;
+    std::filesystem::remove(modelCachePath(modelPath), ec);
+}
@@ -0,0 +1,31 @@
+// Locating and caching the detection models
+//
+// The Haar cascade and the LBF landmark model are looked up in the same
+// handful of places (working directory, build/bin parents, repo checkout).
+//
+// lbfmodel.yaml is tens of megabytes of text numbers and takes seconds to
+// parse. On first use it is rewritten next to the original as
+// lbfmodel.cache.yml, with every matrix and numeric list stored as base64
+// binary blocks. FacemarkLBF loads the cache through the same FileStorage
+// reader, without the text-to-float parsing. The cache is rebuilt whenever
+// the source model is newer.
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Directories searched for model files, in order
+const std::vector<std::string>& modelSearchDirs();
+
+// First existing "<dir>/<fileName>" from modelSearchDirs(), or "" if none
+std::string findModelFile(const std::string& fileName);
+
+// Path of the binary cache for a YAML model
+std::string modelCachePath(const std::string& modelPath);
+
+// Path to hand to FacemarkLBF::loadModel(): the cache when it is up to date
+// (building it if needed), otherwise the original model
+std::string prepareModelCache(const std::string& modelPath);
+
+// Remove a cache that failed to load so the next start rebuilds it
+void discardModelCache(const std::string& modelPath);
@@ -0,0 +1,402 @@
+// Node addon: the face tracker in the backend process (facetracker_core + N-API)
+//
+//   const { Tracker } = require('./facetracker.node');
+//   const tracker = new Tracker(JSON.stringify(config));
+//   await tracker.start((pose) => { ... });   // Camera + tracking on a worker thread
+//   tracker.updateConfig(JSON.stringify({ smoothingFactor: 0.9 }));
+//   tracker.stop();
+//
+// Poses reach JavaScript through a thread-safe function, one call per camera
+// frame. The worker never waits on the event loop: when POSE_QUEUE_SIZE poses
+// are already waiting, the new one is dropped and counted (droppedPoses()).
+// Pose objects match FaceTrackerPose in src/faceTrackerStream.ts, plus `gesture`,
+// `status` ("tracking", "stalled" or "failed") and `error`. A failure is also
+// kept for tracker.error(), in case its pose was the one dropped.
+//
+// Only the raw C N-API is used (no node-addon-api), so the addon builds with
+// CMake against the headers of the Node that runs the backend.
+#define NAPI_VERSION 8
+#include <node_api.h>
+
+#include "../facetracker.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace {
+
+const size_t POSE_QUEUE_SIZE = 16; // About half a second at 30 fps
+
+struct PoseMessage {
+    ft_pose pose;
+    char gesture[32];              // ft_pose::gesture and error only live during the callback
+    char error[256];
+};
+
+struct TrackerWrap {
+    ft_tracker* tracker = nullptr;
+    napi_threadsafe_function onPose = nullptr;
+    std::atomic<uint64_t> dropped{0};
+    std::mutex errorMutex;
+    std::string error;             // Last FT_STATUS_FAILED reason, cleared by start()
+    // start() in progress on a libuv worker (models load, camera opens)
+    napi_async_work startWork = nullptr;
+    napi_deferred startDeferred = nullptr;
+    napi_ref startSelf = nullptr;  // Keeps the Tracker alive until start() completes
+    bool startFailed = false;
+    bool stopRequested = false;    // stop() called while starting
+};
+
+#define NAPI_CALL(env, call)                                              \
+    do {                                                                  \
+        if ((call) != napi_ok) {                                          \
+            napi_throw_error((env), nullptr, "N-API call failed: " #call); \
+            return nullptr;                                               \
+        }                                                                 \
+    } while (0)
+
+void setNumber(napi_env env, napi_value object, const char* name, double value) {
+    napi_value v;
+    napi_create_double(env, value, &v);
+    napi_set_named_property(env, object, name, v);
+}
+
+void setBool(napi_env env, napi_value object, const char* name, bool value) {
+    napi_value v;
+    napi_get_boolean(env, value, &v);
+    napi_set_named_property(env, object, name, v);
+}
+
+const char* statusName(int status) {
+    switch (status) {
+        case FT_STATUS_STALLED: return "stalled";
+        case FT_STATUS_FAILED: return "failed";
+        default: return "tracking";
+    }
+}
+
+void setString(napi_env env, napi_value object, const char* name, const char* value) {
+    napi_value v;
+    napi_create_string_utf8(env, value, NAPI_AUTO_LENGTH, &v);
+    napi_set_named_property(env, object, name, v);
+}
+
+napi_value poseToObject(napi_env env, const ft_pose& pose, const char* gesture, const char* error) {
+    napi_value object, timestamp;
+    napi_create_object(env, &object);
+    setNumber(env, object, "rawPan", pose.raw_pan);
+    setNumber(env, object, "rawTilt", pose.raw_tilt);
+    setNumber(env, object, "smoothedPan", pose.smoothed_pan);
+    setNumber(env, object, "smoothedTilt", pose.smoothed_tilt);
+    setNumber(env, object, "panDmx", pose.pan_dmx);
+    setNumber(env, object, "tiltDmx", pose.tilt_dmx);
+    setBool(env, object, "faceDetected", pose.face != 0);
+    setBool(env, object, "fromLandmarks", pose.landmarks != 0);
+    napi_create_bigint_int64(env, pose.timestamp_us, &timestamp);
+    napi_set_named_property(env, object, "timestampUs", timestamp);
+    setString(env, object, "gesture", gesture);
+    setString(env, object, "status", statusName(pose.status));
+    setString(env, object, "error", error);
+    return object;
+}
+
+// Tracking thread: hand the pose to the event loop without blocking
+void onNativePose(const ft_pose* pose, void* userData) {
+    TrackerWrap* wrap = static_cast<TrackerWrap*>(userData);
+    PoseMessage* message = new PoseMessage();
+    message->pose = *pose;
+    std::strncpy(message->gesture, pose->gesture ? pose->gesture : "", sizeof(message->gesture) - 1);
+    std::strncpy(message->error, pose->error ? pose->error : "", sizeof(message->error) - 1);
+    message->pose.gesture = nullptr;
+    message->pose.error = nullptr;
+    if (pose->status == FT_STATUS_FAILED) {
+        std::lock_guard<std::mutex> lock(wrap->errorMutex);
+        wrap->error = message->error;
+    }
+    if (napi_call_threadsafe_function(wrap->onPose, message, napi_tsfn_nonblocking) != napi_ok) {
+        // napi_queue_full (JavaScript is behind) or closing
+        delete message;
+        wrap->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Event loop: call the JavaScript onPose callback
+void callPose(napi_env env, napi_value callback, void* /*context*/, void* data) {
+    PoseMessage* message = static_cast<PoseMessage*>(data);
+    if (env && callback) { // Both null while the function is torn down
+        napi_value undefined, argument;
+        napi_get_undefined(env, &undefined);
+        argument = poseToObject(env, message->pose, message->gesture, message->error);
+        napi_call_function(env, undefined, callback, 1, &argument, nullptr);
+    }
+    delete message;
+}
+
+void stopTracker(TrackerWrap* wrap) {
+    ft_stop(wrap->tracker); // Joins the worker: no more onNativePose calls
+    if (wrap->onPose) {
+        // Poses already queued are still delivered, then the function goes away
+        napi_release_threadsafe_function(wrap->onPose, napi_tsfn_release);
+        wrap->onPose = nullptr;
+    }
+}
+
+void finalizeTracker(napi_env /*env*/, void* data, void* /*hint*/) {
+    TrackerWrap* wrap = static_cast<TrackerWrap*>(data);
+    stopTracker(wrap);
+    ft_destroy(wrap->tracker);
+    delete wrap;
+}
+
+// Parse up to `count` arguments and the wrapped tracker
+TrackerWrap* unwrap(napi_env env, napi_callback_info info, size_t& count, napi_value* args) {
+    napi_value self;
+    void* data = nullptr;
+    if (napi_get_cb_info(env, info, &count, args, &self, nullptr) != napi_ok ||
+        napi_unwrap(env, self, &data) != napi_ok) {
+        napi_throw_error(env, nullptr, "Tracker method called on a non-Tracker object");
+        return nullptr;
+    }
+    return static_cast<TrackerWrap*>(data);
+}
+
+// Optional string argument (undefined/null -> empty)
+bool getString(napi_env env, napi_value value, std::string& out) {
+    napi_valuetype type;
+    napi_typeof(env, value, &type);
+    if (type == napi_undefined || type == napi_null) {
+        out.clear();
+        return true;
+    }
+    size_t length = 0;
+    if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok) {
+        napi_throw_type_error(env, nullptr, "Expected a JSON string");
+        return false;
+    }
+    out.resize(length);
+    napi_get_value_string_utf8(env, value, &out[0], length + 1, &length);
+    return true;
+}
+
+void throwTrackerError(napi_env env, TrackerWrap* wrap) {
+    napi_throw_error(env, nullptr, ft_last_error(wrap->tracker));
+}
+
+// new Tracker(configJson?)
+napi_value trackerNew(napi_env env, napi_callback_info info) {
+    size_t count = 1;
+    napi_value args[1], self;
+    NAPI_CALL(env, napi_get_cb_info(env, info, &count, args, &self, nullptr));
+    std::string json;
+    if (count > 0 && !getString(env, args[0], json)) {
+        return nullptr;
+    }
+
+    TrackerWrap* wrap = new TrackerWrap();
+    wrap->tracker = ft_create(json.c_str());
+    if (!wrap->tracker) {
+        delete wrap;
+        napi_throw_error(env, nullptr, "Invalid face tracker config JSON");
+        return nullptr;
+    }
+    if (napi_wrap(env, self, wrap, finalizeTracker, nullptr, nullptr) != napi_ok) {
+        ft_destroy(wrap->tracker);
+        delete wrap;
+        napi_throw_error(env, nullptr, "Could not wrap the tracker");
+        return nullptr;
+    }
+    return self;
+}
+
+// Worker thread: model loading and camera open take seconds, keep them off the event loop
+void executeStart(napi_env /*env*/, void* data) {
+    TrackerWrap* wrap = static_cast<TrackerWrap*>(data);
+    wrap->startFailed = ft_start(wrap->tracker, onNativePose, wrap) != 0;
+}
+
+void completeStart(napi_env env, napi_status status, void* data) {
+    TrackerWrap* wrap = static_cast<TrackerWrap*>(data);
+    napi_deferred deferred = wrap->startDeferred;
+    napi_delete_async_work(env, wrap->startWork);
+    napi_delete_reference(env, wrap->startSelf);
+    wrap->startWork = nullptr;
+    wrap->startDeferred = nullptr;
+    wrap->startSelf = nullptr;
+
+    napi_value result;
+    if (status != napi_ok || wrap->startFailed) {
+        napi_release_threadsafe_function(wrap->onPose, napi_tsfn_abort);
+        wrap->onPose = nullptr;
+        napi_value message;
+        napi_create_string_utf8(env, status != napi_ok ? "start cancelled" : ft_last_error(wrap->tracker),
+                                NAPI_AUTO_LENGTH, &message);
+        napi_create_error(env, nullptr, message, &result);
+        napi_reject_deferred(env, deferred, result);
+        return;
+    }
+    if (wrap->stopRequested) {
+        stopTracker(wrap);
+    }
+    napi_get_undefined(env, &result);
+    napi_resolve_deferred(env, deferred, result);
+}
+
+// tracker.start(onPose): Promise, resolved once the camera is tracking
+napi_value trackerStart(napi_env env, napi_callback_info info) {
+    size_t count = 1;
+    napi_value args[1];
+    TrackerWrap* wrap = unwrap(env, info, count, args);
+    if (!wrap) {
+        return nullptr;
+    }
+    napi_valuetype type = napi_undefined;
+    if (count > 0) {
+        napi_typeof(env, args[0], &type);
+    }
+    if (type != napi_function) {
+        napi_throw_type_error(env, nullptr, "start() expects an onPose callback");
+        return nullptr;
+    }
+    if (wrap->onPose) {
+        napi_throw_error(env, nullptr, "Face tracker is already running");
+        return nullptr;
+    }
+
+    napi_value self, name, promise;
+    size_t none = 0;
+    NAPI_CALL(env, napi_get_cb_info(env, info, &none, nullptr, &self, nullptr));
+    NAPI_CALL(env, napi_create_reference(env, self, 1, &wrap->startSelf));
+    napi_create_string_utf8(env, "facetracker.onPose", NAPI_AUTO_LENGTH, &name);
+    NAPI_CALL(env, napi_create_threadsafe_function(env, args[0], nullptr, name, POSE_QUEUE_SIZE, 1,
+                                                   nullptr, nullptr, nullptr, callPose, &wrap->onPose));
+    wrap->dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(wrap->errorMutex);
+        wrap->error.clear();
+    }
+    wrap->startFailed = false;
+    wrap->stopRequested = false;
+    NAPI_CALL(env, napi_create_promise(env, &wrap->startDeferred, &promise));
+    NAPI_CALL(env, napi_create_async_work(env, nullptr, name, executeStart, completeStart, wrap, &wrap->startWork));
+    NAPI_CALL(env, napi_queue_async_work(env, wrap->startWork));
+    return promise;
+}
+
+// tracker.stop(): no onPose call is made for frames after this returns
+napi_value trackerStop(napi_env env, napi_callback_info info) {
+    size_t count = 0;
+    TrackerWrap* wrap = unwrap(env, info, count, nullptr);
+    if (wrap && wrap->startWork) {
+        wrap->stopRequested = true; // Stopped as soon as start() completes
+    } else if (wrap) {
+        stopTracker(wrap);
+    }
+    return nullptr;
+}
+
+// tracker.updateConfig(configJson)
+napi_value trackerUpdateConfig(napi_env env, napi_callback_info info) {
+    size_t count = 1;
+    napi_value args[1];
+    TrackerWrap* wrap = unwrap(env, info, count, args);
+    std::string json;
+    if (!wrap || count < 1 || !getString(env, args[0], json)) {
+        return nullptr;
+    }
+    if (ft_update_config(wrap->tracker, json.c_str()) != 0) {
+        throwTrackerError(env, wrap);
+    }
+    return nullptr;
+}
+
+// tracker.processFrame(bgr: Buffer, width, height, stride?) -> pose (no camera, caller's thread)
+napi_value trackerProcessFrame(napi_env env, napi_callback_info info) {
+    size_t count = 4;
+    napi_value args[4];
+    TrackerWrap* wrap = unwrap(env, info, count, args);
+    if (!wrap) {
+        return nullptr;
+    }
+    if (wrap->onPose) {
+        napi_throw_error(env, nullptr, "processFrame() is not available while the tracker runs its camera");
+        return nullptr;
+    }
+    void* data = nullptr;
+    size_t length = 0;
+    int32_t width = 0, height = 0, stride = 0;
+    bool isBuffer = false;
+    if (count >= 3) {
+        napi_is_buffer(env, args[0], &isBuffer);
+    }
+    if (!isBuffer || napi_get_buffer_info(env, args[0], &data, &length) != napi_ok ||
+        napi_get_value_int32(env, args[1], &width) != napi_ok ||
+        napi_get_value_int32(env, args[2], &height) != napi_ok ||
+        (count >= 4 && napi_get_value_int32(env, args[3], &stride) != napi_ok)) {
+        napi_throw_type_error(env, nullptr, "processFrame(bgr: Buffer, width, height, stride?)");
+        return nullptr;
+    }
+    size_t rowBytes = stride > 0 ? static_cast<size_t>(stride) : static_cast<size_t>(width) * 3;
+    if (width <= 0 || height <= 0 || length < rowBytes * static_cast<size_t>(height)) {
+        napi_throw_range_error(env, nullptr, "Buffer is smaller than the frame");
+        return nullptr;
+    }
+
+    ft_pose pose;
+    if (ft_process_frame(wrap->tracker, static_cast<const uint8_t*>(data), width, height, stride, 0, &pose) != 0) {
+        throwTrackerError(env, wrap);
+        return nullptr;
+    }
+    return poseToObject(env, pose, pose.gesture, pose.error);
+}
+
+// tracker.droppedPoses(): poses skipped because JavaScript fell behind
+napi_value trackerDroppedPoses(napi_env env, napi_callback_info info) {
+    size_t count = 0;
+    TrackerWrap* wrap = unwrap(env, info, count, nullptr);
+    if (!wrap) {
+        return nullptr;
+    }
+    napi_value result;
+    NAPI_CALL(env, napi_create_double(env, static_cast<double>(wrap->dropped.load()), &result));
+    return result;
+}
+
+// tracker.error(): why tracking stopped on its own ('' while it runs fine)
+napi_value trackerError(napi_env env, napi_callback_info info) {
+    size_t count = 0;
+    TrackerWrap* wrap = unwrap(env, info, count, nullptr);
+    if (!wrap) {
+        return nullptr;
+    }
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(wrap->errorMutex);
+        error = wrap->error;
+    }
+    napi_value result;
+    NAPI_CALL(env, napi_create_string_utf8(env, error.c_str(), error.size(), &result));
+    return result;
+}
+
+} // namespace
+
+NAPI_MODULE_INIT() {
+    napi_property_descriptor methods[] = {
+        {"start", nullptr, trackerStart, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"stop", nullptr, trackerStop, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"updateConfig", nullptr, trackerUpdateConfig, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"processFrame", nullptr, trackerProcessFrame, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"droppedPoses", nullptr, trackerDroppedPoses, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"error", nullptr, trackerError, nullptr, nullptr, nullptr, napi_default, nullptr},
+    };
+    napi_value tracker, version;
+    NAPI_CALL(env, napi_define_class(env, "Tracker", NAPI_AUTO_LENGTH, trackerNew, nullptr,
+                                     sizeof(methods) / sizeof(methods[0]), methods, &tracker));
+    NAPI_CALL(env, napi_set_named_property(env, exports, "Tracker", tracker));
+    NAPI_CALL(env, napi_create_int32(env, ft_api_version(), &version));
+    NAPI_CALL(env, napi_set_named_property(env, exports, "apiVersion", version));
+    return exports;
+}
@@ -0,0 +1,267 @@
+#ifdef _WIN32
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+#endif
+
+#include "osc_control.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #define closeSocket(s) closesocket(s)
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    #define closeSocket(s) close(s)
+#endif
+
+static const char* OSC_CONTROL_PREFIX = "/tracker/";
+
+// Short names for fields operators touch most during a show
+static const struct { const char* alias; const char* field; } OSC_CONTROL_ALIASES[] = {
+    {"smoothing", "smoothingFactor"},
+    {"velocity", "maxVelocity"},
+    {"hysteresis", "outputHysteresis"},
+};
+
+// The only fields OSC may change: numeric show parameters and channel numbers.
+// Anything that names a file, socket or URL stays out of reach of the UDP port.
+static const char* OSC_CONTROL_FIELDS[] = {
+    "smoothingFactor", "maxVelocity", "updateRate",
+    "panChannel", "tiltChannel", "irisChannel", "zoomChannel", "focusChannel",
+    "panSensitivity", "tiltSensitivity", "panOffset", "tiltOffset",
+    "irisValue", "zoomValue", "focusValue",
+    "brightness", "contrast", "cameraExposure", "cameraBrightness", "autoExposure",
+    "panMin", "panMax", "tiltMin", "tiltMax", "irisMin", "irisMax",
+    "zoomMin", "zoomMax", "focusMin", "focusMax",
+    "panScale", "tiltScale", "panDeadZone", "tiltDeadZone",
+    "panLimit", "tiltLimit", "panGear", "tiltGear",
+    "outputHysteresis", "keyframeInterval",
+};
+
+// Only the first few rejected messages are logged (a misconfigured controller can send hundreds per second)
+static const uint64_t OSC_CONTROL_LOG_LIMIT = 10;
+
+static uint32_t readBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static uint64_t readBigEndian64(const uint8_t* p) {
+    return (static_cast<uint64_t>(readBigEndian32(p)) << 32) | readBigEndian32(p + 4);
+}
+
+// Read a null-terminated, 4-byte padded OSC string; returns bytes consumed (0 = malformed)
+static size_t readOSCString(const uint8_t* data, size_t size, const char*& text) {
+    const void* end = std::memchr(data, 0, size);
+    if (!end) return 0;
+    size_t length = static_cast<const uint8_t*>(end) - data;
+    size_t padded = (length + 4) & ~static_cast<size_t>(3);
+    if (padded > size) return 0;
+    text = reinterpret_cast<const char*>(data);
+    return padded;
+}
+
+// Field for an OSC setting name; nullptr unless it is on OSC_CONTROL_FIELDS
+static const ConfigField* findControlField(const char* name) {
+    for (const auto& alias : OSC_CONTROL_ALIASES) {
+        if (std::strcmp(name, alias.alias) == 0) {
+            name = alias.field;
+            break;
+        }
+    }
+    for (const char* allowed : OSC_CONTROL_FIELDS) {
+        if (std::strcmp(name, allowed) == 0) {
+            return findConfigField(name);
+        }
+    }
+    return nullptr;
+}
+
+// Keep DMX channel numbers in the universe: 1-512, or 0 (off) for iris/zoom/focus
+static void clampChannel(const ConfigField& field, double& number) {
+    bool panTilt = std::strcmp(field.name, "panChannel") == 0 || std::strcmp(field.name, "tiltChannel") == 0;
+    if (panTilt || std::strstr(field.name, "Channel")) {
+        number = std::max(panTilt ? 1.0 : 0.0, std::min(512.0, number));
+    }
+}
+
+OscControlServer::~OscControlServer() {
+    stop();
+}
+
+bool OscControlServer::start(int port, const std::string& bindAddress) {
+    if (running_) return true;
+
+#ifdef _WIN32
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+#else
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+#endif
+        std::cerr << "Failed to create OSC control socket" << std::endl;
+        return false;
+    }
+
+    // Loopback unless configured otherwise: messages are not authenticated, so
+    // opening the port to the show network (0.0.0.0) is an explicit choice
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Invalid OSC control bind address: " << bindAddress << std::endl;
+        closeSocket(sock);
+        return false;
+    }
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "Failed to bind OSC control port " << bindAddress << ":" << port << std::endl;
+        closeSocket(sock);
+        return false;
+    }
+
+    // Receive timeout so stop() is noticed promptly
+#ifdef _WIN32
+    DWORD timeout = 200;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 200000;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#endif
+
+    socket_ = static_cast<intptr_t>(sock);
+    running_ = true;
+    thread_ = std::thread(&OscControlServer::run, this);
+    std::cout << "OSC control listening on UDP " << bindAddress << ":" << port << " (" << OSC_CONTROL_PREFIX << "<setting>)" << std::endl;
+    return true;
+}
+
+void OscControlServer::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    closeSocket(socket_);
+    socket_ = -1;
+}
+
+void OscControlServer::run() {
+    uint8_t buffer[2048];
+    while (running_) {
+#ifdef _WIN32
+        int received = recv(static_cast<SOCKET>(socket_), (char*)buffer, sizeof(buffer), 0);
+#else
+        ssize_t received = recv(static_cast<int>(socket_), buffer, sizeof(buffer), 0);
+#endif
+        if (received <= 0) continue; // Timeout or error; re-check running_
+        handlePacket(buffer, static_cast<size_t>(received), 0);
+    }
+}
+
+void OscControlServer::handlePacket(const uint8_t* data, size_t size, int depth) {
+    // Bundle: "#bundle", 8-byte time tag, then (int32 size, element) pairs
+    if (size >= 16 && std::memcmp(data, "#bundle", 8) == 0) {
+        if (depth > 4) return;
+        size_t offset = 16;
+        while (offset + 4 <= size) {
+            uint32_t elementSize = readBigEndian32(data + offset);
+            offset += 4;
+            if (elementSize > size - offset) break;
+            handlePacket(data + offset, elementSize, depth + 1);
+            offset += elementSize;
+        }
+        return;
+    }
+    handleMessage(data, size);
+}
+
+void OscControlServer::handleMessage(const uint8_t* data, size_t size) {
+    received_++;
+
+    const char* address = nullptr;
+    size_t offset = readOSCString(data, size, address);
+    const char* typeTags = nullptr;
+    size_t tagBytes = offset ? readOSCString(data + offset, size - offset, typeTags) : 0;
+    size_t prefixLength = std::strlen(OSC_CONTROL_PREFIX);
+
+    const ConfigField* field = nullptr;
+    if (offset && std::strncmp(address, OSC_CONTROL_PREFIX, prefixLength) == 0) {
+        field = findControlField(address + prefixLength);
+    }
+
+    ControlUpdate update;
+    update.field = field;
+    bool valid = field && field->type != CONFIG_STRING && tagBytes && typeTags[0] == ',' && typeTags[1] != 0;
+
+    if (valid) {
+        offset += tagBytes;
+        const uint8_t* arg = data + offset;
+        size_t remaining = size - offset;
+        switch (typeTags[1]) {
+            case 'f':
+                if (remaining < 4) { valid = false; break; }
+                {
+                    uint32_t bits = readBigEndian32(arg);
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    update.number = value;
+                }
+                break;
+            case 'd':
+                if (remaining < 8) { valid = false; break; }
+                {
+                    uint64_t bits = readBigEndian64(arg);
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    update.number = value;
+                }
+                break;
+            case 'i':
+                if (remaining < 4) { valid = false; break; }
+                update.number = static_cast<int32_t>(readBigEndian32(arg));
+                break;
+            case 'h':
+                if (remaining < 8) { valid = false; break; }
+                update.number = static_cast<double>(static_cast<int64_t>(readBigEndian64(arg)));
+                break;
+            case 'T':
+                update.number = 1.0;
+                break;
+            case 'F':
+                update.number = 0.0;
+                break;
+            default:
+                valid = false; // Strings included: no string field is controllable
+                break;
+        }
+    }
+
+    if (!valid) {
+        uint64_t rejected = ++rejected_;
+        if (rejected <= OSC_CONTROL_LOG_LIMIT) {
+            std::cerr << "OSC control: ignoring " << (offset ? address : "(malformed packet)");
+            if (offset && !field) {
+                std::cerr << " (not an OSC-controllable setting)";
+            }
+            std::cerr << std::endl;
+        }
+        return;
+    }
+
+    clampChannel(*field, update.number);
+    if (!queue_.push(update)) {
+        dropped_++;
+    }
+}
@@ -0,0 +1,64 @@
+// OSC control input for live parameter changes
+//
+// Listens on a UDP port (loopback unless oscControlBind says otherwise) for
+// OSC messages addressed to /tracker/<field>, where <field> is one of the
+// numeric show parameters on the allowlist in osc_control.cpp (smoothing,
+// sensitivity, ranges, rigging, DMX channels...) or a short alias such as
+// /tracker/smoothing. Paths and URLs cannot be changed over OSC, and channel
+// numbers are clamped to 1-512 (0 = off for iris/zoom/focus).
+//
+// Messages are decoded on the listener thread and handed to the tracking
+// thread through a lock-free SPSC queue; the tracking thread drains it at the
+// start of every frame, so a change takes effect within one frame and Config
+// is only ever written by the tracking thread.
+//
+// Accepted argument types: f, i, d, h, T and F. Numbers are converted to
+// the field's type (non-zero = true for bool fields). Bundles are unpacked.
+#pragma once
+
+#include "config.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// One decoded parameter change (fixed size, no allocation on the listener thread)
+struct ControlUpdate {
+    const ConfigField* field = nullptr;
+    double number = 0.0;
+};
+
+class OscControlServer {
+public:
+    OscControlServer() = default;
+    ~OscControlServer();
+    OscControlServer(const OscControlServer&) = delete;
+    OscControlServer& operator=(const OscControlServer&) = delete;
+
+    // bindAddress: IPv4 address to listen on ("0.0.0.0" = all interfaces)
+    bool start(int port, const std::string& bindAddress);
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // Tracking thread: next pending change, if any
+    bool poll(ControlUpdate& update) { return queue_.pop(update); }
+
+    uint64_t receivedCount() const { return received_; }
+    uint64_t rejectedCount() const { return rejected_; }
+    uint64_t droppedCount() const { return dropped_; }
+
+private:
+    void run();
+    void handlePacket(const uint8_t* data, size_t size, int depth);
+    void handleMessage(const uint8_t* data, size_t size);
+
+    std::atomic<bool> running_{false};
+    intptr_t socket_ = -1;
+    std::thread thread_;
+    SpscQueue<ControlUpdate, 256> queue_;
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> rejected_{0}; // Unknown address or unusable argument
+    std::atomic<uint64_t> dropped_{0};  // Queue full (tracking thread stalled)
+};
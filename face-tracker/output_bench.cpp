@@ -0,0 +1,214 @@
+// Output path microbenchmarks - smoothing, gestures, DMX mapping, OSC/JSON encoding
+//
+// Usage: face-tracker-output-bench [--min-time MS] [--filter TEXT] [--json]
+//
+// Every function here runs once per pose update. Each case is timed with
+// allocation counting off (median of 5 runs), then run again with a counting
+// operator new to report heap allocations and bytes per call. --json prints
+// one document for regression tracking instead of the table:
+//
+//   {"benchmark": "face-tracker-output-bench", "schema": 1, "results": [
+//     {"name": "mapToDmx", "iterations": 4194304, "ns_per_op": 2.41,
+//      "allocs_per_op": 0, "bytes_per_op": 0}, ...]}
+//
+// Case names and keys are stable; compare runs with the same build type.
+// Built with -DFACE_TRACKER_BUILD_BENCHMARKS=ON.
+#include "pose_output.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// Counting allocator (single-threaded benchmark, so plain counters)
+static bool countAllocations = false;
+static uint64_t allocationCount = 0;
+static uint64_t allocationBytes = 0;
+
+void* operator new(std::size_t size) {
+    if (countAllocations) {
+        allocationCount++;
+        allocationBytes += size;
+    }
+    void* p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static volatile int sink = 0; // Keeps results alive past the optimizer
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+};
+
+template <typename Body>
+static double timeRun(Body& body, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        body(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Body>
+static BenchResult runCase(const char* name, double minTimeMs, Body body) {
+    BenchResult result;
+    result.name = name;
+
+    // Grow the batch until one run takes a fifth of the time budget
+    uint64_t iterations = 1024;
+    while (timeRun(body, iterations) < minTimeMs * 1e6 / 5 && iterations < (1ull << 32)) {
+        iterations *= 2;
+    }
+    std::vector<double> runs;
+    for (int run = 0; run < 5; run++) {
+        runs.push_back(timeRun(body, iterations) / static_cast<double>(iterations));
+    }
+    std::sort(runs.begin(), runs.end());
+    result.iterations = iterations;
+    result.nsPerOp = runs[runs.size() / 2];
+
+    const uint64_t counted = 4096;
+    allocationCount = 0;
+    allocationBytes = 0;
+    countAllocations = true;
+    timeRun(body, counted);
+    countAllocations = false;
+    result.allocsPerOp = static_cast<double>(allocationCount) / counted;
+    result.bytesPerOp = static_cast<double>(allocationBytes) / counted;
+    return result;
+}
+
+// Pose-like input: a slow sweep with jitter, 1024 samples in -1..1
+static std::vector<float> makePoses() {
+    std::vector<float> poses(1024);
+    for (size_t i = 0; i < poses.size(); i++) {
+        poses[i] = 0.8f * std::sin(i * 0.01f) + 0.02f * std::sin(i * 1.7f);
+    }
+    return poses;
+}
+
+int main(int argc, char** argv) {
+    double minTimeMs = 200.0;
+    std::string filter;
+    bool json = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minTimeMs = std::max(1.0, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--min-time MS] [--filter TEXT] [--json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const std::vector<float> poses = makePoses();
+    const size_t mask = poses.size() - 1;
+    Config config;
+    config.panDeadZone = 0.05f;
+    config.tiltDeadZone = 0.05f;
+
+    // 30 samples (gestureHistorySize): a slow drift that matches no gesture, so
+    // every check runs to the end, and a head shake that returns early
+    std::vector<float> steadyPan, steadyTilt, shakePan, shakeTilt;
+    for (int i = 0; i < 30; i++) {
+        steadyPan.push_back(0.1f + 0.002f * i);
+        steadyTilt.push_back(-0.05f + 0.001f * i);
+        shakePan.push_back(i % 4 < 2 ? 0.3f : -0.3f);
+        shakeTilt.push_back(0.0f);
+    }
+
+    const int channels[5] = {1, 2, 3, 4, 5};
+    const int values[5] = {128, 140, 255, 64, 32};
+    const bool twoChannels[5] = {true, true, false, false, false};
+    const bool allChannels[5] = {true, true, true, true, true};
+    const std::string oscPath = "/dmx/pan";
+    std::vector<uint8_t> buffer;
+    buffer.reserve(64);
+
+    std::vector<BenchResult> results;
+    auto add = [&](const char* name, auto body) {
+        if (filter.empty() || std::strstr(name, filter.c_str())) {
+            results.push_back(runCase(name, minTimeMs, body));
+        }
+    };
+
+    float current = 0.0f;
+    float velocity = 0.0f;
+    add("smoothWithVelocity", [&](uint64_t i) {
+        smoothWithVelocity(current, poses[i & mask], velocity, 0.7f, 0.5f);
+        sink = static_cast<int>(current * 1000.0f);
+    });
+    add("mapToDmx", [&](uint64_t i) {
+        int pan = 0, tilt = 0;
+        mapToDmx(poses[i & mask], poses[(i + 256) & mask], config, pan, tilt);
+        sink = pan + tilt;
+    });
+    add("detectGesture/none", [&](uint64_t) {
+        sink = static_cast<int>(detectGesture(steadyPan, steadyTilt, 0.0f, 0.0f).size());
+    });
+    add("detectGesture/shaking", [&](uint64_t) {
+        sink = static_cast<int>(detectGesture(shakePan, shakeTilt, 0.0f, 0.0f).size());
+    });
+    add("padOSCString", [&](uint64_t) {
+        buffer.clear();
+        padOSCString(buffer, oscPath);
+        sink = static_cast<int>(buffer.size());
+    });
+    add("encodeOSCFloat/reused", [&](uint64_t i) {
+        encodeOSCFloat(buffer, oscPath, poses[i & mask]);
+        sink = buffer[buffer.size() - 1];
+    });
+    add("encodeOSCFloat/fresh", [&](uint64_t i) {
+        std::vector<uint8_t> message; // As sendOSCMessage() does per call
+        encodeOSCFloat(message, oscPath, poses[i & mask]);
+        sink = message[message.size() - 1];
+    });
+    add("buildDmxPayload/2ch", [&](uint64_t) {
+        sink = static_cast<int>(buildDmxPayload(channels, values, twoChannels, 5).size());
+    });
+    add("buildDmxPayload/5ch", [&](uint64_t) {
+        sink = static_cast<int>(buildDmxPayload(channels, values, allChannels, 5).size());
+    });
+
+    if (json) {
+        std::printf("{\"benchmark\": \"face-tracker-output-bench\", \"schema\": 1, \"results\": [");
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            std::printf("%s\n  {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                        "\"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f}",
+                        i ? "," : "", r.name.c_str(), static_cast<unsigned long long>(r.iterations),
+                        r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+        }
+        std::printf("\n]}\n");
+    } else {
+        std::printf("%-24s %12s %10s %10s\n", "case", "ns/op", "allocs/op", "bytes/op");
+        for (const BenchResult& r : results) {
+            std::printf("%-24s %12.2f %10.2f %10.1f\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+        }
+    }
+    return 0;
+}
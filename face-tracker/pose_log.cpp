@@ -0,0 +1,143 @@
+#include "pose_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static const char* const GESTURE_NAMES[] = {
+    "", "NODDING", "SHAKING", "LOOKING_UP", "LOOKING_DOWN", "LOOKING_LEFT", "LOOKING_RIGHT"
+};
+static const uint8_t GESTURE_COUNT = sizeof(GESTURE_NAMES) / sizeof(GESTURE_NAMES[0]);
+
+uint8_t poseLogGestureCode(const std::string& gesture) {
+    for (uint8_t code = 1; code < GESTURE_COUNT; code++) {
+        if (gesture == GESTURE_NAMES[code]) {
+            return code;
+        }
+    }
+    return 0;
+}
+
+const char* poseLogGestureName(uint8_t code) {
+    return code < GESTURE_COUNT ? GESTURE_NAMES[code] : "";
+}
+
+PoseLogWriter::~PoseLogWriter() {
+    close();
+}
+
+bool PoseLogWriter::open(const std::string& path) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "Error: Could not create pose log " << path << std::endl;
+        return false;
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, 64 * 1024);
+
+    PoseLogHeader header;
+    header.startUnixUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::fwrite(&header, sizeof(header), 1, file_);
+
+    path_ = path;
+    start_ = std::chrono::steady_clock::now();
+    written_ = 0;
+    dropped_ = 0;
+    running_ = true;
+    thread_ = std::thread(&PoseLogWriter::writerLoop, this);
+    std::cout << "Recording poses to " << path << std::endl;
+    return true;
+}
+
+void PoseLogWriter::close() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    drain(); // Anything queued after the writer's last pass
+    std::fclose(file_);
+    file_ = nullptr;
+    std::cout << "Pose log " << path_ << ": " << written_ << " records";
+    if (dropped_ > 0) {
+        std::cout << " (" << dropped_ << " dropped)";
+    }
+    std::cout << std::endl;
+}
+
+void PoseLogWriter::append(PoseLogRecord record) {
+    record.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+    if (!queue_.push(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t PoseLogWriter::drain() {
+    size_t count = 0;
+    PoseLogRecord record;
+    while (queue_.pop(record)) {
+        std::fwrite(&record, sizeof(record), 1, file_);
+        count++;
+    }
+    if (count > 0) {
+        std::fflush(file_); // A crash loses at most one batch
+        written_.fetch_add(count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void PoseLogWriter::writerLoop() {
+    // Poses arrive at most at camera rate: batching every 50 ms keeps writes few and large
+    while (running_) {
+        drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+PoseLogReader::~PoseLogReader() {
+    close();
+}
+
+bool PoseLogReader::open(const std::string& path) {
+    close();
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) {
+        std::cerr << "Error: Could not open pose log " << path << std::endl;
+        return false;
+    }
+    if (std::fread(&header_, sizeof(header_), 1, file_) != 1 ||
+        std::memcmp(header_.magic, "FTPL", 4) != 0 ||
+        header_.headerSize < sizeof(PoseLogHeader) || header_.recordSize < sizeof(PoseLogRecord)) {
+        std::cerr << "Error: " << path << " is not a pose log" << std::endl;
+        close();
+        return false;
+    }
+    if (header_.version > POSE_LOG_VERSION) {
+        std::cerr << "Warning: " << path << " is pose log version " << header_.version
+                  << ", reading the fields this version knows" << std::endl;
+    }
+    // Newer versions may grow the header or records; skip what we do not know
+    std::fseek(file_, header_.headerSize, SEEK_SET);
+    return true;
+}
+
+bool PoseLogReader::next(PoseLogRecord& record) {
+    if (!file_ || std::fread(&record, sizeof(record), 1, file_) != 1) {
+        return false; // End of log (or a partial record left by a crash)
+    }
+    if (header_.recordSize > sizeof(PoseLogRecord)) {
+        std::fseek(file_, header_.recordSize - sizeof(PoseLogRecord), SEEK_CUR);
+    }
+    return true;
+}
+
+void PoseLogReader::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
@@ -0,0 +1,119 @@
+// Binary pose log: record a tracking session, replay it without a camera
+//
+// File layout (host byte order, little-endian on every supported platform),
+// written append-only:
+//
+//   header   32 bytes  magic "FTPL", version, header/record sizes, start time
+//   record   32 bytes  per pose update (PoseLogRecord), in time order
+//
+// A session that ends abruptly leaves a valid log: the reader ignores a
+// trailing partial record.
+//
+// The tracking thread only copies a record into a lock-free queue; a writer
+// thread drains it to disk in batches, so a slow disk never stalls tracking
+// (records are dropped and counted if the queue ever fills).
+// face-tracker --replay <file> streams a log back through mapToDmx() and the
+// configured output (HTTP, OSC or binary stream).
+#pragma once
+
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+const uint32_t POSE_LOG_VERSION = 1;
+
+#pragma pack(push, 1)
+struct PoseLogHeader {
+    char magic[4] = {'F', 'T', 'P', 'L'};
+    uint16_t version = POSE_LOG_VERSION;
+    uint16_t headerSize = sizeof(PoseLogHeader);
+    uint16_t recordSize = 32;
+    uint16_t reserved0 = 0;
+    uint32_t reserved1 = 0;
+    int64_t startUnixUs = 0;    // Wall-clock start of the recording
+    uint64_t reserved2 = 0;
+};
+
+enum PoseLogFlags : uint8_t {
+    POSE_LOG_FACE = 1,          // A face was tracked (always set by the tracker)
+    POSE_LOG_LANDMARKS = 2,     // Pose came from facial landmarks
+    POSE_LOG_GESTURE = 4        // `gesture` holds a newly detected gesture
+};
+
+struct PoseLogRecord {
+    int64_t timeUs = 0;         // Since the recording started
+    float pan = 0.0f;           // Raw pose, -1..1
+    float tilt = 0.0f;
+    float smoothedPan = 0.0f;
+    float smoothedTilt = 0.0f;
+    uint8_t panDmx = 0;         // DMX values sent at the time
+    uint8_t tiltDmx = 0;
+    uint8_t flags = 0;          // PoseLogFlags
+    uint8_t gesture = 0;        // poseLogGestureCode(), 0 = none
+    uint32_t reserved = 0;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PoseLogHeader) == 32, "pose log header layout");
+static_assert(sizeof(PoseLogRecord) == 32, "pose log record layout");
+
+// "NODDING", "SHAKING", "LOOKING_UP", ... <-> 1-6 (0 = none/unknown)
+uint8_t poseLogGestureCode(const std::string& gesture);
+const char* poseLogGestureName(uint8_t code);
+
+class PoseLogWriter {
+public:
+    PoseLogWriter() = default;
+    ~PoseLogWriter();
+    PoseLogWriter(const PoseLogWriter&) = delete;
+    PoseLogWriter& operator=(const PoseLogWriter&) = delete;
+
+    // Create (truncate) `path` and start the writer thread
+    bool open(const std::string& path);
+    // Flushes everything queued, then closes the file
+    void close();
+    bool isOpen() const { return running_; }
+
+    // Tracking thread: stamp with the time since open() and queue (never blocks)
+    void append(PoseLogRecord record);
+
+    uint64_t writtenCount() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void writerLoop();
+    size_t drain();
+
+    FILE* file_ = nullptr;
+    std::string path_;
+    std::chrono::steady_clock::time_point start_;
+    SpscQueue<PoseLogRecord, 4096> queue_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+class PoseLogReader {
+public:
+    PoseLogReader() = default;
+    ~PoseLogReader();
+    PoseLogReader(const PoseLogReader&) = delete;
+    PoseLogReader& operator=(const PoseLogReader&) = delete;
+
+    // False (with a message) if the file is missing or not a pose log
+    bool open(const std::string& path);
+    // Next record; false at the end of the log
+    bool next(PoseLogRecord& record);
+    const PoseLogHeader& header() const { return header_; }
+    void close();
+
+private:
+    FILE* file_ = nullptr;
+    PoseLogHeader header_;
+};
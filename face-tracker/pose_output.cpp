@@ -0,0 +1,209 @@
+#include "pose_output.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// Detect gestures from head movement history
+std::string detectGesture(const std::vector<float>& panHistory, const std::vector<float>& tiltHistory,
+                          float /*currentPan*/, float /*currentTilt*/) {
+    // Need at least 10 frames of history
+    if (panHistory.size() < 10 || tiltHistory.size() < 10) {
+        return "";
+    }
+
+    // Calculate movement patterns
+    // For nodding: look for vertical (tilt) oscillation
+    // For shaking: look for horizontal (pan) oscillation
+
+    // Analyze recent tilt changes for nodding
+    float tiltRange = 0.0f;
+    int tiltDirectionChanges = 0;
+    float lastTiltDir = 0.0f;
+
+    for (size_t i = 1; i < tiltHistory.size(); i++) {
+        float tiltChange = tiltHistory[i] - tiltHistory[i-1];
+        float currentDir = (tiltChange > 0.05f) ? 1.0f : ((tiltChange < -0.05f) ? -1.0f : 0.0f);
+
+        if (currentDir != 0 && currentDir != lastTiltDir && lastTiltDir != 0) {
+            tiltDirectionChanges++;
+        }
+        if (currentDir != 0) lastTiltDir = currentDir;
+
+        tiltRange = std::max(tiltRange, std::abs(tiltChange));
+    }
+
+    // Analyze recent pan changes for head shaking
+    float panRange = 0.0f;
+    int panDirectionChanges = 0;
+    float lastPanDir = 0.0f;
+
+    for (size_t i = 1; i < panHistory.size(); i++) {
+        float panChange = panHistory[i] - panHistory[i-1];
+        float currentDir = (panChange > 0.05f) ? 1.0f : ((panChange < -0.05f) ? -1.0f : 0.0f);
+
+        if (currentDir != 0 && currentDir != lastPanDir && lastPanDir != 0) {
+            panDirectionChanges++;
+        }
+        if (currentDir != 0) lastPanDir = currentDir;
+
+        panRange = std::max(panRange, std::abs(panChange));
+    }
+
+    // Detect nodding (vertical oscillation with direction changes)
+    if (tiltDirectionChanges >= 2 && tiltRange > 0.1f) {
+        return "NODDING";
+    }
+
+    // Detect head shaking (horizontal oscillation with direction changes)
+    if (panDirectionChanges >= 2 && panRange > 0.1f) {
+        return "SHAKING";
+    }
+
+    // Detect looking up (sustained upward tilt)
+    if (tiltHistory.size() >= 10) {
+        float avgRecentTilt = 0.0f;
+        for (size_t i = tiltHistory.size() - 10; i < tiltHistory.size(); i++) {
+            avgRecentTilt += tiltHistory[i];
+        }
+        avgRecentTilt /= 10.0f;
+        if (avgRecentTilt < -0.3f) { // Looking up
+            return "LOOKING_UP";
+        }
+        if (avgRecentTilt > 0.3f) { // Looking down
+            return "LOOKING_DOWN";
+        }
+    }
+
+    // Detect looking left/right (sustained pan)
+    if (panHistory.size() >= 10) {
+        float avgRecentPan = 0.0f;
+        for (size_t i = panHistory.size() - 10; i < panHistory.size(); i++) {
+            avgRecentPan += panHistory[i];
+        }
+        avgRecentPan /= 10.0f;
+        if (avgRecentPan < -0.3f) { // Looking left
+            return "LOOKING_LEFT";
+        }
+        if (avgRecentPan > 0.3f) { // Looking right
+            return "LOOKING_RIGHT";
+        }
+    }
+
+    return "";
+}
+
+// Improved smoothing with velocity limiting
+void smoothWithVelocity(float& current, float target, float& velocity, float smoothing, float maxVel) {
+    // Calculate desired change
+    float error = target - current;
+
+    // Update velocity (with damping)
+    velocity = velocity * smoothing + error * (1.0f - smoothing);
+
+    // Limit velocity to max
+    if (velocity > maxVel) velocity = maxVel;
+    if (velocity < -maxVel) velocity = -maxVel;
+
+    // Apply velocity to current position
+    current += velocity;
+
+    // Optional: apply additional smoothing directly
+    current = current * smoothing + target * (1.0f - smoothing);
+}
+
+// Map head movement to DMX values (0-255) with rigging parameters
+void mapToDmx(const float pan, const float tilt, const Config& config, int& panValue, int& tiltValue) {
+    // Apply dead zone (ignore small movements)
+    float adjustedPan = pan;
+    float adjustedTilt = tilt;
+
+    if (std::abs(pan) < config.panDeadZone) {
+        adjustedPan = 0.0f;
+    } else {
+        // Remove dead zone from value
+        float sign = pan > 0 ? 1.0f : -1.0f;
+        adjustedPan = sign * (std::abs(pan) - config.panDeadZone) / (1.0f - config.panDeadZone);
+    }
+
+    if (std::abs(tilt) < config.tiltDeadZone) {
+        adjustedTilt = 0.0f;
+    } else {
+        float sign = tilt > 0 ? 1.0f : -1.0f;
+        adjustedTilt = sign * (std::abs(tilt) - config.tiltDeadZone) / (1.0f - config.tiltDeadZone);
+    }
+
+    // Apply rigging: scale, sensitivity, gear ratio, and limit
+    float panMovement = adjustedPan * config.panSensitivity * config.panScale / config.panGear * config.panLimit;
+    float tiltMovement = adjustedTilt * config.tiltSensitivity * config.tiltScale / config.tiltGear * config.tiltLimit;
+
+    // Convert from -1.0 to 1.0 range to 0-255, with offset
+    panValue = static_cast<int>(config.panOffset + (panMovement * 127.0f));
+    tiltValue = static_cast<int>(config.tiltOffset + (tiltMovement * 127.0f));
+
+    // Clamp to configured min/max ranges (not just 0-255)
+    panValue = std::max(config.panMin, std::min(config.panMax, panValue));
+    tiltValue = std::max(config.tiltMin, std::min(config.tiltMax, tiltValue));
+}
+
+// Failsafe pan/tilt: failsafePan/failsafeTilt when set, otherwise home (the mapped centre)
+void failsafePosition(const Config& config, int& panValue, int& tiltValue) {
+    mapToDmx(0.0f, 0.0f, config, panValue, tiltValue);
+    if (config.failsafePan >= 0) panValue = std::min(255, config.failsafePan);
+    if (config.failsafeTilt >= 0) tiltValue = std::min(255, config.failsafeTilt);
+}
+
+// Helper function to pad OSC string to 4-byte boundary
+void padOSCString(std::vector<uint8_t>& buffer, const std::string& str) {
+    for (char c : str) {
+        buffer.push_back(static_cast<uint8_t>(c));
+    }
+    buffer.push_back(0); // Null terminator
+    // Pad to 4-byte boundary
+    while (buffer.size() % 4 != 0) {
+        buffer.push_back(0);
+    }
+}
+
+// OSC message with one float argument: padded path, ",f" type tag, big-endian float
+void encodeOSCFloat(std::vector<uint8_t>& message, const std::string& path, float value) {
+    message.clear();
+
+    // OSC address pattern (path)
+    padOSCString(message, path);
+
+    // OSC type tag string (",f" for float)
+    padOSCString(message, ",f");
+
+    // Float value (big-endian 32-bit float)
+    union {
+        float f;
+        uint8_t bytes[4];
+    } floatUnion;
+    floatUnion.f = value;
+
+    // OSC uses big-endian byte order
+    #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        message.push_back(floatUnion.bytes[3]);
+        message.push_back(floatUnion.bytes[2]);
+        message.push_back(floatUnion.bytes[1]);
+        message.push_back(floatUnion.bytes[0]);
+    #else
+        message.push_back(floatUnion.bytes[0]);
+        message.push_back(floatUnion.bytes[1]);
+        message.push_back(floatUnion.bytes[2]);
+        message.push_back(floatUnion.bytes[3]);
+    #endif
+}
+
+// JSON body for the HTTP batch API: {"<channel - 1>": value} per transmitted slot
+std::string buildDmxPayload(const int channels[], const int values[], const bool transmit[], int count) {
+    nlohmann::json payload;
+    for (int i = 0; i < count; i++) {
+        if (transmit[i]) {
+            payload[std::to_string(channels[i] - 1)] = values[i];  // DMX channels are 0-indexed in API
+        }
+    }
+    return payload.dump();
+}
@@ -0,0 +1,34 @@
+// Pose to fixture output: smoothing, gestures, DMX mapping and the OSC/JSON
+// encodings sent per update
+//
+// These run at the full pose/output rate, so they live outside main.cpp where
+// face-tracker-output-bench can time them (and count their allocations).
+#pragma once
+
+#include "config.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// "NODDING", "SHAKING", "LOOKING_UP/DOWN/LEFT/RIGHT", or "" (needs 10+ samples)
+std::string detectGesture(const std::vector<float>& panHistory, const std::vector<float>& tiltHistory,
+                          float currentPan, float currentTilt);
+
+// Move `current` toward `target` with damped, velocity-limited smoothing
+void smoothWithVelocity(float& current, float target, float& velocity, float smoothing, float maxVel);
+
+// Normalized pan/tilt (-1..1) to DMX values with dead zone and rigging applied
+void mapToDmx(const float pan, const float tilt, const Config& config, int& panValue, int& tiltValue);
+
+// Failsafe pan/tilt: failsafePan/failsafeTilt when set, otherwise home (the mapped centre)
+void failsafePosition(const Config& config, int& panValue, int& tiltValue);
+
+// Append `str` NUL-terminated and padded to a 4-byte boundary (OSC string)
+void padOSCString(std::vector<uint8_t>& buffer, const std::string& str);
+
+// Replace `message` with an OSC message carrying one float argument
+void encodeOSCFloat(std::vector<uint8_t>& message, const std::string& path, float value);
+
+// HTTP batch API body for the slots with transmit[i] set
+std::string buildDmxPayload(const int channels[], const int values[], const bool transmit[], int count);
@@ -0,0 +1,115 @@
+#include "preprocess.h"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+// Rows per strip: a 640-wide BGR strip plus its gray rows (~80 KB) stays in L2
+static const int PREPROCESS_STRIP_ROWS = 32;
+
+void FramePreprocessor::updateAdjustLut(float brightness, float contrast) {
+    if (!adjustLut_.empty() && brightness == brightness_ && contrast == contrast_) {
+        return;
+    }
+    brightness_ = brightness;
+    contrast_ = contrast;
+
+    // Same arithmetic as convertTo(dst, -1, contrast, (brightness - 1) * 127)
+    adjustLut_.create(1, 256, CV_8U);
+    uchar* lut = adjustLut_.ptr<uchar>();
+    float offset = (brightness - 1.0f) * 127.0f;
+    identity_ = true;
+    for (int v = 0; v < 256; v++) {
+        lut[v] = cv::saturate_cast<uchar>(v * contrast + offset);
+        identity_ = identity_ && lut[v] == v;
+    }
+}
+
+// Output buffers may still point at a capture buffer the driver owns again
+// (V4L2 zero-copy frames); never write through such a header
+static void releaseIfBorrowed(cv::Mat& m) {
+    if (!m.u) m.release();
+}
+
+void FramePreprocessor::adjust(const cv::Mat& frame, float brightness, float contrast, cv::Mat& adjusted) {
+    updateAdjustLut(brightness, contrast);
+    if (identity_) {
+        adjusted = frame;
+    } else {
+        releaseIfBorrowed(adjusted);
+        cv::LUT(frame, adjustLut_, adjusted);
+    }
+}
+
+void FramePreprocessor::process(const cv::Mat& frame, float brightness, float contrast, cv::Mat& adjusted, cv::Mat& gray) {
+    if (frame.empty()) return;
+    updateAdjustLut(brightness, contrast);
+
+    cv::Mat source = frame; // Keeps the pixels alive if `adjusted` is `frame`
+    if (identity_) {
+        adjusted = source;
+    } else {
+        releaseIfBorrowed(adjusted);
+        adjusted.create(source.size(), source.type());
+    }
+    gray.create(source.size(), CV_8UC1);
+
+    // Four interleaved histograms avoid stalls on runs of equal pixels
+    int hist[4][256];
+    std::memset(hist, 0, sizeof(hist));
+
+    for (int y = 0; y < source.rows; y += PREPROCESS_STRIP_ROWS) {
+        int end = std::min(y + PREPROCESS_STRIP_ROWS, source.rows);
+        cv::Mat strip = adjusted.rowRange(y, end);
+        cv::Mat grayStrip = gray.rowRange(y, end);
+        if (!identity_) {
+            cv::LUT(source.rowRange(y, end), adjustLut_, strip);
+        }
+
+        if (strip.channels() == 3) {
+            cv::cvtColor(strip, grayStrip, cv::COLOR_BGR2GRAY);
+        } else if (strip.channels() == 4) {
+            cv::cvtColor(strip, grayStrip, cv::COLOR_BGRA2GRAY);
+        } else {
+            strip.copyTo(grayStrip);
+        }
+
+        for (int row = 0; row < grayStrip.rows; row++) {
+            const uchar* p = grayStrip.ptr<uchar>(row);
+            int x = 0;
+            for (; x + 4 <= grayStrip.cols; x += 4) {
+                hist[0][p[x]]++;
+                hist[1][p[x + 1]]++;
+                hist[2][p[x + 2]]++;
+                hist[3][p[x + 3]]++;
+            }
+            for (; x < grayStrip.cols; x++) {
+                hist[0][p[x]]++;
+            }
+        }
+    }
+
+    // Equalization table exactly as cv::equalizeHist builds it
+    equalizeLut_.create(1, 256, CV_8U);
+    uchar* lut = equalizeLut_.ptr<uchar>();
+    int total = source.rows * source.cols;
+    int counts[256];
+    for (int v = 0; v < 256; v++) {
+        counts[v] = hist[0][v] + hist[1][v] + hist[2][v] + hist[3][v];
+    }
+    int first = 0;
+    while (!counts[first]) first++;
+    if (counts[first] == total) {
+        gray.setTo(cv::Scalar(first));
+        return;
+    }
+    float scale = 255.0f / (total - counts[first]);
+    int sum = 0;
+    std::memset(lut, 0, first + 1);
+    for (int v = first + 1; v < 256; v++) {
+        sum += counts[v];
+        lut[v] = cv::saturate_cast<uchar>(sum * scale);
+    }
+    cv::LUT(gray, equalizeLut_, gray);
+}
@@ -0,0 +1,40 @@
+// Per-frame preprocessing: brightness/contrast, grayscale and equalization
+//
+// Replaces the convertTo (3 channels, float math) + cvtColor + equalizeHist
+// chain with one pass over the camera frame and one over the gray image:
+//
+//   - brightness/contrast is a 256-entry table (cv::LUT), rebuilt only when
+//     the settings change, and skipped entirely when it is the identity
+//   - the frame is walked in strips small enough to stay in cache: each
+//     strip is adjusted, converted to gray and added to the histogram
+//     before the next strip is touched
+//   - the equalization table is then applied to the gray image in place
+//
+// Results are identical to the old chain (same rounding as convertTo, same
+// equalization table as equalizeHist). preprocess_bench.cpp compares both.
+#pragma once
+
+#include <opencv2/core.hpp>
+
+class FramePreprocessor {
+public:
+    // `adjusted` gets the brightness/contrast-adjusted frame (shares `frame`'s
+    // pixels at identity settings); `gray` the equalized image for detection.
+    // `adjusted` may be the same Mat as `frame`.
+    void process(const cv::Mat& frame, float brightness, float contrast, cv::Mat& adjusted, cv::Mat& gray);
+
+    // Brightness/contrast only (same table), e.g. for a preview converted later
+    void adjust(const cv::Mat& frame, float brightness, float contrast, cv::Mat& adjusted);
+
+    // Gain/offset table is a no-op for the current settings
+    bool isIdentity() const { return identity_; }
+
+private:
+    void updateAdjustLut(float brightness, float contrast);
+
+    float brightness_ = 1.0f;
+    float contrast_ = 1.0f;
+    bool identity_ = true;
+    cv::Mat adjustLut_;   // 1x256 CV_8U
+    cv::Mat equalizeLut_; // 1x256 CV_8U
+};
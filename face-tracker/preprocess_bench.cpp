@@ -0,0 +1,108 @@
+// Preprocessing benchmark - FramePreprocessor vs the original per-frame chain
+//
+// Usage: face-tracker-preprocess-bench [--frames N] [--width W] [--height H]
+//
+// Runs both on the same synthetic camera frames at identity settings and at
+// a typical adjusted setting, checks that the outputs match and prints the
+// time per frame. Built with -DFACE_TRACKER_BUILD_BENCHMARKS=ON.
+#include "preprocess.h"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// The chain FramePreprocessor replaced (main.cpp before the fused stage)
+static void referenceChain(const cv::Mat& frame, float brightness, float contrast, cv::Mat& adjusted, cv::Mat& gray) {
+    frame.convertTo(adjusted, -1, contrast, (brightness - 1.0f) * 127.0f);
+    cv::cvtColor(adjusted, gray, cv::COLOR_BGR2GRAY);
+    cv::equalizeHist(gray, gray);
+}
+
+// Camera-like test frames: smooth gradients plus noise
+static std::vector<cv::Mat> makeFrames(int count, int width, int height) {
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < count; i++) {
+        cv::Mat frame(height, width, CV_8UC3);
+        for (int y = 0; y < height; y++) {
+            cv::Vec3b* row = frame.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < width; x++) {
+                row[x] = cv::Vec3b(static_cast<uchar>((x + i) % 256),
+                                   static_cast<uchar>((y * 2 + i) % 256),
+                                   static_cast<uchar>((x + y) / 4 % 256));
+            }
+        }
+        cv::Mat noise(height, width, CV_8UC3);
+        cv::randu(noise, cv::Scalar::all(0), cv::Scalar::all(32));
+        cv::add(frame, noise, frame);
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+static double msPerFrame(int64_t ticks, int frames) {
+    return ticks * 1000.0 / cv::getTickFrequency() / frames;
+}
+
+static void runCase(const char* name, const std::vector<cv::Mat>& frames, int iterations, float brightness, float contrast) {
+    cv::Mat adjusted, gray, refAdjusted, refGray;
+
+    // Outputs must match before timing means anything
+    FramePreprocessor preprocessor;
+    int mismatched = 0;
+    for (const cv::Mat& frame : frames) {
+        preprocessor.process(frame, brightness, contrast, adjusted, gray);
+        referenceChain(frame, brightness, contrast, refAdjusted, refGray);
+        cv::Mat diff;
+        cv::absdiff(gray, refGray, diff);
+        mismatched += cv::countNonZero(diff);
+        cv::absdiff(adjusted, refAdjusted, diff);
+        mismatched += cv::countNonZero(diff.reshape(1));
+    }
+
+    int64_t start = cv::getTickCount();
+    for (int i = 0; i < iterations; i++) {
+        referenceChain(frames[i % frames.size()], brightness, contrast, refAdjusted, refGray);
+    }
+    double referenceMs = msPerFrame(cv::getTickCount() - start, iterations);
+
+    start = cv::getTickCount();
+    for (int i = 0; i < iterations; i++) {
+        preprocessor.process(frames[i % frames.size()], brightness, contrast, adjusted, gray);
+    }
+    double fusedMs = msPerFrame(cv::getTickCount() - start, iterations);
+
+    std::cout << name << " (brightness " << brightness << ", contrast " << contrast << ")" << std::endl;
+    std::cout << "  original chain: " << referenceMs << " ms/frame" << std::endl;
+    std::cout << "  fused:          " << fusedMs << " ms/frame (" << referenceMs / fusedMs << "x)" << std::endl;
+    std::cout << "  mismatched pixels: " << mismatched << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int iterations = 2000;
+    int width = 640;
+    int height = 480;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--width" && i + 1 < argc) {
+            width = std::max(16, std::atoi(argv[++i]));
+        } else if (arg == "--height" && i + 1 < argc) {
+            height = std::max(16, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: face-tracker-preprocess-bench [--frames N] [--width W] [--height H]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<cv::Mat> frames = makeFrames(8, width, height);
+    std::cout << "Preprocessing " << width << "x" << height << ", " << iterations << " frames per run" << std::endl;
+    runCase("Identity", frames, iterations, 1.0f, 1.0f);
+    runCase("Adjusted", frames, iterations, 1.2f, 1.3f);
+    return 0;
+}
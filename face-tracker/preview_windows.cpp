@@ -0,0 +1,682 @@
+#include "preview_windows.h"
+
+#include "frame_trace.h"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace cv;
+
+// Window events are pumped at least this often, even between preview frames
+static const int PREVIEW_EVENT_INTERVAL_MS = 10;
+
+static int64_t nowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+// 3D to 2D projection with viewport rotation. The view's sines/cosines are
+// computed once here rather than for every projected vertex.
+struct ViewProjection {
+    float cosX, sinX; // Rotation around X axis (tilt)
+    float cosY, sinY; // Rotation around Y axis (pan)
+    float viewDist;
+    int centerX, centerY, scale;
+    
+    ViewProjection(float viewAngleX, float viewAngleY, float viewDist, int centerX, int centerY, int scale)
+        : cosX(std::cos(viewAngleX * CV_PI / 180.0f)), sinX(std::sin(viewAngleX * CV_PI / 180.0f)),
+          cosY(std::cos(viewAngleY * CV_PI / 180.0f)), sinY(std::sin(viewAngleY * CV_PI / 180.0f)),
+          viewDist(viewDist), centerX(centerX), centerY(centerY), scale(scale) {}
+    
+    Point operator()(float x, float y, float z) const {
+        float x1 = x * cosY - z * sinY;
+        float z1 = x * sinY + z * cosY;
+        float y1 = y * cosX - z1 * sinX;
+        float z2 = y * sinX + z1 * cosX;
+        
+        // Perspective projection
+        float perspective = 1.0f / (viewDist + z2 * 0.001f);
+        int px = centerX + static_cast<int>(x1 * scale * perspective);
+        int py = centerY - static_cast<int>(y1 * scale * perspective); // Flip Y for screen coordinates
+        return Point(px, py);
+    }
+};
+
+// Draw XYZ coordinate axes/lattice
+static void drawXYZAxes(Mat& canvas, const ViewProjection& project) {
+    // Draw coordinate axes (RGB = XYZ)
+    Point origin = project(0, 0, 0);
+    
+    // X axis (red) - horizontal
+    Point xEnd = project(0.3f, 0, 0);
+    line(canvas, origin, xEnd, Scalar(0, 0, 255), 2); // Red (BGR)
+    putText(canvas, "X", xEnd, FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 0, 255), 1);
+    
+    // Y axis (green) - vertical
+    Point yEnd = project(0, 0.3f, 0);
+    line(canvas, origin, yEnd, Scalar(0, 255, 0), 2); // Green (BGR)
+    putText(canvas, "Y", yEnd, FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 255, 0), 1);
+    
+    // Z axis (blue) - depth
+    Point zEnd = project(0, 0, 0.3f);
+    line(canvas, origin, zEnd, Scalar(255, 0, 0), 2); // Blue (BGR)
+    putText(canvas, "Z", zEnd, FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 0, 0), 1);
+    
+    // Draw grid lines on XY plane (at Z=0)
+    int gridSize = 5;
+    float gridSpacing = 0.1f;
+    Scalar gridColor(100, 100, 100);
+    
+    for (int i = -gridSize; i <= gridSize; i++) {
+        // Lines parallel to X axis
+        line(canvas, project(-gridSize * gridSpacing, 0, i * gridSpacing),
+             project(gridSize * gridSpacing, 0, i * gridSpacing), gridColor, 1);
+        
+        // Lines parallel to Z axis
+        line(canvas, project(i * gridSpacing, 0, -gridSize * gridSpacing),
+             project(i * gridSpacing, 0, gridSize * gridSpacing), gridColor, 1);
+    }
+}
+
+// Render rigging visualization preview only (configuration UI is now in React)
+// The layout is cached in `view` and only rebuilt when the clamp range changes
+static void renderRiggingPreview(Mat& canvas, RiggingView& view, const RiggingViewKey& key) {
+    float currentPan = key.pan / 1000.0f;
+    float currentTilt = key.tilt / 1000.0f;
+    int width = canvas.cols;
+    int height = canvas.rows;
+    
+    int x = 20;
+    int lineHeight = 22;
+    Scalar textColor(255, 255, 255);
+    Scalar headerColor(150, 200, 255);
+    
+    // Visualization area (below the title block)
+    int vizX = x + 20;
+    int vizY = 20 + lineHeight * 3 + 10;
+    int vizWidth = width - 2 * x - 40;
+    int vizHeight = height - vizY - 60;
+    int centerX = vizX + vizWidth / 2;
+    int centerY = vizY + vizHeight / 2;
+    
+    if (view.staticLayer.size() != canvas.size() ||
+        view.layerPanMin != key.panMin || view.layerPanMax != key.panMax) {
+        Mat& layer = view.staticLayer;
+        layer.create(canvas.size(), CV_8UC3);
+        
+        // Clear with dark background
+        layer = Scalar(30, 30, 40);
+        
+        int y = 20;
+        
+        // Title
+        putText(layer, "Face Movement -> DMX Mapping Preview", Point(x, y),
+               FONT_HERSHEY_DUPLEX, 0.7, headerColor, 2);
+        y += lineHeight * 2;
+        
+        putText(layer, "(Configure in React UI)", Point(x, y),
+               FONT_HERSHEY_SIMPLEX, 0.4, Scalar(150, 150, 150), 1);
+        
+        // Background for visualization
+        rectangle(layer, Point(vizX, vizY), Point(vizX + vizWidth, vizY + vizHeight), 
+                 Scalar(20, 20, 30), -1);
+        rectangle(layer, Point(vizX, vizY), Point(vizX + vizWidth, vizY + vizHeight), 
+                 Scalar(100, 100, 100), 1);
+        
+        // Horizontal axis (Pan)
+        line(layer, Point(vizX, centerY), Point(vizX + vizWidth, centerY), Scalar(100, 100, 100), 1);
+        putText(layer, "Pan (-1.0)", Point(vizX + 5, centerY - 5), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
+        putText(layer, "Pan (+1.0)", Point(vizX + vizWidth - 60, centerY - 5), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
+        
+        // Vertical axis (Tilt)
+        line(layer, Point(centerX, vizY), Point(centerX, vizY + vizHeight), Scalar(100, 100, 100), 1);
+        putText(layer, "Tilt (+1.0)", Point(centerX + 5, vizY + 15), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
+        putText(layer, "Tilt (-1.0)", Point(centerX + 5, vizY + vizHeight - 5), FONT_HERSHEY_SIMPLEX, 0.3, textColor, 1);
+        
+        // Draw range boxes (min/max limits)
+        int panMinX = vizX + static_cast<int>((key.panMin / 255.0f) * vizWidth);
+        int panMaxX = vizX + static_cast<int>((key.panMax / 255.0f) * vizWidth);
+        rectangle(layer, Point(vizX, vizY), Point(panMinX, vizY + vizHeight), 
+                 Scalar(50, 0, 0), -1); // Red for clamped min
+        rectangle(layer, Point(panMaxX, vizY), Point(vizX + vizWidth, vizY + vizHeight), 
+                 Scalar(50, 0, 0), -1); // Red for clamped max
+        
+        // Legend
+        putText(layer, "Legend: Yellow = Face Position | Green = DMX Output | Red = Clamped Range", 
+               Point(x, vizY + vizHeight + 15), FONT_HERSHEY_SIMPLEX, 0.35, textColor, 1);
+        
+        view.layerPanMin = key.panMin;
+        view.layerPanMax = key.panMax;
+    }
+    view.staticLayer.copyTo(canvas);
+    
+    // Draw current face position
+    if (key.faceDetected) {
+        // Map face position to visualization
+        int faceX = centerX + static_cast<int>(currentPan * (vizWidth / 2));
+        int faceY = centerY - static_cast<int>(currentTilt * (vizHeight / 2));
+        faceX = std::max(vizX, std::min(vizX + vizWidth, faceX));
+        faceY = std::max(vizY, std::min(vizY + vizHeight, faceY));
+        
+        // Draw face position indicator
+        circle(canvas, Point(faceX, faceY), 8, Scalar(0, 255, 255), -1); // Yellow circle
+        circle(canvas, Point(faceX, faceY), 8, Scalar(255, 255, 255), 2); // White border
+        
+        // DMX values for this face position
+        int panValue = key.panDmx;
+        int tiltValue = key.tiltDmx;
+        
+        // Draw DMX output position
+        int dmxX = vizX + static_cast<int>((panValue / 255.0f) * vizWidth);
+        int dmxY = centerY - static_cast<int>(((tiltValue - 128) / 127.0f) * (vizHeight / 2));
+        dmxX = std::max(vizX, std::min(vizX + vizWidth, dmxX));
+        dmxY = std::max(vizY, std::min(vizY + vizHeight, dmxY));
+        
+        // Draw line from face to DMX output
+        line(canvas, Point(faceX, faceY), Point(dmxX, dmxY), Scalar(100, 255, 100), 2);
+        
+        // Draw DMX output indicator
+        circle(canvas, Point(dmxX, dmxY), 6, Scalar(0, 255, 0), -1); // Green circle
+        circle(canvas, Point(dmxX, dmxY), 6, Scalar(255, 255, 255), 2); // White border
+        
+        // Show values
+        putText(canvas, "Face: (" + std::to_string(currentPan).substr(0, 3) + "," + 
+               std::to_string(currentTilt).substr(0, 3) + ")", 
+               Point(faceX - 30, faceY - 15), FONT_HERSHEY_SIMPLEX, 0.35, Scalar(255, 255, 255), 1);
+        putText(canvas, "DMX: (" + std::to_string(panValue) + "," + std::to_string(tiltValue) + ")", 
+               Point(dmxX - 25, dmxY + 20), FONT_HERSHEY_SIMPLEX, 0.35, Scalar(200, 255, 200), 1);
+    }
+}
+
+// Render detailed 3D moving head fixture visualization.
+// Background, base stand and lattice only depend on the view and are kept in
+// view.staticLayer; only the pan arm, head and beam are drawn per call.
+static void render3DFixture(Mat& canvas, FixtureView& view, const FixtureViewKey& key) {
+    int width = canvas.cols;
+    int height = canvas.rows;
+    int panDmx = key.panDmx;
+    int tiltDmx = key.tiltDmx;
+    
+    // Center point
+    Point center(width / 2, height / 2);
+    int scale = std::min(width, height) / 4;
+    ViewProjection project(key.viewAngleX, key.viewAngleY, key.viewDistance, center.x, center.y, scale);
+    
+    // Convert pan/tilt to radians
+    float panRad = ((panDmx - 128) / 128.0f) * CV_PI / 2.0f;
+    float tiltRad = ((tiltDmx - 128) / 128.0f) * CV_PI / 4.0f;
+    
+    // Define 3D model coordinates (in fixture-local space)
+    // Base stand (cylindrical)
+    float baseHeight = 0.8f;
+    float baseRadius = 0.15f;
+    int baseSegments = 12;
+    
+    // Pan arm (horizontal bar)
+    float armLength = 0.4f;
+    
+    // Fixture head dimensions
+    float headLength = 0.35f;
+    float headWidth = 0.25f;
+    float headHeight = 0.2f;
+    
+    // Draw base stand (vertical cylinder from bottom)
+    Scalar baseColor(80, 80, 90); // Dark gray metallic
+    Scalar armColor(120, 120, 130); // Lighter gray
+    Scalar headColor(150, 150, 180); // Purple-tinted metallic
+    Scalar lensColor(255, 220, 100); // Warm yellow/orange
+    Scalar beamColor(255, 200, 50, 180); // Yellow beam with transparency
+    
+    bool viewChanged = view.staticLayer.size() != canvas.size() ||
+                       view.layerKey.viewAngleX != key.viewAngleX || view.layerKey.viewAngleY != key.viewAngleY ||
+                       view.layerKey.viewDistance != key.viewDistance || view.layerKey.showLattice != key.showLattice;
+    if (viewChanged) {
+        Mat& layer = view.staticLayer;
+        layer.create(canvas.size(), CV_8UC3);
+        layer = Scalar(20, 20, 40);
+        
+        // Base cylinder - draw top and bottom circles
+        std::vector<Point> baseBottom, baseTop;
+        for (int i = 0; i < baseSegments; i++) {
+            float angle = (i / float(baseSegments)) * 2.0f * CV_PI;
+            float x = std::cos(angle) * baseRadius;
+            float y = std::sin(angle) * baseRadius;
+            baseBottom.push_back(project(x, -baseHeight/2, y));
+            baseTop.push_back(project(x, baseHeight/2, y));
+        }
+        
+        // Draw base cylinder sides
+        for (size_t i = 0; i < baseBottom.size(); i++) {
+            line(layer, baseBottom[i], baseTop[i], baseColor, 3);
+            line(layer, baseBottom[i], baseBottom[(i+1) % baseBottom.size()], baseColor, 2);
+            line(layer, baseTop[i], baseTop[(i+1) % baseTop.size()], baseColor, 2);
+        }
+        
+        // XYZ axes/lattice (behind the moving parts)
+        if (key.showLattice) {
+            drawXYZAxes(layer, project);
+        }
+        view.layerKey = key;
+    }
+    view.staticLayer.copyTo(canvas);
+    
+    // Pan rotation - rotate arm around Y axis
+    float cosPan = std::cos(panRad);
+    float sinPan = std::sin(panRad);
+    
+    // Pan arm (horizontal bar extending from base)
+    Point armStart = project(0, baseHeight/2 + 0.05f, 0);
+    Point armEnd = project(armLength * cosPan, baseHeight/2 + 0.05f, armLength * sinPan);
+    
+    // Draw pan arm with thickness
+    line(canvas, armStart, armEnd, armColor, 8);
+    
+    // Pan joint (rotating connection)
+    circle(canvas, armStart, 6, Scalar(200, 200, 210), -1);
+    circle(canvas, armStart, 6, Scalar(255, 255, 255), 2);
+    
+    // Fixture head position (at end of arm, with tilt rotation)
+    float headX = armLength * cosPan;
+    float headZ = armLength * sinPan;
+    float headY = baseHeight/2 + 0.1f;
+    
+    // Tilt rotation (around local X axis)
+    float cosTilt = std::cos(tiltRad);
+    float sinTilt = std::sin(tiltRad);
+    
+    // Define head corners in local space (before tilt)
+    std::vector<std::vector<float>> headCornersLocal = {
+        {-headWidth/2, headHeight/2, -headLength/2}, // Front-bottom-left
+        {headWidth/2, headHeight/2, -headLength/2},  // Front-bottom-right
+        {headWidth/2, -headHeight/2, -headLength/2}, // Front-top-right
+        {-headWidth/2, -headHeight/2, -headLength/2},// Front-top-left
+        {-headWidth/2, headHeight/2, headLength/2},  // Back-bottom-left
+        {headWidth/2, headHeight/2, headLength/2},   // Back-bottom-right
+        {headWidth/2, -headHeight/2, headLength/2},  // Back-top-right
+        {-headWidth/2, -headHeight/2, headLength/2}  // Back-top-left
+    };
+    
+    // Apply tilt rotation, then translate to head position, then pan rotation
+    std::vector<Point> headCorners2D;
+    for (const auto& corner : headCornersLocal) {
+        // Apply tilt rotation (around X axis)
+        float x = corner[0];
+        float y = corner[1] * cosTilt - corner[2] * sinTilt;
+        float z = corner[1] * sinTilt + corner[2] * cosTilt;
+        
+        // Translate to head position
+        x += headX;
+        y += headY;
+        z += headZ;
+        
+        // Project to 2D
+        headCorners2D.push_back(project(x, y, z));
+    }
+    
+    // Draw head faces (box)
+    // Front face (facing camera)
+    std::vector<Point> frontFace = {headCorners2D[2], headCorners2D[3], headCorners2D[0], headCorners2D[1]};
+    fillPoly(canvas, std::vector<std::vector<Point>>{frontFace}, headColor);
+    
+    // Top face
+    std::vector<Point> topFace = {headCorners2D[3], headCorners2D[2], headCorners2D[6], headCorners2D[7]};
+    fillPoly(canvas, std::vector<std::vector<Point>>{topFace}, Scalar(headColor[0]*1.2f, headColor[1]*1.2f, headColor[2]*1.2f));
+    
+    // Draw head edges
+    for (int i = 0; i < 4; i++) {
+        line(canvas, headCorners2D[i], headCorners2D[(i+1)%4], Scalar(255, 255, 255), 2); // Front face
+        line(canvas, headCorners2D[i+4], headCorners2D[((i+1)%4)+4], Scalar(200, 200, 200), 2); // Back face
+        line(canvas, headCorners2D[i], headCorners2D[i+4], Scalar(180, 180, 180), 2); // Connecting edges
+    }
+    
+    // Draw lens (at front of head)
+    Point lensCenter2D = project(headX, headY, headZ - headLength/2);
+    int lensRadius = scale / 15;
+    circle(canvas, lensCenter2D, lensRadius, lensColor, -1);
+    circle(canvas, lensCenter2D, lensRadius, Scalar(255, 255, 255), 2);
+    
+    // Draw light beam (from lens)
+    float beamLength = 1.5f;
+    float beamX = headX + std::sin(panRad + tiltRad) * beamLength;
+    float beamY = headY - std::cos(tiltRad) * beamLength * 0.3f;
+    float beamZ = headZ - headLength/2 - std::cos(panRad + tiltRad) * beamLength;
+    Point beamEnd2D = project(beamX, beamY, beamZ);
+    
+    // Draw beam with gradient effect (lines from center to edge)
+    for (int i = 0; i < 5; i++) {
+        float t = i / 4.0f;
+        int thickness = 5 - i;
+        Scalar beamColorScalar(255 - i*30, 200 - i*20, 50 - i*5);
+        Point beamMid = Point(lensCenter2D.x + (beamEnd2D.x - lensCenter2D.x) * t,
+                              lensCenter2D.y + (beamEnd2D.y - lensCenter2D.y) * t);
+        if (thickness > 0) {
+            line(canvas, lensCenter2D, beamMid, beamColorScalar, thickness);
+        }
+    }
+    
+    // Draw tilt joint (at arm end)
+    circle(canvas, armEnd, 5, Scalar(180, 180, 190), -1);
+    circle(canvas, armEnd, 5, Scalar(255, 255, 255), 1);
+    
+    // Text overlay - moved to bottom to avoid title overlap
+    std::string dmxText = "Pan: " + std::to_string(panDmx) + " | Tilt: " + std::to_string(tiltDmx);
+    putText(canvas, dmxText, Point(10, height - 35), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 255, 200), 2);
+    
+    // Draw angles (moved lower)
+    std::string angleText = "Pan: " + std::to_string(static_cast<int>(panRad * 180.0f / CV_PI)) + 
+                           "° | Tilt: " + std::to_string(static_cast<int>(tiltRad * 180.0f / CV_PI)) + "°";
+    putText(canvas, angleText, Point(10, height - 10), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 255, 200), 2);
+    
+}
+
+// 3D fixture window: the fixture plus title, readouts and view buttons
+// (button positions must match onMouse() in main.cpp)
+static void renderFixtureWindow(FixtureView& view, const FixtureViewKey& key) {
+    Mat& vizCanvas = view.canvas;
+    vizCanvas.create(600, 800, CV_8UC3);
+    if (!key.visible) {
+        vizCanvas = Scalar(20, 20, 40);
+        return;
+    }
+    
+    render3DFixture(vizCanvas, view, key);
+    
+    // Add title
+    putText(vizCanvas, "3D Fixture Visualization", 
+           Point(10, 25), FONT_HERSHEY_SIMPLEX, 0.6, Scalar(255, 255, 255), 2);
+    
+    // Display DMX values at bottom
+    std::string dmxText = "Pan: " + std::to_string(key.panDmx) + " / Tilt: " + std::to_string(key.tiltDmx);
+    putText(vizCanvas, dmxText, 
+           Point(10, vizCanvas.rows - 30),
+           FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 200, 255), 1);
+    
+    // Display angle values
+    std::string angleText = "Pan Angle: " + std::to_string(key.panAngle) + 
+                           " / Tilt Angle: " + std::to_string(key.tiltAngle);
+    putText(vizCanvas, angleText, 
+           Point(10, vizCanvas.rows - 10),
+           FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200, 200, 255), 1);
+    
+    // Draw Auto-Orbit and XYZ Lattice buttons (top-right)
+    int buttonWidth = 120;
+    int buttonHeight = 25;
+    int buttonSpacing = 5;
+    int margin = 10;
+    int startX = vizCanvas.cols - margin - buttonWidth;
+    int startY = 60;
+    
+    // Button 1: Auto-Orbit
+    Scalar orbitColor = key.autoOrbit ? Scalar(100, 255, 100) : Scalar(40, 40, 40);
+    rectangle(vizCanvas, Point(startX, startY), Point(startX + buttonWidth, startY + buttonHeight), orbitColor, -1);
+    rectangle(vizCanvas, Point(startX, startY), Point(startX + buttonWidth, startY + buttonHeight), Scalar(255, 255, 255), 1);
+    std::string orbitText = "Auto-Orbit: " + std::string(key.autoOrbit ? "ON" : "OFF");
+    int baseline = 0;
+    Size textSize = getTextSize(orbitText, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
+    putText(vizCanvas, orbitText, Point(startX + (buttonWidth - textSize.width) / 2, startY + (buttonHeight + textSize.height) / 2),
+           FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+    
+    // Button 2: XYZ Lattice
+    int button2Y = startY + buttonHeight + buttonSpacing;
+    Scalar latticeColor = key.showLattice ? Scalar(100, 150, 255) : Scalar(40, 40, 40);
+    rectangle(vizCanvas, Point(startX, button2Y), Point(startX + buttonWidth, button2Y + buttonHeight), latticeColor, -1);
+    rectangle(vizCanvas, Point(startX, button2Y), Point(startX + buttonWidth, button2Y + buttonHeight), Scalar(255, 255, 255), 1);
+    std::string latticeText = "XYZ Lattice: " + std::string(key.showLattice ? "ON" : "OFF");
+    textSize = getTextSize(latticeText, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
+    putText(vizCanvas, latticeText, Point(startX + (buttonWidth - textSize.width) / 2, button2Y + (buttonHeight + textSize.height) / 2),
+           FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+    
+    // Button 3: Reset View
+    int button3Y = button2Y + buttonHeight + buttonSpacing;
+    rectangle(vizCanvas, Point(startX, button3Y), Point(startX + buttonWidth, button3Y + buttonHeight), Scalar(60, 60, 150), -1);
+    rectangle(vizCanvas, Point(startX, button3Y), Point(startX + buttonWidth, button3Y + buttonHeight), Scalar(255, 255, 255), 1);
+    std::string resetText = "Reset View";
+    textSize = getTextSize(resetText, FONT_HERSHEY_SIMPLEX, 0.4, 1, &baseline);
+    putText(vizCanvas, resetText, Point(startX + (buttonWidth - textSize.width) / 2, button3Y + (buttonHeight + textSize.height) / 2),
+           FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+    
+    // Zoom buttons (left side)
+    int zoomButtonWidth = 80;
+    int zoomButtonHeight = 25;
+    int zoomX = 10;
+    int zoomY = vizCanvas.rows - 80;
+    
+    // Zoom In
+    rectangle(vizCanvas, Point(zoomX, zoomY), Point(zoomX + zoomButtonWidth, zoomY + zoomButtonHeight), Scalar(60, 150, 60), -1);
+    rectangle(vizCanvas, Point(zoomX, zoomY), Point(zoomX + zoomButtonWidth, zoomY + zoomButtonHeight), Scalar(255, 255, 255), 1);
+    std::string zoomInText = "Zoom +";
+    textSize = getTextSize(zoomInText, FONT_HERSHEY_SIMPLEX, 0.35, 1, &baseline);
+    putText(vizCanvas, zoomInText, Point(zoomX + (zoomButtonWidth - textSize.width) / 2, zoomY + (zoomButtonHeight + textSize.height) / 2),
+           FONT_HERSHEY_SIMPLEX, 0.35, Scalar(255, 255, 255), 1);
+    
+    // Zoom Out
+    int zoomOutY = zoomY + zoomButtonHeight + buttonSpacing;
+    rectangle(vizCanvas, Point(zoomX, zoomOutY), Point(zoomX + zoomButtonWidth, zoomOutY + zoomButtonHeight), Scalar(150, 60, 60), -1);
+    rectangle(vizCanvas, Point(zoomX, zoomOutY), Point(zoomX + zoomButtonWidth, zoomOutY + zoomButtonHeight), Scalar(255, 255, 255), 1);
+    std::string zoomOutText = "Zoom -";
+    textSize = getTextSize(zoomOutText, FONT_HERSHEY_SIMPLEX, 0.35, 1, &baseline);
+    putText(vizCanvas, zoomOutText, Point(zoomX + (zoomButtonWidth - textSize.width) / 2, zoomOutY + (zoomButtonHeight + textSize.height) / 2),
+           FONT_HERSHEY_SIMPLEX, 0.35, Scalar(255, 255, 255), 1);
+    
+    // Rotate buttons (below zoom)
+    int rotateButtonWidth = 60;
+    int rotateButtonHeight = 22;
+    int rotateStartY = zoomOutY + zoomButtonHeight + 10;
+    int rotateX = 10;
+    
+    // Rotate Left
+    rectangle(vizCanvas, Point(rotateX, rotateStartY), Point(rotateX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(60, 60, 150), -1);
+    rectangle(vizCanvas, Point(rotateX, rotateStartY), Point(rotateX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(255, 255, 255), 1);
+    putText(vizCanvas, "Left", Point(rotateX + 5, rotateStartY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
+    
+    // Rotate Right
+    int rotateRightX = rotateX + rotateButtonWidth + 5;
+    rectangle(vizCanvas, Point(rotateRightX, rotateStartY), Point(rotateRightX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(60, 60, 150), -1);
+    rectangle(vizCanvas, Point(rotateRightX, rotateStartY), Point(rotateRightX + rotateButtonWidth, rotateStartY + rotateButtonHeight), Scalar(255, 255, 255), 1);
+    putText(vizCanvas, "Right", Point(rotateRightX + 5, rotateStartY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
+    
+    // Rotate Up
+    int rotateUpY = rotateStartY + rotateButtonHeight + 5;
+    rectangle(vizCanvas, Point(rotateX, rotateUpY), Point(rotateX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(60, 60, 150), -1);
+    rectangle(vizCanvas, Point(rotateX, rotateUpY), Point(rotateX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(255, 255, 255), 1);
+    putText(vizCanvas, "Up", Point(rotateX + 18, rotateUpY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
+    
+    // Rotate Down
+    rectangle(vizCanvas, Point(rotateRightX, rotateUpY), Point(rotateRightX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(60, 60, 150), -1);
+    rectangle(vizCanvas, Point(rotateRightX, rotateUpY), Point(rotateRightX + rotateButtonWidth, rotateUpY + rotateButtonHeight), Scalar(255, 255, 255), 1);
+    putText(vizCanvas, "Down", Point(rotateRightX + 2, rotateUpY + 16), FONT_HERSHEY_SIMPLEX, 0.3, Scalar(255, 255, 255), 1);
+}
+
+PreviewWindows::~PreviewWindows() {
+    stop();
+}
+
+bool PreviewWindows::start(int fps, MouseCallback onMouse, const std::vector<PreviewTrackbar>& trackbars) {
+    if (running_) return true;
+
+    setFps(fps);
+    onMouse_ = onMouse;
+    trackbars_ = trackbars;
+    theatreClosed_ = false;
+    fixtureClosed_ = false;
+    running_ = true;
+#ifdef __APPLE__
+    // Cocoa windows must be created and pumped on the main (tracking) thread
+    threaded_ = false;
+    createWindows();
+#else
+    threaded_ = true;
+    thread_ = std::thread(&PreviewWindows::run, this);
+#endif
+    std::cout << "Preview windows: up to " << fps_ << " fps"
+              << (threaded_ ? " on a render thread" : " on the tracking thread") << std::endl;
+    return true;
+}
+
+void PreviewWindows::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (threaded_) {
+        snapshotReady_.notify_one();
+        if (thread_.joinable()) thread_.join(); // The render thread destroys its own windows
+    } else {
+        destroyAllWindows();
+    }
+    bindings_.clear();
+}
+
+void PreviewWindows::setFps(int fps) {
+    fps_ = std::max(1, std::min(fps, 60));
+}
+
+bool PreviewWindows::wantsSnapshot() const {
+    return running_ && !theatreClosed_ && nowUs() >= nextFrameUs_;
+}
+
+void PreviewWindows::submit(PreviewSnapshot& snapshot) {
+    if (!running_) return;
+    nextFrameUs_ = nowUs() + 1000000 / fps_;
+    if (!threaded_) {
+        render(snapshot);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        if (hasPending_) {
+            skipped_++;
+        }
+        std::swap(pending_, snapshot);
+        hasPending_ = true;
+    }
+    snapshotReady_.notify_one();
+}
+
+void PreviewWindows::pump() {
+    if (running_ && !threaded_) {
+        processEvents();
+    }
+}
+
+void PreviewWindows::run() {
+    traceThreadName("preview");
+    createWindows();
+    while (running_) {
+        bool hasFrame = false;
+        {
+            std::unique_lock<std::mutex> lock(snapshotMutex_);
+            snapshotReady_.wait_for(lock, std::chrono::milliseconds(PREVIEW_EVENT_INTERVAL_MS),
+                                    [this] { return hasPending_ || !running_; });
+            if (hasPending_) {
+                std::swap(current_, pending_); // Hands the previous buffers back for reuse
+                hasPending_ = false;
+                hasFrame = true;
+            }
+        }
+        if (hasFrame) {
+            render(current_);
+        }
+        processEvents();
+    }
+    destroyAllWindows();
+}
+
+void PreviewWindows::createWindows() {
+    // Window 1: Theatre preview (RESIZABLE - user can drag corners to resize)
+    namedWindow(PREVIEW_THEATRE_WINDOW, WINDOW_NORMAL);
+    resizeWindow(PREVIEW_THEATRE_WINDOW, 900, 700);
+    moveWindow(PREVIEW_THEATRE_WINDOW, 0, 0);
+    setMouseCallback(PREVIEW_THEATRE_WINDOW, mouseTrampoline, this);
+
+    // Window 2: 3D Visualization (RESIZABLE)
+    namedWindow(PREVIEW_FIXTURE_WINDOW, WINDOW_NORMAL);
+    resizeWindow(PREVIEW_FIXTURE_WINDOW, 800, 600);
+    moveWindow(PREVIEW_FIXTURE_WINDOW, 920, 0);
+    setMouseCallback(PREVIEW_FIXTURE_WINDOW, mouseTrampoline, this);
+
+    // Window 3: Rigging Preview (configuration UI is now in React)
+    namedWindow(PREVIEW_RIGGING_WINDOW, WINDOW_NORMAL);
+    resizeWindow(PREVIEW_RIGGING_WINDOW, 600, 500);
+    moveWindow(PREVIEW_RIGGING_WINDOW, 1740, 0);
+
+    // Trackbar positions live in the bindings; they only reach the tracking thread through queued callbacks
+    for (const PreviewTrackbar& trackbar : trackbars_) {
+        bindings_.push_back(std::unique_ptr<TrackbarBinding>(new TrackbarBinding{this, trackbar.onChange, trackbar.value}));
+        TrackbarBinding* binding = bindings_.back().get();
+        createTrackbar(trackbar.name, trackbar.window, &binding->value, trackbar.max, trackbarTrampoline, binding);
+        setTrackbarPos(trackbar.name, trackbar.window, trackbar.position);
+    }
+
+    std::cout << "Windows created: Theatre, 3D Visualization, Rigging Preview!" << std::endl;
+}
+
+void PreviewWindows::render(const PreviewSnapshot& snapshot) {
+    if (theatreClosed_) return;
+    int64_t traceStartUs = traceEnabled() ? traceNowUs() : 0;
+    if (!snapshot.theatre.empty()) {
+        imshow(PREVIEW_THEATRE_WINDOW, snapshot.theatre);
+    }
+
+    // The 3D and rigging windows are only redrawn (and re-shown) when what they display changes
+    if (!fixtureClosed_ && (!fixtureView_.drawn || !(fixtureView_.shown == snapshot.fixture))) {
+        renderFixtureWindow(fixtureView_, snapshot.fixture);
+        imshow(PREVIEW_FIXTURE_WINDOW, fixtureView_.canvas);
+        fixtureView_.shown = snapshot.fixture;
+        fixtureView_.drawn = true;
+    }
+
+    if (!riggingView_.drawn || !(riggingView_.shown == snapshot.rigging)) {
+        riggingView_.canvas.create(500, 600, CV_8UC3);
+        renderRiggingPreview(riggingView_.canvas, riggingView_, snapshot.rigging);
+        imshow(PREVIEW_RIGGING_WINDOW, riggingView_.canvas);
+        riggingView_.shown = snapshot.rigging;
+        riggingView_.drawn = true;
+    }
+    shown_++;
+    if (traceStartUs > 0) {
+        traceSpan("render", snapshot.frame, traceStartUs, traceNowUs());
+    }
+}
+
+void PreviewWindows::processEvents() {
+    // Callbacks run in here (and only queue events)
+    waitKey(1);
+
+    // Handle window close buttons
+    if (!theatreClosed_ && getWindowProperty(PREVIEW_THEATRE_WINDOW, WND_PROP_VISIBLE) < 0) {
+        theatreClosed_ = true;
+    }
+    if (!fixtureClosed_ && getWindowProperty(PREVIEW_FIXTURE_WINDOW, WND_PROP_VISIBLE) < 0) {
+        fixtureClosed_ = true;
+    }
+}
+
+void PreviewWindows::queueEvent(const PreviewInputEvent& event) {
+    if (!events_.push(event)) {
+        droppedEvents_++;
+    }
+}
+
+void PreviewWindows::mouseTrampoline(int event, int x, int y, int flags, void* userdata) {
+    PreviewWindows* self = static_cast<PreviewWindows*>(userdata);
+    if (!self->onMouse_) return;
+    PreviewInputEvent input;
+    input.onMouse = self->onMouse_;
+    input.event = event;
+    input.x = x;
+    input.y = y;
+    input.flags = flags;
+    self->queueEvent(input);
+}
+
+void PreviewWindows::trackbarTrampoline(int pos, void* userdata) {
+    TrackbarBinding* binding = static_cast<TrackbarBinding*>(userdata);
+    if (!binding->onChange) return;
+    PreviewInputEvent input;
+    input.onTrackbar = binding->onChange;
+    input.pos = pos;
+    binding->owner->queueEvent(input);
+}
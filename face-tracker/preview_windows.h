@@ -0,0 +1,188 @@
+// OpenCV preview windows (theatre, 3D fixture, rigging) on their own thread
+//
+// imshow() and the highgui event loop (waitKey) run on a render thread, so
+// window size, window count and desktop compositor stalls never hold up
+// tracking. The tracking thread composes the theatre at most previewFps
+// times a second (wantsSnapshot()) and hands it over with submit(); the
+// render thread only ever draws from that snapshot, never from live state.
+//
+// Mouse and trackbar callbacks fire on the render thread but are not run
+// there: each one is queued (lock-free SPSC) and replayed on the tracking
+// thread via poll(), so tracking state keeps a single writer.
+//
+// macOS only allows windows on the main thread; there the windows are drawn
+// inline by submit() (still at the capped rate) and pumped by pump().
+#pragma once
+
+#include "spsc_queue.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/highgui.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Window titles
+const char* const PREVIEW_THEATRE_WINDOW = "ArtBastard Puppet Theatre";
+const char* const PREVIEW_FIXTURE_WINDOW = "3D Fixture Visualization";
+const char* const PREVIEW_RIGGING_WINDOW = "Rigging Preview";
+
+// What the 3D fixture window shows; it is only redrawn when this changes
+struct FixtureViewKey {
+    bool visible = false;
+    int panDmx = -1, tiltDmx = -1;
+    int panAngle = 0, tiltAngle = 0; // Displayed angles (degrees)
+    float viewAngleX = 0.0f, viewAngleY = 0.0f, viewDistance = 0.0f;
+    bool showLattice = false, autoOrbit = false;
+
+    bool operator==(const FixtureViewKey& o) const {
+        return std::tie(visible, panDmx, tiltDmx, panAngle, tiltAngle, viewAngleX, viewAngleY, viewDistance, showLattice, autoOrbit) ==
+               std::tie(o.visible, o.panDmx, o.tiltDmx, o.panAngle, o.tiltAngle, o.viewAngleX, o.viewAngleY, o.viewDistance, o.showLattice, o.autoOrbit);
+    }
+};
+
+// What the rigging preview shows; it is only redrawn when this changes
+struct RiggingViewKey {
+    bool faceDetected = false;
+    int panDmx = -1, tiltDmx = -1;
+    int pan = 0, tilt = 0; // Face position in 1/1000ths (finer than a pixel)
+    int panMin = -1, panMax = -1;
+
+    bool operator==(const RiggingViewKey& o) const {
+        return std::tie(faceDetected, panDmx, tiltDmx, pan, tilt, panMin, panMax) ==
+               std::tie(o.faceDetected, o.panDmx, o.tiltDmx, o.pan, o.tilt, o.panMin, o.panMax);
+    }
+};
+
+// Everything the windows draw for one preview frame
+struct PreviewSnapshot {
+    uint64_t frame = 0;     // Tracker frame number (trace spans)
+    cv::Mat theatre;        // Composited theatre preview
+    FixtureViewKey fixture;
+    RiggingViewKey rigging;
+};
+
+// One highgui callback, replayed on the tracking thread
+struct PreviewInputEvent {
+    cv::MouseCallback onMouse = nullptr;       // Set for mouse events
+    cv::TrackbarCallback onTrackbar = nullptr; // Set for trackbar moves
+    int event = 0, x = 0, y = 0, flags = 0;
+    int pos = 0;
+
+    // Run the original callback with the tracking thread's userdata
+    void dispatch(void* userdata) const {
+        if (onMouse) onMouse(event, x, y, flags, userdata);
+        if (onTrackbar) onTrackbar(pos, userdata);
+    }
+};
+
+// A trackbar created along with the windows
+struct PreviewTrackbar {
+    std::string name;
+    std::string window;
+    int value;    // Created at this position...
+    int position; // ...then moved here (onChange fires if they differ, as with setTrackbarPos)
+    int max;
+    cv::TrackbarCallback onChange;
+};
+
+// 3D fixture window: last frame plus the parts that only change with the view
+struct FixtureView {
+    cv::Mat canvas;
+    FixtureViewKey shown;  // Key of `canvas` (never matches before the first draw)
+    bool drawn = false;
+    cv::Mat staticLayer;   // Background, base stand and lattice for `layerKey`'s view
+    FixtureViewKey layerKey;
+};
+
+// Rigging preview window: last frame plus its static layout
+struct RiggingView {
+    cv::Mat canvas;
+    RiggingViewKey shown;
+    bool drawn = false;
+    cv::Mat staticLayer;   // Titles, axes, clamped ranges and legend
+    int layerPanMin = -1, layerPanMax = -1;
+};
+
+class PreviewWindows {
+public:
+    PreviewWindows() = default;
+    ~PreviewWindows();
+    PreviewWindows(const PreviewWindows&) = delete;
+    PreviewWindows& operator=(const PreviewWindows&) = delete;
+
+    // Create the windows; onMouse is attached to the theatre and 3D windows
+    bool start(int fps, cv::MouseCallback onMouse, const std::vector<PreviewTrackbar>& trackbars);
+    void stop();
+    bool isRunning() const { return running_; }
+    void setFps(int fps);
+
+    // Cheap check for the tracking thread: the next preview frame is due
+    bool wantsSnapshot() const;
+    // Hand a snapshot to the windows; `snapshot` gets older buffers back for reuse
+    void submit(PreviewSnapshot& snapshot);
+    // Process window events when drawing inline (no-op with a render thread)
+    void pump();
+
+    // Tracking thread: next queued mouse/trackbar callback, if any
+    bool poll(PreviewInputEvent& event) { return events_.pop(event); }
+
+    // The user closed a window (closed windows are not shown again)
+    bool theatreClosed() const { return theatreClosed_; }
+    bool fixtureClosed() const { return fixtureClosed_; }
+
+    uint64_t shownCount() const { return shown_; }
+    uint64_t skippedCount() const { return skipped_; }
+    uint64_t droppedEventCount() const { return droppedEvents_; }
+
+private:
+    struct TrackbarBinding {
+        PreviewWindows* owner;
+        cv::TrackbarCallback onChange;
+        int value; // Written by highgui on the render thread only
+    };
+
+    void run();
+    void createWindows();
+    void render(const PreviewSnapshot& snapshot);
+    void processEvents();
+    void queueEvent(const PreviewInputEvent& event);
+    static void mouseTrampoline(int event, int x, int y, int flags, void* userdata);
+    static void trackbarTrampoline(int pos, void* userdata);
+
+    std::atomic<bool> running_{false};
+    bool threaded_ = true;
+    std::thread thread_;
+    std::atomic<int> fps_{15};
+    cv::MouseCallback onMouse_ = nullptr;
+    std::vector<PreviewTrackbar> trackbars_;
+    std::vector<std::unique_ptr<TrackbarBinding>> bindings_; // Stable userdata for highgui
+
+    // Callbacks queued for the tracking thread
+    SpscQueue<PreviewInputEvent, 256> events_;
+    std::atomic<uint64_t> droppedEvents_{0}; // Queue full (tracking thread stalled)
+
+    // Snapshot handed over by the tracking thread
+    std::mutex snapshotMutex_;
+    std::condition_variable snapshotReady_;
+    PreviewSnapshot pending_;
+    bool hasPending_ = false;
+    std::atomic<int64_t> nextFrameUs_{0};
+
+    // Render thread only
+    PreviewSnapshot current_;
+    FixtureView fixtureView_;
+    RiggingView riggingView_;
+    std::atomic<bool> theatreClosed_{false};
+    std::atomic<bool> fixtureClosed_{false};
+
+    std::atomic<uint64_t> shown_{0};
+    std::atomic<uint64_t> skipped_{0}; // Snapshots replaced before the render thread got to them
+};
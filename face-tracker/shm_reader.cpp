@@ -0,0 +1,119 @@
+// Shared memory ring reader - prints pose samples published by the face tracker
+//
+// Usage: face-tracker-shm-reader [--name /artbastard-face-tracker] [--preview preview.ppm] [--latest]
+//
+//   --name     Shared memory object name (must match sharedMemoryName in the config)
+//   --preview  Request preview frames and keep writing the latest one to a PPM file
+//   --latest   Only print the latest sample each poll instead of every sample
+//
+// Built alongside the tracker as a minimal example of the reader API (shm_ring.h).
+#include "shm_ring.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+// Write a BGR preview frame as binary PPM (RGB)
+static bool writePreviewPpm(const std::string& path, const ShmPreviewInfo& info, const std::vector<uint8_t>& bgr) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    file << "P6\n" << info.width << " " << info.height << "\n255\n";
+    std::vector<uint8_t> rgb(bgr.size());
+    for (size_t i = 0; i + 2 < bgr.size(); i += 3) {
+        rgb[i] = bgr[i + 2];
+        rgb[i + 1] = bgr[i + 1];
+        rgb[i + 2] = bgr[i];
+    }
+    file.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+    return true;
+}
+
+static void printSample(const ShmPoseSample& s) {
+    std::cout << "#" << s.sequence << " frame " << s.frame
+              << " | face: " << ((s.flags & SHM_POSE_FACE) ? "yes" : "no")
+              << ((s.flags & SHM_POSE_LANDMARKS) ? " (landmarks: " + std::to_string(s.landmarkCount) + ")" : "")
+              << " | pan " << s.smoothedPan << " tilt " << s.smoothedTilt
+              << " | DMX";
+    for (uint32_t i = 0; i < SHM_DMX_SLOTS; i++) {
+        if (s.dmxChannel[i] > 0) {
+            std::cout << " " << s.dmxChannel[i] << "=" << static_cast<int>(s.dmxValue[i]);
+        }
+    }
+    std::cout << " | age " << (shmNowUs() - s.timestampUs) << " us" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string name = SHM_RING_DEFAULT_NAME;
+    std::string previewPath;
+    bool latestOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "--preview" && i + 1 < argc) {
+            previewPath = argv[++i];
+        } else if (arg == "--latest") {
+            latestOnly = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--name <shm name>] [--preview <file.ppm>] [--latest]" << std::endl;
+            return 1;
+        }
+    }
+
+    ShmRingReader reader;
+    uint64_t cursor = 0;
+    uint64_t lost = 0;
+    uint64_t received = 0;
+    uint64_t lastPreviewSequence = UINT64_MAX;
+    std::vector<ShmPoseSample> samples;
+    std::vector<uint8_t> previewData;
+    auto lastReport = std::chrono::steady_clock::now();
+
+    while (true) {
+        // (Re)attach whenever the tracker is not running
+        if (!reader.writerAlive()) {
+            if (!reader.open(name)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                continue;
+            }
+            std::cout << "Attached to " << name << std::endl;
+            cursor = 0;
+        }
+
+        if (latestOnly) {
+            ShmPoseSample sample;
+            if (reader.readLatestPose(sample) && sample.sequence >= cursor) {
+                printSample(sample);
+                cursor = sample.sequence + 1;
+                received++;
+            }
+        } else {
+            reader.readPoses(cursor, samples, lost);
+            for (const auto& sample : samples) {
+                printSample(sample);
+            }
+            received += samples.size();
+        }
+
+        if (!previewPath.empty()) {
+            reader.requestPreview();
+            ShmPreviewInfo info;
+            if (reader.readLatestPreview(info, previewData) && info.sequence != lastPreviewSequence) {
+                writePreviewPpm(previewPath, info, previewData);
+                lastPreviewSequence = info.sequence;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration_cast<std::chrono::seconds>(now - lastReport).count() >= 5) {
+            std::cout << "Reader stats - Received: " << received << " | Lost: " << lost << std::endl;
+            lastReport = now;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
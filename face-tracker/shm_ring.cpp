@@ -0,0 +1,273 @@
+#include "shm_ring.h"
+
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// Readers give up on a slot after this many torn copies (writer is lapping them)
+static const int SHM_READ_RETRIES = 4;
+
+// Preview frames are only produced while a reader has asked within this window
+static const uint64_t SHM_PREVIEW_REQUEST_TIMEOUT_US = 2000000;
+
+uint64_t shmNowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+// Seqlock copy: returns false if the writer touched the slot while we copied
+static bool seqlockCopy(const std::atomic<uint32_t>& seq, void* dst, const void* src, size_t size) {
+    uint32_t before = seq.load(std::memory_order_acquire);
+    if (before & 1) return false;
+    std::memcpy(dst, src, size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq.load(std::memory_order_relaxed) == before;
+}
+
+static void seqlockBeginWrite(std::atomic<uint32_t>& seq) {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void seqlockEndWrite(std::atomic<uint32_t>& seq) {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+ShmRingWriter::~ShmRingWriter() {
+    close();
+}
+
+void ShmRingWriter::publishPose(ShmPoseSample& sample) {
+    if (!ring_) return;
+    sample.sequence = poseCount_;
+    ShmPoseSlot& slot = ring_->pose[poseCount_ % SHM_POSE_SLOTS];
+    seqlockBeginWrite(slot.seq);
+    std::memcpy(&slot.sample, &sample, sizeof(sample));
+    seqlockEndWrite(slot.seq);
+    poseCount_++;
+    ring_->header.poseCount.store(poseCount_, std::memory_order_release);
+}
+
+bool ShmRingWriter::previewRequested() const {
+    if (!ring_) return false;
+    uint64_t requested = ring_->header.previewRequestUs.load(std::memory_order_relaxed);
+    return requested != 0 && shmNowUs() - requested < SHM_PREVIEW_REQUEST_TIMEOUT_US;
+}
+
+bool ShmRingWriter::publishPreview(uint64_t frame, int width, int height, const uint8_t* bgr) {
+    if (!ring_) return false;
+    if (width <= 0 || height <= 0 ||
+        static_cast<uint32_t>(width) > SHM_PREVIEW_MAX_WIDTH ||
+        static_cast<uint32_t>(height) > SHM_PREVIEW_MAX_HEIGHT) {
+        return false;
+    }
+
+    ShmPreviewSlot& slot = ring_->preview[previewCount_ % SHM_PREVIEW_SLOTS];
+    seqlockBeginWrite(slot.seq);
+    slot.info.sequence = previewCount_;
+    slot.info.frame = frame;
+    slot.info.timestampUs = shmNowUs();
+    slot.info.width = static_cast<uint16_t>(width);
+    slot.info.height = static_cast<uint16_t>(height);
+    slot.info.size = static_cast<uint32_t>(width * height * 3);
+    std::memcpy(slot.data, bgr, slot.info.size);
+    seqlockEndWrite(slot.seq);
+    previewCount_++;
+    ring_->header.previewCount.store(previewCount_, std::memory_order_release);
+    return true;
+}
+
+ShmRingReader::~ShmRingReader() {
+    close();
+}
+
+bool ShmRingReader::writerAlive() const {
+    return ring_ && ring_->header.magic.load(std::memory_order_acquire) == SHM_RING_MAGIC;
+}
+
+bool ShmRingReader::readPoseSlot(uint64_t sequence, ShmPoseSample& out) const {
+    const ShmPoseSlot& slot = ring_->pose[sequence % SHM_POSE_SLOTS];
+    for (int attempt = 0; attempt < SHM_READ_RETRIES; attempt++) {
+        if (seqlockCopy(slot.seq, &out, &slot.sample, sizeof(out))) {
+            // A different sequence means the writer lapped us and reused the slot
+            return out.sequence == sequence;
+        }
+    }
+    return false;
+}
+
+bool ShmRingReader::readLatestPose(ShmPoseSample& out) const {
+    if (!ring_) return false;
+    for (int attempt = 0; attempt < SHM_READ_RETRIES; attempt++) {
+        uint64_t count = ring_->header.poseCount.load(std::memory_order_acquire);
+        if (count == 0) return false;
+        if (readPoseSlot(count - 1, out)) return true;
+    }
+    return false;
+}
+
+size_t ShmRingReader::readPoses(uint64_t& cursor, std::vector<ShmPoseSample>& out, uint64_t& lost) const {
+    out.clear();
+    if (!ring_) return 0;
+
+    uint64_t count = ring_->header.poseCount.load(std::memory_order_acquire);
+    if (cursor > count) {
+        cursor = count; // Writer restarted with a fresh ring
+    }
+    // Skip anything already overwritten (keep one slot of margin for the slot being written)
+    if (count - cursor > SHM_POSE_SLOTS - 1) {
+        uint64_t oldest = count - (SHM_POSE_SLOTS - 1);
+        lost += oldest - cursor;
+        cursor = oldest;
+    }
+
+    ShmPoseSample sample;
+    while (cursor < count) {
+        if (readPoseSlot(cursor, sample)) {
+            out.push_back(sample);
+        } else {
+            lost++;
+        }
+        cursor++;
+    }
+    return out.size();
+}
+
+void ShmRingReader::requestPreview() {
+    if (!ring_) return;
+    ring_->header.previewRequestUs.store(shmNowUs(), std::memory_order_relaxed);
+}
+
+bool ShmRingReader::readLatestPreview(ShmPreviewInfo& info, std::vector<uint8_t>& data) const {
+    if (!ring_) return false;
+    for (int attempt = 0; attempt < SHM_READ_RETRIES; attempt++) {
+        uint64_t count = ring_->header.previewCount.load(std::memory_order_acquire);
+        if (count == 0) return false;
+        const ShmPreviewSlot& slot = ring_->preview[(count - 1) % SHM_PREVIEW_SLOTS];
+
+        uint32_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        info = slot.info;
+        if (info.size > SHM_PREVIEW_MAX_BYTES) continue;
+        data.resize(info.size);
+        std::memcpy(data.data(), slot.data, info.size);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef _WIN32
+
+// Shared memory is POSIX-only for now; the tracker runs without it on Windows
+bool ShmRingWriter::open(const std::string& /*name*/) {
+    std::cerr << "Shared memory ring is not supported on Windows" << std::endl;
+    return false;
+}
+
+void ShmRingWriter::close() {}
+
+bool ShmRingReader::open(const std::string& /*name*/) {
+    return false;
+}
+
+void ShmRingReader::close() {}
+
+#else
+
+bool ShmRingWriter::open(const std::string& name) {
+    close();
+
+    // Start from a fresh object so a stale ring (other layout/size) can't be reused
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, sizeof(ShmRingLayout)) < 0) {
+        std::cerr << "Failed to size shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, sizeof(ShmRingLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate zero-fills, so every seqlock starts even and every counter at zero
+    ring_ = static_cast<ShmRingLayout*>(mapped);
+    ring_->header.version = SHM_RING_VERSION;
+    ring_->header.poseSlots = SHM_POSE_SLOTS;
+    ring_->header.previewSlots = SHM_PREVIEW_SLOTS;
+    ring_->header.totalSize = sizeof(ShmRingLayout);
+    ring_->header.writerPid.store(static_cast<uint32_t>(getpid()), std::memory_order_relaxed);
+    ring_->header.magic.store(SHM_RING_MAGIC, std::memory_order_release);
+
+    name_ = name;
+    poseCount_ = 0;
+    previewCount_ = 0;
+    std::cout << "Shared memory ring published: " << name << " (" << sizeof(ShmRingLayout) / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+void ShmRingWriter::close() {
+    if (!ring_) return;
+    // Tell attached readers the tracker is gone; they keep their mapping until they close
+    ring_->header.magic.store(0, std::memory_order_release);
+    munmap(ring_, sizeof(ShmRingLayout));
+    shm_unlink(name_.c_str());
+    ring_ = nullptr;
+}
+
+bool ShmRingReader::open(const std::string& name) {
+    close();
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(ShmRingLayout)) {
+        ::close(fd);
+        return false;
+    }
+
+    // Mapped writable only so previewRequestUs can be set; everything else is read-only by convention
+    void* mapped = mmap(nullptr, sizeof(ShmRingLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    ring_ = static_cast<ShmRingLayout*>(mapped);
+    if (ring_->header.magic.load(std::memory_order_acquire) != SHM_RING_MAGIC ||
+        ring_->header.version != SHM_RING_VERSION ||
+        ring_->header.totalSize != sizeof(ShmRingLayout)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ShmRingReader::close() {
+    if (!ring_) return;
+    munmap(ring_, sizeof(ShmRingLayout));
+    ring_ = nullptr;
+}
+
+#endif
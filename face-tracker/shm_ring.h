@@ -0,0 +1,167 @@
+// Shared-memory ring buffer for tracking state and preview frames
+//
+// The tracker publishes every processed frame into a POSIX shared memory
+// object (default "/artbastard-face-tracker") so local processes can read the
+// pose, landmarks and DMX values without a socket or serialization step.
+//
+// Layout (fixed size, see ShmRingLayout):
+//
+//   ShmRingHeader                  magic/version, publish counters
+//   ShmPoseSlot[SHM_POSE_SLOTS]    ring of pose samples
+//   ShmPreviewSlot[SHM_PREVIEW_SLOTS] ring of downscaled BGR preview frames
+//
+// Each slot is guarded by a seqlock: the writer makes the sequence odd, writes
+// the slot, then makes it even again. Readers copy the slot and retry if the
+// sequence was odd or changed while copying, so any number of readers can
+// attach without ever blocking the tracker. Readers never write to the
+// mapping except previewRequestUs, which asks the tracker to keep producing
+// preview frames (they are skipped when nobody has asked for 2 seconds).
+//
+// POSIX only; on Windows open() fails and the tracker runs without it.
+//
+// Timestamps are steady-clock microseconds (CLOCK_MONOTONIC on Linux), so
+// they are comparable across processes on the same machine.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+const uint32_t SHM_RING_MAGIC = 0x46534241; // "ABSF" (ArtBastard shared frames)
+const uint32_t SHM_RING_VERSION = 1;
+const uint32_t SHM_POSE_SLOTS = 64;
+const uint32_t SHM_PREVIEW_SLOTS = 3;
+const uint32_t SHM_MAX_LANDMARKS = 68;
+const uint32_t SHM_DMX_SLOTS = 5;  // Pan, tilt, iris, zoom, focus
+const uint32_t SHM_PREVIEW_MAX_WIDTH = 320;
+const uint32_t SHM_PREVIEW_MAX_HEIGHT = 240;
+const uint32_t SHM_PREVIEW_MAX_BYTES = SHM_PREVIEW_MAX_WIDTH * SHM_PREVIEW_MAX_HEIGHT * 3;
+const char* const SHM_RING_DEFAULT_NAME = "/artbastard-face-tracker";
+
+// Pose sample flags
+const uint8_t SHM_POSE_FACE = 0x01;      // Face detected this frame
+const uint8_t SHM_POSE_LANDMARKS = 0x02; // Pose (and landmarks) came from the landmark model
+
+// One processed frame
+struct ShmPoseSample {
+    uint64_t sequence;    // Publish index (0, 1, 2, ...), identifies the sample across slots
+    uint64_t frame;       // Tracker frame counter
+    uint64_t timestampUs; // Steady clock, microseconds
+    float rawPan;         // Unsmoothed estimate (-1.0 to 1.0)
+    float rawTilt;
+    float smoothedPan;
+    float smoothedTilt;
+    uint16_t frameWidth;  // Camera frame size (landmark coordinate space)
+    uint16_t frameHeight;
+    uint8_t flags;        // SHM_POSE_* bits
+    uint8_t landmarkCount;
+    uint16_t dmxChannel[SHM_DMX_SLOTS]; // 1-based DMX channel (0 = disabled)
+    uint8_t dmxValue[SHM_DMX_SLOTS];
+    uint8_t reserved[3];
+    float landmarks[SHM_MAX_LANDMARKS][2]; // Pixel x, y
+};
+
+struct alignas(64) ShmPoseSlot {
+    std::atomic<uint32_t> seq; // Odd while the writer is inside the slot
+    ShmPoseSample sample;
+};
+
+struct ShmPreviewInfo {
+    uint64_t sequence;    // Preview publish index
+    uint64_t frame;       // Tracker frame counter the preview was taken from
+    uint64_t timestampUs;
+    uint16_t width;
+    uint16_t height;
+    uint32_t size;        // Bytes used in data (width * height * 3, BGR, tightly packed)
+};
+
+struct alignas(64) ShmPreviewSlot {
+    std::atomic<uint32_t> seq;
+    ShmPreviewInfo info;
+    uint8_t data[SHM_PREVIEW_MAX_BYTES];
+};
+
+struct alignas(64) ShmRingHeader {
+    std::atomic<uint32_t> magic; // SHM_RING_MAGIC once initialized, 0 after the writer exits
+    uint32_t version;
+    uint32_t poseSlots;
+    uint32_t previewSlots;
+    uint64_t totalSize;
+    std::atomic<uint64_t> poseCount;        // Pose samples published; latest is slot (poseCount - 1) % poseSlots
+    std::atomic<uint64_t> previewCount;     // Preview frames published
+    std::atomic<uint64_t> previewRequestUs; // Last time a reader asked for preview frames
+    std::atomic<uint32_t> writerPid;
+};
+
+struct ShmRingLayout {
+    ShmRingHeader header;
+    ShmPoseSlot pose[SHM_POSE_SLOTS];
+    ShmPreviewSlot preview[SHM_PREVIEW_SLOTS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory counters must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory seqlocks must be lock-free");
+
+// Current steady-clock time in microseconds (the ring's time base)
+uint64_t shmNowUs();
+
+// Tracker side: creates the shared memory object and publishes into it
+class ShmRingWriter {
+public:
+    ShmRingWriter() = default;
+    ~ShmRingWriter();
+    ShmRingWriter(const ShmRingWriter&) = delete;
+    ShmRingWriter& operator=(const ShmRingWriter&) = delete;
+
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return ring_ != nullptr; }
+    const std::string& name() const { return name_; }
+
+    // Fills in sequence; everything else comes from the caller
+    void publishPose(ShmPoseSample& sample);
+
+    // True if a reader asked for preview frames recently (skip the resize otherwise)
+    bool previewRequested() const;
+    // BGR pixels, tightly packed rows (width * 3 bytes); larger frames are rejected
+    bool publishPreview(uint64_t frame, int width, int height, const uint8_t* bgr);
+
+private:
+    ShmRingLayout* ring_ = nullptr;
+    std::string name_;
+    uint64_t poseCount_ = 0;
+    uint64_t previewCount_ = 0;
+};
+
+// Reader side: attaches to an existing ring read-only (apart from preview requests)
+class ShmRingReader {
+public:
+    ShmRingReader() = default;
+    ~ShmRingReader();
+    ShmRingReader(const ShmRingReader&) = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    bool open(const std::string& name = SHM_RING_DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return ring_ != nullptr; }
+    // False once the writer has exited (reopen to attach to a new tracker)
+    bool writerAlive() const;
+
+    // Latest published sample
+    bool readLatestPose(ShmPoseSample& out) const;
+    // Samples published after cursor (cursor = next sequence wanted), oldest first.
+    // Samples overwritten before they could be read are added to lost.
+    size_t readPoses(uint64_t& cursor, std::vector<ShmPoseSample>& out, uint64_t& lost) const;
+
+    // Ask the tracker to publish preview frames (call at least every second)
+    void requestPreview();
+    // Latest preview frame (data is resized to info.size)
+    bool readLatestPreview(ShmPreviewInfo& info, std::vector<uint8_t>& data) const;
+
+private:
+    bool readPoseSlot(uint64_t sequence, ShmPoseSample& out) const;
+
+    ShmRingLayout* ring_ = nullptr;
+};
@@ -0,0 +1,341 @@
+#include "synthetic_capture.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+static const double TWO_PI = 6.283185307179586;
+
+void syntheticTrajectory(const SyntheticSettings& settings, double seconds, float& pan, float& tilt) {
+    double period = std::max(100, settings.periodMs) / 1000.0;
+    double phase = std::fmod(seconds / period, 1.0); // 0-1 through the cycle
+    double a = std::max(0.0f, std::min(1.0f, settings.amplitude));
+    double p = 0.0;
+    double t = 0.0;
+    if (settings.motion == "circle") {
+        p = a * std::cos(TWO_PI * phase);
+        t = a * std::sin(TWO_PI * phase);
+    } else if (settings.motion == "sweep") {
+        p = a * (phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase); // Triangle wave
+    } else if (settings.motion == "steps") {
+        // Corners of a square, a quarter period each
+        static const double corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+        int corner = std::min(3, static_cast<int>(phase * 4.0));
+        p = a * corners[corner][0];
+        t = a * corners[corner][1];
+    } else if (settings.motion != "still") {
+        // Lissajous figure eight (also the fallback for unknown names)
+        p = a * std::sin(TWO_PI * phase);
+        t = a * std::sin(2.0 * TWO_PI * phase);
+    }
+    pan = static_cast<float>(p);
+    tilt = static_cast<float>(t);
+}
+
+// Schematic face: dark brows and eyes over lighter cheeks, the contrast pattern
+// Haar-style detectors key on
+static void drawFace(int width, cv::Mat& face, cv::Mat& mask) {
+    int height = width * 5 / 4;
+    face.create(height, width, CV_8UC3);
+    face.setTo(cv::Scalar::all(0));
+    mask.create(height, width, CV_8UC1);
+    mask.setTo(cv::Scalar::all(0));
+
+    cv::Point centre(width / 2, height / 2);
+    cv::Size outline(width * 45 / 100, height * 47 / 100);
+    cv::ellipse(face, centre, outline, 0, 0, 360, cv::Scalar(150, 175, 215), cv::FILLED, cv::LINE_AA);
+    cv::ellipse(mask, centre, outline, 0, 0, 360, cv::Scalar(255), cv::FILLED, cv::LINE_AA);
+    for (int side = -1; side <= 1; side += 2) {
+        int eyeX = centre.x + side * width / 5;
+        cv::ellipse(face, cv::Point(eyeX, height * 33 / 100), cv::Size(width * 12 / 100, height / 40), 0, 0, 360,
+                    cv::Scalar(60, 70, 90), cv::FILLED, cv::LINE_AA);
+        cv::ellipse(face, cv::Point(eyeX, height * 40 / 100), cv::Size(width / 10, height * 45 / 1000), 0, 0, 360,
+                    cv::Scalar(235, 235, 240), cv::FILLED, cv::LINE_AA);
+        cv::circle(face, cv::Point(eyeX, height * 40 / 100), std::max(2, width * 45 / 1000),
+                   cv::Scalar(40, 35, 30), cv::FILLED, cv::LINE_AA);
+    }
+    cv::ellipse(face, cv::Point(centre.x, height * 57 / 100), cv::Size(width * 7 / 100, height * 3 / 100), 0, 0, 360,
+                cv::Scalar(110, 130, 170), cv::FILLED, cv::LINE_AA);
+    cv::ellipse(face, cv::Point(centre.x, height * 70 / 100), cv::Size(width * 16 / 100, height * 35 / 1000), 0, 0, 360,
+                cv::Scalar(70, 70, 150), cv::FILLED, cv::LINE_AA);
+}
+
+bool SyntheticCapture::openSynthetic(const SyntheticSettings& settings) {
+    release();
+    settings_ = settings;
+    int faceWidth = std::max(24, settings.faceSize);
+
+    if (!settings.faceImage.empty()) {
+        cv::Mat image = cv::imread(settings.faceImage, cv::IMREAD_UNCHANGED);
+        if (image.empty()) {
+            std::cerr << "Error: Could not load synthetic face image " << settings.faceImage << std::endl;
+            return false;
+        }
+        cv::Size size(faceWidth, std::max(1, image.rows * faceWidth / image.cols));
+        cv::resize(image, image, size, 0, 0, cv::INTER_AREA);
+        if (image.channels() == 4) {
+            cv::extractChannel(image, spriteMask_, 3);
+            cv::cvtColor(image, sprite_, cv::COLOR_BGRA2BGR);
+        } else {
+            if (image.channels() == 1) {
+                cv::cvtColor(image, image, cv::COLOR_GRAY2BGR);
+            }
+            sprite_ = image;
+            spriteMask_ = cv::Mat(size, CV_8UC1, cv::Scalar(255));
+        }
+    } else {
+        drawFace(faceWidth, sprite_, spriteMask_);
+    }
+
+    rng_ = cv::RNG(settings.seed);
+    nextFrame_ = 0;
+    started_ = false;
+    truth_ = SyntheticTruth();
+    buildBackground();
+    opened_ = true;
+    return true;
+}
+
+void SyntheticCapture::release() {
+    opened_ = false;
+}
+
+void SyntheticCapture::buildBackground() {
+    // Vertical gradient, like a dim wall lit from above
+    background_.create(height_, width_, CV_8UC3);
+    for (int y = 0; y < height_; y++) {
+        double level = 100.0 - 50.0 * y / height_;
+        background_.row(y).setTo(cv::Scalar(level + 10, level + 5, level));
+    }
+}
+
+bool SyntheticCapture::grab() {
+    if (!opened_) {
+        return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (!started_) {
+        startTime_ = now;
+        started_ = true;
+    }
+
+    uint64_t frame = nextFrame_;
+    if (settings_.realtime) {
+        // A real camera keeps running while the tracker is busy: skip ahead (dropping
+        // frames) when behind, otherwise wait for the frame's due time
+        auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - startTime_).count();
+        uint64_t due = static_cast<uint64_t>(elapsedUs * fps_ / 1e6);
+        frame = std::max(frame, due);
+        auto dueTime = startTime_ + std::chrono::microseconds(static_cast<int64_t>(frame * 1e6 / fps_));
+        std::this_thread::sleep_until(dueTime);
+    }
+    nextFrame_ = frame + 1;
+
+    truth_.frame = frame;
+    truth_.timeUs = static_cast<int64_t>(frame * 1e6 / fps_);
+    render();
+    return true;
+}
+
+void SyntheticCapture::render() {
+    double seconds = truth_.timeUs / 1e6;
+    float pan = 0.0f;
+    float tilt = 0.0f;
+    syntheticTrajectory(settings_, seconds, pan, tilt);
+
+    // Place the face, then report the exact centre that was drawn
+    float halfWidth = width_ / 2.0f;
+    float halfHeight = height_ / 2.0f;
+    cv::Rect face(cvRound(halfWidth * (1.0f + pan) - sprite_.cols / 2.0f),
+                  cvRound(halfHeight * (1.0f + tilt) - sprite_.rows / 2.0f), sprite_.cols, sprite_.rows);
+    truth_.face = face;
+    truth_.pan = (face.x + face.width / 2.0f - halfWidth) / halfWidth;
+    truth_.tilt = (face.y + face.height / 2.0f - halfHeight) / halfHeight;
+
+    background_.copyTo(frame_);
+    cv::Rect visible = face & cv::Rect(0, 0, width_, height_);
+    if (visible.area() > 0) {
+        cv::Rect source(visible.x - face.x, visible.y - face.y, visible.width, visible.height);
+        sprite_(source).copyTo(frame_(visible), spriteMask_(source));
+    }
+
+    double gain = settings_.lighting;
+    if (settings_.lightDrift > 0.0f) {
+        double period = std::max(100, settings_.periodMs) / 1000.0;
+        gain *= 1.0 + settings_.lightDrift * std::sin(TWO_PI * seconds / period);
+    }
+    if (gain != 1.0) {
+        frame_.convertTo(frame_, -1, gain, 0);
+    }
+    if (settings_.blur > 0.0f) {
+        cv::GaussianBlur(frame_, frame_, cv::Size(0, 0), settings_.blur);
+    }
+    if (settings_.noise > 0.0f) {
+        noise_.create(frame_.size(), CV_16SC3);
+        rng_.fill(noise_, cv::RNG::NORMAL, 0.0, settings_.noise);
+        cv::add(frame_, noise_, frame_, cv::noArray(), CV_8U);
+    }
+}
+
+bool SyntheticCapture::retrieve(cv::OutputArray image, int /*flag*/) {
+    if (!opened_ || !started_) {
+        image.release();
+        return false;
+    }
+    frame_.copyTo(image); // The next grab() renders over frame_
+    return true;
+}
+
+bool SyntheticCapture::read(cv::OutputArray image) {
+    if (!grab()) {
+        image.release();
+        return false;
+    }
+    return retrieve(image);
+}
+
+cv::VideoCapture& SyntheticCapture::operator>>(cv::Mat& image) {
+    read(image);
+    return *this;
+}
+
+bool SyntheticCapture::set(int propId, double value) {
+    switch (propId) {
+        case cv::CAP_PROP_FRAME_WIDTH:
+            width_ = std::max(64, static_cast<int>(value));
+            buildBackground();
+            return true;
+        case cv::CAP_PROP_FRAME_HEIGHT:
+            height_ = std::max(64, static_cast<int>(value));
+            buildBackground();
+            return true;
+        case cv::CAP_PROP_FPS:
+            if (value <= 0.0) return false;
+            fps_ = value;
+            return true;
+        case cv::CAP_PROP_CONVERT_RGB:
+            return value != 0.0; // Frames are rendered in BGR only
+        default:
+            return false;        // Exposure, focus, FOURCC, ...: nothing to adjust
+    }
+}
+
+double SyntheticCapture::get(int propId) const {
+    switch (propId) {
+        case cv::CAP_PROP_FRAME_WIDTH: return width_;
+        case cv::CAP_PROP_FRAME_HEIGHT: return height_;
+        case cv::CAP_PROP_FPS: return fps_;
+        case cv::CAP_PROP_CONVERT_RGB: return 1.0;
+        case cv::CAP_PROP_POS_FRAMES: return static_cast<double>(nextFrame_);
+        case cv::CAP_PROP_POS_MSEC: return truth_.timeUs / 1000.0;
+        default: return 0.0;
+    }
+}
+
+SyntheticTruthLog::~SyntheticTruthLog() {
+    close();
+}
+
+bool SyntheticTruthLog::open(const std::string& path) {
+    close();
+    file_ = std::fopen(path.c_str(), "w");
+    if (!file_) {
+        std::cerr << "Error: Could not write synthetic ground truth to " << path << std::endl;
+        return false;
+    }
+    path_ = path;
+    truthPan_.clear();
+    smoothedPan_.clear();
+    frames_ = 0;
+    detected_ = 0;
+    panError_ = 0.0;
+    tiltError_ = 0.0;
+    maxError_ = 0.0f;
+    latencyTotalUs_ = 0;
+    latencyFrames_ = 0;
+    std::fputs("frame,time_ms,truth_pan,truth_tilt,detected,pan,tilt,smoothed_pan,smoothed_tilt,latency_ms\n", file_);
+    return true;
+}
+
+void SyntheticTruthLog::record(const SyntheticTruth& truth, bool detected, float pan, float tilt,
+                               float smoothedPan, float smoothedTilt, int64_t latencyUs) {
+    if (!file_) {
+        return;
+    }
+    std::fprintf(file_, "%llu,%.3f,%.4f,%.4f,%d,%.4f,%.4f,%.4f,%.4f,%.3f\n",
+                 static_cast<unsigned long long>(truth.frame), truth.timeUs / 1000.0, truth.pan, truth.tilt,
+                 detected ? 1 : 0, pan, tilt, smoothedPan, smoothedTilt, latencyUs >= 0 ? latencyUs / 1000.0 : -1.0);
+
+    if (frames_ == 0) {
+        firstTimeUs_ = truth.timeUs;
+        wallStart_ = std::chrono::steady_clock::now();
+    }
+    lastTimeUs_ = truth.timeUs;
+    frames_++;
+    truthPan_.push_back(truth.pan);
+    smoothedPan_.push_back(smoothedPan);
+    if (detected) {
+        detected_++;
+        float panError = std::abs(pan - truth.pan);
+        float tiltError = std::abs(tilt - truth.tilt);
+        panError_ += panError;
+        tiltError_ += tiltError;
+        maxError_ = std::max(maxError_, std::max(panError, tiltError));
+    }
+    if (latencyUs >= 0) {
+        latencyTotalUs_ += latencyUs;
+        latencyFrames_++;
+    }
+}
+
+void SyntheticTruthLog::close() {
+    if (!file_) {
+        return;
+    }
+    std::fclose(file_);
+    file_ = nullptr;
+    if (frames_ < 2) {
+        return;
+    }
+
+    // Lag: the shift that best lines the smoothed pan up with the ground truth
+    size_t bestShift = 0;
+    double bestError = -1.0;
+    size_t maxShift = std::min<size_t>(90, truthPan_.size() / 2);
+    for (size_t shift = 0; shift <= maxShift; shift++) {
+        double error = 0.0;
+        for (size_t i = shift; i < truthPan_.size(); i++) {
+            error += std::abs(smoothedPan_[i] - truthPan_[i - shift]);
+        }
+        error /= static_cast<double>(truthPan_.size() - shift);
+        if (bestError < 0.0 || error < bestError) {
+            bestError = error;
+            bestShift = shift;
+        }
+    }
+    double frameMs = (lastTimeUs_ - firstTimeUs_) / 1000.0 / static_cast<double>(frames_ - 1);
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart_).count();
+
+    char line[256];
+    std::cout << "Synthetic run (" << path_ << "):" << std::endl;
+    std::snprintf(line, sizeof(line), "  %llu frames at %.1f fps, face found in %.1f%%",
+                  static_cast<unsigned long long>(frames_), wallSeconds > 0.0 ? frames_ / wallSeconds : 0.0,
+                  100.0 * detected_ / frames_);
+    std::cout << line << std::endl;
+    if (detected_ > 0) {
+        std::snprintf(line, sizeof(line), "  pose error: pan %.3f, tilt %.3f mean, %.3f max",
+                      panError_ / detected_, tiltError_ / detected_, maxError_);
+        std::cout << line << std::endl;
+    }
+    std::snprintf(line, sizeof(line), "  smoothed pan lags ground truth by ~%zu frames (%.0f ms)",
+                  bestShift, bestShift * frameMs);
+    std::cout << line << std::endl;
+    if (latencyFrames_ > 0) {
+        std::snprintf(line, sizeof(line), "  capture to pose: %.2f ms mean", latencyTotalUs_ / 1000.0 / latencyFrames_);
+        std::cout << line << std::endl;
+    }
+}
@@ -0,0 +1,132 @@
+// Synthetic camera with ground truth (captureBackend "synthetic")
+//
+// A cv::VideoCapture that renders a face moving along a scripted pan/tilt
+// trajectory instead of reading a camera, so the whole pipeline (capture,
+// detection, landmarks, smoothing, output) can be measured without a person
+// in front of a lens. Runs are reproducible: the trajectory is a function of
+// the frame number and the pixel noise comes from a seeded generator.
+//
+//   - face: a sprite (syntheticFaceImage, alpha channel honoured) or a
+//     built-in drawn face, syntheticFaceSize pixels wide
+//   - motion: "lissajous", "circle", "sweep" (pan only), "steps" (jumps
+//     between fixed targets, for lag/settling) or "still"
+//   - degradation: Gaussian pixel noise, Gaussian blur, lighting gain and a
+//     slow lighting drift
+//
+// truth() describes the frame last grabbed in the tracker's own units (face
+// centre offset from the image centre, -1..1), and SyntheticTruthLog writes
+// it next to the tracked pose for every frame.
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct SyntheticSettings {
+    std::string motion = "lissajous";
+    int periodMs = 4000;       // One full cycle of the trajectory
+    float amplitude = 0.6f;    // Fraction of the pan/tilt range (0-1)
+    std::string faceImage;     // Sprite; empty = built-in drawn face
+    int faceSize = 160;        // Face width in pixels
+    float noise = 0.0f;        // Pixel noise standard deviation (gray levels)
+    float blur = 0.0f;         // Gaussian blur sigma in pixels (0 = sharp)
+    float lighting = 1.0f;     // Brightness gain
+    float lightDrift = 0.0f;   // Brightness swing over one period (0-1)
+    bool realtime = true;      // Pace frames at the capture FPS (false = as fast as they are read)
+    uint64_t seed = 1;
+};
+
+// Ground truth for one rendered frame
+struct SyntheticTruth {
+    uint64_t frame = 0;
+    int64_t timeUs = 0;    // Scripted time (frame / FPS)
+    float pan = 0.0f;      // Face centre offset from the image centre, -1..1
+    float tilt = 0.0f;
+    cv::Rect face;         // Where the face was drawn (may extend past the frame)
+};
+
+// Scripted position at `seconds` into the run
+void syntheticTrajectory(const SyntheticSettings& settings, double seconds, float& pan, float& tilt);
+
+class SyntheticCapture : public cv::VideoCapture {
+public:
+    SyntheticCapture() = default;
+    SyntheticCapture(const SyntheticCapture&) = delete;
+    SyntheticCapture& operator=(const SyntheticCapture&) = delete;
+
+    // False (with a message) if the sprite cannot be loaded
+    bool openSynthetic(const SyntheticSettings& settings);
+
+    bool isOpened() const override { return opened_; }
+    void release() override;
+    bool grab() override;
+    bool retrieve(cv::OutputArray image, int flag = 0) override;
+    bool read(cv::OutputArray image) override;
+    using cv::VideoCapture::operator>>;
+    cv::VideoCapture& operator>>(cv::Mat& image) override;
+    bool set(int propId, double value) override;
+    double get(int propId) const override;
+
+    const SyntheticTruth& truth() const { return truth_; }
+
+private:
+    void buildBackground();
+    void render();
+
+    bool opened_ = false;
+    SyntheticSettings settings_;
+    int width_ = 640;
+    int height_ = 480;
+    double fps_ = 30.0;
+
+    cv::Mat sprite_;       // BGR face
+    cv::Mat spriteMask_;   // Non-zero where the sprite is opaque
+    cv::Mat background_;   // Static backdrop, rebuilt when the size changes
+    cv::Mat frame_;
+    cv::Mat noise_;        // CV_16SC3 scratch
+    cv::RNG rng_;
+
+    uint64_t nextFrame_ = 0;
+    bool started_ = false;
+    std::chrono::steady_clock::time_point startTime_;
+    SyntheticTruth truth_;
+};
+
+// Per-frame CSV of ground truth against the tracked pose (syntheticTruthPath),
+// plus a summary of accuracy, lag and throughput when closed
+class SyntheticTruthLog {
+public:
+    SyntheticTruthLog() = default;
+    ~SyntheticTruthLog();
+    SyntheticTruthLog(const SyntheticTruthLog&) = delete;
+    SyntheticTruthLog& operator=(const SyntheticTruthLog&) = delete;
+
+    bool open(const std::string& path);
+    bool isOpen() const { return file_ != nullptr; }
+    // Tracking thread, once per processed frame; latencyUs < 0 = unknown
+    void record(const SyntheticTruth& truth, bool detected, float pan, float tilt,
+                float smoothedPan, float smoothedTilt, int64_t latencyUs);
+    // Writes the summary to stdout
+    void close();
+
+private:
+    FILE* file_ = nullptr;
+    std::string path_;
+    std::vector<float> truthPan_;      // Per recorded frame, for the lag estimate
+    std::vector<float> smoothedPan_;
+    uint64_t frames_ = 0;
+    uint64_t detected_ = 0;
+    double panError_ = 0.0;            // Sums of absolute raw pose error over detected frames
+    double tiltError_ = 0.0;
+    float maxError_ = 0.0f;
+    int64_t latencyTotalUs_ = 0;
+    uint64_t latencyFrames_ = 0;
+    int64_t firstTimeUs_ = 0;
+    int64_t lastTimeUs_ = 0;
+    std::chrono::steady_clock::time_point wallStart_;
+};
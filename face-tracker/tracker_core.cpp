@@ -0,0 +1,356 @@
+#include "tracker_core.h"
+
+#include "model_cache.h"
+#include "pose_output.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+bool setCameraProperty(cv::VideoCapture& cap, int propId, double value, const std::string& propName) {
+    bool success = cap.set(propId, value);
+    if (!success && !propName.empty()) {
+        // Property not supported by this camera backend (e.g., GStreamer)
+        // This is normal for some properties on certain cameras
+    }
+    return success;
+}
+
+void configureCameraFormat(cv::VideoCapture& cap, const Config& config) {
+    // Set camera resolution for better performance (these are usually well-supported)
+    setCameraProperty(cap, cv::CAP_PROP_FRAME_WIDTH, CAPTURE_WIDTH);
+    setCameraProperty(cap, cv::CAP_PROP_FRAME_HEIGHT, CAPTURE_HEIGHT);
+    setCameraProperty(cap, cv::CAP_PROP_FPS, 30);
+
+    // BGR (converted by the backend) or raw YUV frames whose Y plane feeds detection directly.
+    // Some backends require this to be set before opening, but we try anyway
+    CaptureFormat format = parseCaptureFormat(config.captureFormat);
+    if (!requestCaptureFormat(cap, format)) {
+        std::cout << "Camera backend refused " << captureFormatName(format) << " capture, using BGR" << std::endl;
+        requestCaptureFormat(cap, CAPTURE_BGR);
+    }
+
+    // Try to set other camera properties for better image (may not be supported)
+    setCameraProperty(cap, cv::CAP_PROP_AUTOFOCUS, 1, "autofocus");
+    setCameraProperty(cap, cv::CAP_PROP_AUTO_WB, 1, "auto white balance");
+}
+
+DetectionModels loadDetectionModels() {
+    DetectionModels models;
+
+    models.cascadePath = findModelFile("haarcascade_frontalface_alt.xml");
+    auto cascade = cv::makePtr<cv::CascadeClassifier>();
+    if (models.cascadePath.empty() || !cascade->load(models.cascadePath)) {
+        return models;
+    }
+    models.faceCascade = cascade;
+
+#ifdef HAVE_OPENCV_FACE
+    std::string facemarkPath = findModelFile("lbfmodel.yaml");
+    if (!facemarkPath.empty()) {
+        auto loadStart = std::chrono::steady_clock::now();
+        std::string loadPath = prepareModelCache(facemarkPath);
+        cv::Ptr<cv::face::Facemark> facemark = cv::face::FacemarkLBF::create();
+        try {
+            facemark->loadModel(loadPath);
+        } catch (const cv::Exception&) {
+            facemark = cv::Ptr<cv::face::Facemark>();
+            if (loadPath != facemarkPath) {
+                // Stale or corrupt cache: drop it and fall back to the YAML model
+                std::cerr << "Landmark model cache unusable, reloading " << facemarkPath << std::endl;
+                discardModelCache(facemarkPath);
+                loadPath = facemarkPath;
+                try {
+                    facemark = cv::face::FacemarkLBF::create();
+                    facemark->loadModel(loadPath);
+                } catch (const cv::Exception&) {
+                    facemark = cv::Ptr<cv::face::Facemark>();
+                }
+            }
+        }
+        if (facemark) {
+            models.facemark = facemark;
+            models.facemarkPath = loadPath;
+            models.facemarkLoadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - loadStart).count();
+        }
+    }
+#endif
+
+    // Warm-up pass at capture size: the first detect/fit call initializes OpenCV's
+    // thread pool and sizes internal buffers, which would otherwise stall frame one
+    cv::Mat warmGray(CAPTURE_HEIGHT, CAPTURE_WIDTH, CV_8UC1, cv::Scalar(128));
+    std::vector<cv::Rect> warmFaces;
+    models.faceCascade->detectMultiScale(warmGray, warmFaces, 1.1, 3, 0, cv::Size(50, 50));
+#ifdef HAVE_OPENCV_FACE
+    if (models.facemark) {
+        cv::Mat warmFrame(CAPTURE_HEIGHT, CAPTURE_WIDTH, CV_8UC3, cv::Scalar::all(128));
+        std::vector<cv::Rect> warmRects = {cv::Rect(CAPTURE_WIDTH / 2 - 100, CAPTURE_HEIGHT / 2 - 100, 200, 200)};
+        std::vector<std::vector<cv::Point2f>> warmShapes;
+        models.facemark->fit(warmFrame, warmRects, warmShapes);
+    }
+#endif
+    return models;
+}
+
+void estimateHeadPose(const std::vector<cv::Point2f>& landmarks, const cv::Size& imageSize,
+                      float& pan, float& tilt) {
+    if (landmarks.size() < 68) return; // Need full 68-point model
+
+    // Key facial landmark indices (for 68-point model)
+    // Left eye corner
+    cv::Point2f leftEye = landmarks[36];
+    // Right eye corner
+    cv::Point2f rightEye = landmarks[45];
+
+    // Calculate face center
+    cv::Point2f faceCenter = (leftEye + rightEye) / 2.0f;
+
+    // Calculate image center
+    cv::Point2f imageCenter(imageSize.width / 2.0f, imageSize.height / 2.0f);
+
+    // Pan (horizontal) - based on face center offset from image center
+    float panOffset = (faceCenter.x - imageCenter.x) / imageCenter.x;
+    pan = panOffset; // -1.0 to 1.0
+
+    // Tilt (vertical) - based on face center offset from image center
+    float tiltOffset = (faceCenter.y - imageCenter.y) / imageCenter.y;
+    tilt = tiltOffset; // -1.0 to 1.0
+
+    // Optional: Use nose direction for better pan estimation
+    // Calculate face angle from eye alignment
+    cv::Point2f eyeVector = rightEye - leftEye;
+    float eyeAngle = std::atan2(eyeVector.y, eyeVector.x);
+    // Normalize to -1 to 1 range
+    pan = pan * 0.7f + (eyeAngle / CV_PI) * 0.3f;
+}
+
+void faceCenterPose(const cv::Rect& face, const cv::Size& imageSize, float& pan, float& tilt) {
+    cv::Point2f faceCenter(face.x + face.width / 2.0f, face.y + face.height / 2.0f);
+    cv::Point2f imageCenter(imageSize.width / 2.0f, imageSize.height / 2.0f);
+    pan = (faceCenter.x - imageCenter.x) / imageCenter.x;
+    tilt = (faceCenter.y - imageCenter.y) / imageCenter.y;
+}
+
+bool PoseFilter::update(float pan, float tilt, const Config& config, std::string& gesture) {
+    currentPan = pan;
+    currentTilt = tilt;
+
+    // Improved smoothing with velocity limiting
+    smoothWithVelocity(smoothedPan, pan, panVelocity, config.smoothingFactor, config.maxVelocity / 127.0f);
+    smoothWithVelocity(smoothedTilt, tilt, tiltVelocity, config.smoothingFactor, config.maxVelocity / 127.0f);
+
+    // Add to gesture history, keeping its size limited
+    panHistory.push_back(smoothedPan);
+    tiltHistory.push_back(smoothedTilt);
+    if (panHistory.size() > historySize) {
+        panHistory.erase(panHistory.begin());
+    }
+    if (tiltHistory.size() > historySize) {
+        tiltHistory.erase(tiltHistory.begin());
+    }
+
+    // Detect gestures
+    if (gestureCooldown > 0) {
+        gestureCooldown--;
+    }
+    gesture.clear();
+    if (gestureCooldown == 0 && panHistory.size() >= 10) {
+        gesture = detectGesture(panHistory, tiltHistory, smoothedPan, smoothedTilt);
+        if (!gesture.empty() && gesture != lastGesture) {
+            lastGesture = gesture;
+            gestureCooldown = 30; // Cooldown to prevent duplicate detections
+            return true;
+        }
+    }
+    return false;
+}
+
+void PoseFilter::reset() {
+    smoothedPan = smoothedTilt = 0.0f;
+    panVelocity = tiltVelocity = 0.0f;
+    panHistory.clear();
+    tiltHistory.clear();
+}
+
+TrackerCore::~TrackerCore() {
+    stop();
+}
+
+bool TrackerCore::loadModels(std::string& error) {
+    if (!modelsLoaded_) {
+        models_ = loadDetectionModels();
+        modelsLoaded_ = static_cast<bool>(models_.faceCascade);
+    }
+    if (!modelsLoaded_) {
+        error = "haarcascade_frontalface_alt.xml not found (run from the repository or face-tracker/build/bin)";
+        return false;
+    }
+    return true;
+}
+
+bool TrackerCore::start(const Config& config, PoseCallback callback, std::string& error) {
+    if (running_) {
+        error = "tracker is already running";
+        return false;
+    }
+    if (thread_.joinable()) {
+        thread_.join(); // Ended on its own (TRACKER_FAILED)
+    }
+    if (!loadModels(error)) {
+        return false;
+    }
+    updateConfig(config);
+    applyPendingConfig();
+
+    camera_ = std::make_unique<cv::VideoCapture>(config.cameraIndex);
+    if (!camera_->isOpened()) {
+        error = "could not open camera " + std::to_string(config.cameraIndex);
+        camera_.reset();
+        return false;
+    }
+    configureCameraFormat(*camera_, config);
+
+    callback_ = std::move(callback);
+    running_ = true;
+    thread_ = std::thread(&TrackerCore::run, this);
+    return true;
+}
+
+void TrackerCore::stop() {
+    if (!running_ && !thread_.joinable()) {
+        return;
+    }
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    camera_.reset();
+    callback_ = nullptr;
+}
+
+void TrackerCore::updateConfig(const Config& config) {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    pendingConfig_ = config;
+    configVersion_.fetch_add(1, std::memory_order_release);
+}
+
+// Tracking thread: take the latest updateConfig() (the copy only happens on a change)
+void TrackerCore::applyPendingConfig() {
+    uint64_t version = configVersion_.load(std::memory_order_acquire);
+    if (version != appliedVersion_) {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        config_ = pendingConfig_;
+        appliedVersion_ = version;
+    }
+}
+
+bool TrackerCore::processFrame(const cv::Mat& image, int64_t timestampUs, TrackedPose& pose, std::string& error) {
+    if (running_) {
+        error = "tracker is running on its own camera";
+        return false;
+    }
+    if (image.empty() || (image.channels() != 1 && image.channels() != 3)) {
+        error = "expected a BGR or gray image";
+        return false;
+    }
+    if (!loadModels(error)) {
+        return false;
+    }
+    applyPendingConfig();
+    preprocessor_.process(image, config_.brightness, config_.contrast, adjusted_, gray_);
+    track(adjusted_, gray_, timestampUs, config_, pose);
+    return true;
+}
+
+void TrackerCore::run() {
+    CameraFrame frame;
+    TrackedPose pose;
+    auto lastFrame = std::chrono::steady_clock::now();
+    auto lastStallReport = lastFrame;
+    bool stalled = false;
+    try {
+        while (running_) {
+            applyPendingConfig();
+            if (!frame.read(*camera_)) {
+                // Unplugged or wedged: once the watchdog timeout passes, report the stall
+                // (with the failsafe position) and repeat it every second until frames return
+                auto now = std::chrono::steady_clock::now();
+                if (config_.watchdogTimeoutMs > 0 &&
+                    now - lastFrame >= std::chrono::milliseconds(config_.watchdogTimeoutMs) &&
+                    (!stalled || now - lastStallReport >= std::chrono::seconds(1))) {
+                    stalled = true;
+                    lastStallReport = now;
+                    report(pose, TRACKER_STALLED);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            lastFrame = std::chrono::steady_clock::now();
+            stalled = false;
+            // Raw YUV: the Y plane already is the gray image (MJPEG has no plane, decode it)
+            bool luma = frame.isRaw() && frame.format() != CAPTURE_MJPEG;
+            preprocessor_.process(luma ? frame.luma() : frame.bgr(), config_.brightness, config_.contrast, adjusted_, gray_);
+            track(adjusted_, gray_, frame.timestampUs(), config_, pose);
+            pose.status = TRACKER_TRACKING;
+            callback_(pose);
+        }
+    } catch (const std::exception& e) {
+        // cv::Exception from the camera or a detector: must not escape the thread (std::terminate)
+        running_ = false;
+        report(pose, TRACKER_FAILED, e.what());
+    } catch (...) {
+        running_ = false;
+        report(pose, TRACKER_FAILED, "unknown error");
+    }
+}
+
+// Tracking thread: a stall or failure pose, carrying the failsafe position
+void TrackerCore::report(TrackedPose& pose, TrackerStatus status, const std::string& error) {
+    pose.status = status;
+    pose.error = error;
+    pose.face = false;
+    pose.landmarks = false;
+    pose.gesture.clear();
+    pose.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    failsafePosition(config_, pose.panDmx, pose.tiltDmx);
+    try {
+        callback_(pose);
+    } catch (...) {
+        // Nothing left to report to
+    }
+    pose.error.clear();
+}
+
+void TrackerCore::track(const cv::Mat& adjusted, const cv::Mat& gray, int64_t timestampUs, const Config& config,
+                        TrackedPose& pose) {
+    pose.frame = frames_.fetch_add(1, std::memory_order_relaxed);
+    pose.timestampUs = timestampUs;
+    pose.landmarks = false;
+    pose.gesture.clear();
+
+    models_.faceCascade->detectMultiScale(gray, faces_, 1.1, 3, 0, cv::Size(50, 50));
+    pose.face = !faces_.empty();
+    if (pose.face) {
+        float pan = 0.0f, tilt = 0.0f;
+#ifdef HAVE_OPENCV_FACE
+        if (models_.facemark && models_.facemark->fit(adjusted, faces_, shapes_) &&
+            !shapes_.empty() && shapes_[0].size() >= 68) {
+            estimateHeadPose(shapes_[0], adjusted.size(), pan, tilt);
+            pose.landmarks = true;
+        }
+#endif
+        if (!pose.landmarks) {
+            faceCenterPose(faces_[0], adjusted.size(), pan, tilt); // First detected face
+        }
+        if (!filter_.update(pan, tilt, config, pose.gesture)) {
+            pose.gesture.clear(); // Only new gestures are reported
+        }
+    }
+    pose.pan = filter_.currentPan;
+    pose.tilt = filter_.currentTilt;
+    pose.smoothedPan = filter_.smoothedPan;
+    pose.smoothedTilt = filter_.smoothedTilt;
+    mapToDmx(filter_.smoothedPan, filter_.smoothedTilt, config, pose.panDmx, pose.tiltDmx);
+}
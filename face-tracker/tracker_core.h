@@ -0,0 +1,170 @@
+// Face tracking core: detection models, head pose, smoothing and gestures,
+// plus a self-contained camera-to-pose loop
+//
+// The face-tracker executable builds its tracking loop (previews, outputs,
+// servers) around these pieces; the facetracker_core library adds the C API
+// in facetracker.h on top of TrackerCore, which the Node addon in node/ uses
+// to track in-process. TrackerCore only produces poses: it sends nothing to
+// DMX/OSC, that is left to whoever receives the callback.
+#pragma once
+
+#include "camera_frame.h"
+#include "config.h"
+#include "preprocess.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/objdetect.hpp>
+#include <opencv2/videoio.hpp>
+#ifdef HAVE_OPENCV_FACE
+#include <opencv2/face.hpp>
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Capture size requested from cameras (also the model warm-up size)
+const int CAPTURE_WIDTH = 640;
+const int CAPTURE_HEIGHT = 480;
+
+// Set a camera property; false if the backend does not support it
+bool setCameraProperty(cv::VideoCapture& cap, int propId, double value, const std::string& propName = "");
+
+// Resolution, frame rate and pixel format for a freshly opened camera
+void configureCameraFormat(cv::VideoCapture& cap, const Config& config);
+
+// Detection models loaded (and warmed up), typically on a startup worker thread
+struct DetectionModels {
+    cv::Ptr<cv::CascadeClassifier> faceCascade; // Empty if the cascade could not be loaded
+    std::string cascadePath;
+#ifdef HAVE_OPENCV_FACE
+    cv::Ptr<cv::face::Facemark> facemark;       // Empty if no landmark model was found
+    std::string facemarkPath;
+    long long facemarkLoadMs = 0;
+#endif
+};
+
+// Finds the models with findModelFile() (model_cache.h)
+DetectionModels loadDetectionModels();
+
+// Estimate head pose from 68 facial landmarks (pan/tilt -1..1; unchanged for fewer points)
+void estimateHeadPose(const std::vector<cv::Point2f>& landmarks, const cv::Size& imageSize,
+                      float& pan, float& tilt);
+
+// Face rectangle centre relative to the image centre, -1..1 (fallback without landmarks)
+void faceCenterPose(const cv::Rect& face, const cv::Size& imageSize, float& pan, float& tilt);
+
+// Smoothing and gesture state of the tracked pose
+struct PoseFilter {
+    float currentPan = 0.0f;    // Raw pose of the last update
+    float currentTilt = 0.0f;
+    float smoothedPan = 0.0f;
+    float smoothedTilt = 0.0f;
+    float panVelocity = 0.0f;   // Velocity for smoother movement
+    float tiltVelocity = 0.0f;
+    std::vector<float> panHistory;  // Smoothed pose history for gesture detection
+    std::vector<float> tiltHistory;
+    size_t historySize = 30;    // Frames to track (about 1 second at 30fps)
+    std::string lastGesture;    // Last detected gesture
+    int gestureCooldown = 0;    // Frames before another gesture can be reported
+
+    // Smooth toward a raw pose. `gesture` gets the gesture seen this update
+    // (or ""); true when it is newly detected (not a repeat of lastGesture).
+    bool update(float pan, float tilt, const Config& config, std::string& gesture);
+    // Back to centre with no history (start of a new session)
+    void reset();
+};
+
+// What a TrackedPose reports
+enum TrackerStatus {
+    TRACKER_TRACKING,   // A camera frame was tracked
+    TRACKER_STALLED,    // No camera frame for watchdogTimeoutMs (repeated every second while it lasts)
+    TRACKER_FAILED      // The tracking thread hit an error and stopped; `error` says why
+};
+
+// One tracked frame, as handed to TrackerCore's callback. For a stall or a
+// failure the pose fields are the last ones and panDmx/tiltDmx hold the
+// failsafe position (failsafePan/failsafeTilt or home).
+struct TrackedPose {
+    uint64_t frame = 0;
+    int64_t timestampUs = 0;    // Capture time (CameraFrame::timestampUs clock)
+    bool face = false;          // A face was found; the pose below is from this frame
+    bool landmarks = false;     // Pose came from facial landmarks
+    float pan = 0.0f;           // Raw pose, -1..1
+    float tilt = 0.0f;
+    float smoothedPan = 0.0f;
+    float smoothedTilt = 0.0f;
+    int panDmx = 0;             // mapToDmx() of the smoothed pose
+    int tiltDmx = 0;
+    std::string gesture;        // Newly detected gesture, or ""
+    TrackerStatus status = TRACKER_TRACKING;
+    std::string error;          // TRACKER_FAILED only
+};
+
+// Camera-to-pose tracking on its own thread, with no outputs, previews or servers
+class TrackerCore {
+public:
+    using PoseCallback = std::function<void(const TrackedPose&)>;
+
+    TrackerCore() = default;
+    ~TrackerCore();
+    TrackerCore(const TrackerCore&) = delete;
+    TrackerCore& operator=(const TrackerCore&) = delete;
+
+    // Load the models on first use (seconds); false with `error` set if they are missing
+    bool loadModels(std::string& error);
+
+    // Open config.cameraIndex (OpenCV backend, config.captureFormat honoured) and
+    // track on a new thread; `callback` runs on that thread once per frame, and
+    // for stalls and the final error (see TrackerStatus)
+    bool start(const Config& config, PoseCallback callback, std::string& error);
+    // Joins the tracking thread: no callback runs after this returns. Also
+    // needed after a TRACKER_FAILED pose before the next start().
+    void stop();
+    // False once stopped or failed
+    bool isRunning() const { return running_; }
+
+    // Picked up between frames. Camera fields apply on the next start().
+    void updateConfig(const Config& config);
+
+    // Track one BGR or gray frame supplied by the caller, on the caller's thread
+    // (not while start()ed). Smoothing carries over between calls.
+    bool processFrame(const cv::Mat& image, int64_t timestampUs, TrackedPose& pose, std::string& error);
+
+    void resetPose() { filter_.reset(); }
+    uint64_t frameCount() const { return frames_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void report(TrackedPose& pose, TrackerStatus status, const std::string& error = "");
+    void applyPendingConfig();
+    void track(const cv::Mat& adjusted, const cv::Mat& gray, int64_t timestampUs, const Config& config,
+               TrackedPose& pose);
+
+    DetectionModels models_;
+    bool modelsLoaded_ = false;
+    std::unique_ptr<cv::VideoCapture> camera_;
+    PoseCallback callback_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> frames_{0};
+
+    std::mutex configMutex_;
+    Config pendingConfig_;                    // Guarded by configMutex_
+    std::atomic<uint64_t> configVersion_{0};  // Bumped by updateConfig()
+    Config config_;                           // Tracking thread's copy
+    uint64_t appliedVersion_ = 0;
+
+    // Tracking thread (or processFrame() caller) only
+    PoseFilter filter_;
+    FramePreprocessor preprocessor_;
+    cv::Mat adjusted_;
+    cv::Mat gray_;
+    std::vector<cv::Rect> faces_;
+    std::vector<std::vector<cv::Point2f>> shapes_;
+};
@@ -0,0 +1,451 @@
+#include "v4l2_capture.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+    #include <linux/videodev2.h>
+    #include <sys/ioctl.h>
+    #include <sys/mman.h>
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+// Same limit as OpenCV's V4L2 backend before a grab gives up
+static const int V4L2_FRAME_TIMEOUT_MS = 10000;
+
+V4l2Capture::~V4l2Capture() {
+    release();
+}
+
+bool V4l2Capture::read(cv::OutputArray image) {
+    if (!grab()) {
+        image.release();
+        return false;
+    }
+    return retrieve(image);
+}
+
+cv::VideoCapture& V4l2Capture::operator>>(cv::Mat& image) {
+    read(image);
+    return *this;
+}
+
+bool V4l2Capture::isMappedFrame(const cv::Mat& frame) const {
+    for (const MappedBuffer& buffer : buffers_) {
+        const uchar* start = static_cast<const uchar*>(buffer.start);
+        if (frame.data >= start && frame.data < start + buffer.length) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef __linux__
+
+static int xioctl(int fd, unsigned long request, void* arg) {
+    int result;
+    do {
+        result = ioctl(fd, request, arg);
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+
+static std::string fourccName(uint32_t fourcc) {
+    std::string name;
+    for (int i = 0; i < 4; i++) {
+        name += static_cast<char>((fourcc >> (8 * i)) & 0xff);
+    }
+    return name;
+}
+
+// Layouts retrieve() can wrap without conversion (MJPEG as its compressed bytes)
+static bool supportedPixelFormat(uint32_t format) {
+    return format == V4L2_PIX_FMT_YUYV || format == V4L2_PIX_FMT_NV12 ||
+           format == V4L2_PIX_FMT_GREY || format == V4L2_PIX_FMT_BGR24 ||
+           format == V4L2_PIX_FMT_MJPEG;
+}
+
+bool V4l2Capture::openDevice(int index, int bufferCount) {
+    release();
+    device_ = "/dev/video" + std::to_string(index);
+    requestedBuffers_ = std::max(2, std::min(V4L2_MAX_BUFFERS, bufferCount));
+
+    fd_ = ::open(device_.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open " << device_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    v4l2_capability capability;
+    std::memset(&capability, 0, sizeof(capability));
+    if (xioctl(fd_, VIDIOC_QUERYCAP, &capability) < 0) {
+        std::cerr << device_ << " is not a V4L2 device: " << std::strerror(errno) << std::endl;
+        release();
+        return false;
+    }
+    uint32_t caps = (capability.capabilities & V4L2_CAP_DEVICE_CAPS) ? capability.device_caps : capability.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        std::cerr << device_ << " (" << capability.card << ") does not support streaming capture" << std::endl;
+        release();
+        return false;
+    }
+    return true;
+}
+
+void V4l2Capture::release() {
+    stopStreaming();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    pixelFormat_ = 0;
+    width_ = height_ = bytesPerLine_ = 0;
+    fps_ = 0.0;
+}
+
+bool V4l2Capture::startStreaming() {
+    v4l2_format format;
+    std::memset(&format, 0, sizeof(format));
+    format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    format.fmt.pix.width = requestedWidth_;
+    format.fmt.pix.height = requestedHeight_;
+    format.fmt.pix.pixelformat = requestedFourcc_ ? requestedFourcc_ : V4L2_PIX_FMT_YUYV;
+    format.fmt.pix.field = V4L2_FIELD_ANY;
+    if (xioctl(fd_, VIDIOC_S_FMT, &format) < 0) {
+        std::cerr << "Failed to set the capture format on " << device_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (!supportedPixelFormat(format.fmt.pix.pixelformat)) {
+        // Driver substituted something we cannot wrap (e.g. H.264): YUYV is near-universal
+        format.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+        if (xioctl(fd_, VIDIOC_S_FMT, &format) < 0 || !supportedPixelFormat(format.fmt.pix.pixelformat)) {
+            std::cerr << device_ << " only offers " << fourccName(format.fmt.pix.pixelformat)
+                      << " frames; use captureBackend \"opencv\" for this camera" << std::endl;
+            return false;
+        }
+    }
+    pixelFormat_ = format.fmt.pix.pixelformat;
+    width_ = static_cast<int>(format.fmt.pix.width);
+    height_ = static_cast<int>(format.fmt.pix.height);
+    bytesPerLine_ = static_cast<int>(format.fmt.pix.bytesperline);
+    if (bytesPerLine_ == 0) {
+        bytesPerLine_ = width_ * (pixelFormat_ == V4L2_PIX_FMT_YUYV ? 2 : pixelFormat_ == V4L2_PIX_FMT_BGR24 ? 3 : 1);
+    }
+
+    // Frame rate, where the driver lets us choose it
+    v4l2_streamparm parm;
+    std::memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd_, VIDIOC_G_PARM, &parm) == 0 && (parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME) &&
+        requestedFps_ > 0.0) {
+        parm.parm.capture.timeperframe.numerator = 1000;
+        parm.parm.capture.timeperframe.denominator = static_cast<uint32_t>(std::lround(requestedFps_ * 1000.0));
+        xioctl(fd_, VIDIOC_S_PARM, &parm);
+    }
+    const v4l2_fract& interval = parm.parm.capture.timeperframe;
+    fps_ = interval.numerator ? static_cast<double>(interval.denominator) / interval.numerator : 0.0;
+
+    v4l2_requestbuffers request;
+    std::memset(&request, 0, sizeof(request));
+    request.count = requestedBuffers_;
+    request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    request.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_REQBUFS, &request) < 0 || request.count < 2) {
+        std::cerr << "Failed to allocate capture buffers on " << device_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    buffers_.resize(request.count);
+    for (uint32_t i = 0; i < request.count; i++) {
+        v4l2_buffer buffer;
+        std::memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i;
+        if (xioctl(fd_, VIDIOC_QUERYBUF, &buffer) < 0) {
+            std::cerr << "Failed to query capture buffer " << i << ": " << std::strerror(errno) << std::endl;
+            stopStreaming();
+            return false;
+        }
+        void* start = mmap(nullptr, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buffer.m.offset);
+        if (start == MAP_FAILED) {
+            std::cerr << "Failed to map capture buffer " << i << ": " << std::strerror(errno) << std::endl;
+            stopStreaming();
+            return false;
+        }
+        buffers_[i].start = start;
+        buffers_[i].length = buffer.length;
+        if (xioctl(fd_, VIDIOC_QBUF, &buffer) < 0) {
+            std::cerr << "Failed to queue capture buffer " << i << ": " << std::strerror(errno) << std::endl;
+            stopStreaming();
+            return false;
+        }
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) {
+        std::cerr << "Failed to start streaming on " << device_ << ": " << std::strerror(errno) << std::endl;
+        stopStreaming();
+        return false;
+    }
+    streaming_ = true;
+    haveSequence_ = false;
+    std::cout << "V4L2 capture: " << device_ << " " << width_ << "x" << height_ << " " << fourccName(pixelFormat_)
+              << " @ " << fps_ << " fps, " << buffers_.size() << " mmap buffers" << std::endl;
+    return true;
+}
+
+void V4l2Capture::stopStreaming() {
+    if (fd_ >= 0 && streaming_) {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(fd_, VIDIOC_STREAMOFF, &type); // Also takes back every queued buffer
+    }
+    streaming_ = false;
+    current_ = -1;
+    if (buffers_.empty()) {
+        return;
+    }
+    for (MappedBuffer& buffer : buffers_) {
+        if (buffer.start) {
+            munmap(buffer.start, buffer.length);
+        }
+    }
+    buffers_.clear();
+    if (fd_ >= 0) {
+        v4l2_requestbuffers request;
+        std::memset(&request, 0, sizeof(request));
+        request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        request.memory = V4L2_MEMORY_MMAP;
+        xioctl(fd_, VIDIOC_REQBUFS, &request); // count 0 frees the driver's buffers
+    }
+}
+
+bool V4l2Capture::requeueCurrent() {
+    if (current_ < 0) {
+        return true;
+    }
+    v4l2_buffer buffer;
+    std::memset(&buffer, 0, sizeof(buffer));
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    buffer.index = current_;
+    current_ = -1;
+    return xioctl(fd_, VIDIOC_QBUF, &buffer) == 0;
+}
+
+bool V4l2Capture::grab() {
+    if (fd_ < 0) {
+        return false;
+    }
+    if (!streaming_ && !startStreaming()) {
+        return false;
+    }
+    if (!requeueCurrent()) {
+        std::cerr << "Failed to return a capture buffer to " << device_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    while (true) {
+        pollfd pfd = {fd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, V4L2_FRAME_TIMEOUT_MS);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            std::cerr << "No frame from " << device_ << " within " << V4L2_FRAME_TIMEOUT_MS / 1000 << " s" << std::endl;
+            return false;
+        }
+
+        v4l2_buffer buffer;
+        std::memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(fd_, VIDIOC_DQBUF, &buffer) < 0) {
+            if (errno == EAGAIN) {
+                continue;
+            }
+            std::cerr << "Failed to dequeue a frame from " << device_ << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (buffer.flags & V4L2_BUF_FLAG_ERROR) {
+            xioctl(fd_, VIDIOC_QBUF, &buffer); // Corrupted frame: hand it back and wait for the next one
+            continue;
+        }
+
+        current_ = static_cast<int>(buffer.index);
+        bytesUsed_ = buffer.bytesused;
+        if (haveSequence_ && buffer.sequence > lastSequence_ + 1) {
+            dropped_ += buffer.sequence - lastSequence_ - 1;
+        }
+        lastSequence_ = buffer.sequence;
+        haveSequence_ = true;
+
+        if ((buffer.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+            timestampUs_ = static_cast<int64_t>(buffer.timestamp.tv_sec) * 1000000 + buffer.timestamp.tv_usec;
+        } else {
+            // Driver without kernel timestamps: dequeue time is the best we have
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            timestampUs_ = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+        }
+        return true;
+    }
+}
+
+bool V4l2Capture::retrieve(cv::OutputArray image, int /*flag*/) {
+    if (current_ < 0) {
+        image.release();
+        return false;
+    }
+
+    // Header over the driver's buffer: no copy
+    uchar* data = static_cast<uchar*>(buffers_[current_].start);
+    size_t step = static_cast<size_t>(bytesPerLine_);
+    cv::Mat view;
+    switch (pixelFormat_) {
+        case V4L2_PIX_FMT_YUYV: view = cv::Mat(height_, width_, CV_8UC2, data, step); break;
+        case V4L2_PIX_FMT_NV12: view = cv::Mat(height_ * 3 / 2, width_, CV_8UC1, data, step); break;
+        case V4L2_PIX_FMT_GREY: view = cv::Mat(height_, width_, CV_8UC1, data, step); break;
+        case V4L2_PIX_FMT_BGR24: view = cv::Mat(height_, width_, CV_8UC3, data, step); break;
+        case V4L2_PIX_FMT_MJPEG: view = cv::Mat(1, static_cast<int>(bytesUsed_), CV_8UC1, data); break;
+        default:
+            image.release();
+            return false;
+    }
+
+    if (!convertRgb_ || pixelFormat_ == V4L2_PIX_FMT_BGR24) {
+        image.assign(view);
+        return true;
+    }
+    if (pixelFormat_ == V4L2_PIX_FMT_MJPEG) {
+        converted_ = cv::imdecode(view, cv::IMREAD_COLOR);
+        image.assign(converted_);
+        return !converted_.empty();
+    }
+    int code = pixelFormat_ == V4L2_PIX_FMT_YUYV ? cv::COLOR_YUV2BGR_YUYV
+             : pixelFormat_ == V4L2_PIX_FMT_NV12 ? cv::COLOR_YUV2BGR_NV12
+             : cv::COLOR_GRAY2BGR;
+    cv::cvtColor(view, converted_, code);
+    image.assign(converted_);
+    return true;
+}
+
+int V4l2Capture::controlId(int propId) const {
+    switch (propId) {
+        case cv::CAP_PROP_BRIGHTNESS: return V4L2_CID_BRIGHTNESS;
+        case cv::CAP_PROP_CONTRAST: return V4L2_CID_CONTRAST;
+        case cv::CAP_PROP_GAIN: return V4L2_CID_GAIN;
+        case cv::CAP_PROP_EXPOSURE: return V4L2_CID_EXPOSURE_ABSOLUTE;
+        case cv::CAP_PROP_AUTO_EXPOSURE: return V4L2_CID_EXPOSURE_AUTO;
+        case cv::CAP_PROP_AUTOFOCUS: return V4L2_CID_FOCUS_AUTO;
+        case cv::CAP_PROP_AUTO_WB: return V4L2_CID_AUTO_WHITE_BALANCE;
+        default: return 0;
+    }
+}
+
+bool V4l2Capture::set(int propId, double value) {
+    if (fd_ < 0) {
+        return false;
+    }
+    switch (propId) {
+        case cv::CAP_PROP_FRAME_WIDTH: requestedWidth_ = static_cast<int>(value); break;
+        case cv::CAP_PROP_FRAME_HEIGHT: requestedHeight_ = static_cast<int>(value); break;
+        case cv::CAP_PROP_FPS: requestedFps_ = value; break;
+        case cv::CAP_PROP_BUFFERSIZE:
+            requestedBuffers_ = std::max(2, std::min(V4L2_MAX_BUFFERS, static_cast<int>(value)));
+            break;
+        case cv::CAP_PROP_CONVERT_RGB:
+            convertRgb_ = value != 0.0;
+            return true; // Only changes what retrieve() hands out
+        case cv::CAP_PROP_FOURCC: {
+            // Ask the driver now so the caller learns whether the format exists
+            v4l2_format format;
+            std::memset(&format, 0, sizeof(format));
+            format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            format.fmt.pix.width = requestedWidth_;
+            format.fmt.pix.height = requestedHeight_;
+            format.fmt.pix.pixelformat = static_cast<uint32_t>(value);
+            format.fmt.pix.field = V4L2_FIELD_ANY;
+            if (xioctl(fd_, VIDIOC_TRY_FMT, &format) < 0 ||
+                format.fmt.pix.pixelformat != static_cast<uint32_t>(value) ||
+                !supportedPixelFormat(format.fmt.pix.pixelformat)) {
+                return false;
+            }
+            requestedFourcc_ = format.fmt.pix.pixelformat;
+            break;
+        }
+        default: {
+            int id = controlId(propId);
+            if (!id) {
+                return false;
+            }
+            v4l2_control control;
+            control.id = id;
+            control.value = static_cast<int>(std::lround(value));
+            if (propId == cv::CAP_PROP_AUTO_EXPOSURE) {
+                // 0.75 = auto, 0.25 = manual (the convention applyCameraExposure uses)
+                control.value = value >= 0.5 ? V4L2_EXPOSURE_APERTURE_PRIORITY : V4L2_EXPOSURE_MANUAL;
+            }
+            return xioctl(fd_, VIDIOC_S_CTRL, &control) == 0;
+        }
+    }
+
+    // Format changed: restart streaming with it on the next grab()
+    stopStreaming();
+    return true;
+}
+
+double V4l2Capture::get(int propId) const {
+    switch (propId) {
+        case cv::CAP_PROP_FRAME_WIDTH: return width_ ? width_ : requestedWidth_;
+        case cv::CAP_PROP_FRAME_HEIGHT: return height_ ? height_ : requestedHeight_;
+        case cv::CAP_PROP_FPS: return fps_ > 0.0 ? fps_ : requestedFps_;
+        case cv::CAP_PROP_FOURCC: return pixelFormat_ ? pixelFormat_ : requestedFourcc_;
+        case cv::CAP_PROP_CONVERT_RGB: return convertRgb_ ? 1.0 : 0.0;
+        case cv::CAP_PROP_BUFFERSIZE: return buffers_.empty() ? requestedBuffers_ : static_cast<int>(buffers_.size());
+        case cv::CAP_PROP_POS_MSEC: return timestampUs_ / 1000.0;
+        default: break;
+    }
+    int id = controlId(propId);
+    if (!id || fd_ < 0) {
+        return 0.0;
+    }
+    v4l2_control control;
+    control.id = id;
+    control.value = 0;
+    if (xioctl(fd_, VIDIOC_G_CTRL, &control) < 0) {
+        return 0.0;
+    }
+    if (propId == cv::CAP_PROP_AUTO_EXPOSURE) {
+        return control.value == V4L2_EXPOSURE_MANUAL ? 0.25 : 0.75;
+    }
+    return control.value;
+}
+
+#else
+
+// V4L2 is Linux only; captureBackend "v4l2" falls back to OpenCV elsewhere
+bool V4l2Capture::openDevice(int /*index*/, int /*bufferCount*/) {
+    std::cerr << "V4L2 capture is only available on Linux" << std::endl;
+    return false;
+}
+
+void V4l2Capture::release() {}
+bool V4l2Capture::startStreaming() { return false; }
+void V4l2Capture::stopStreaming() {}
+bool V4l2Capture::requeueCurrent() { return false; }
+bool V4l2Capture::grab() { return false; }
+bool V4l2Capture::retrieve(cv::OutputArray image, int /*flag*/) { image.release(); return false; }
+int V4l2Capture::controlId(int /*propId*/) const { return 0; }
+bool V4l2Capture::set(int /*propId*/, double /*value*/) { return false; }
+double V4l2Capture::get(int /*propId*/) const { return 0.0; }
+
+#endif
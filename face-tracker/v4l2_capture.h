@@ -0,0 +1,103 @@
+// Direct V4L2 capture (captureBackend "v4l2", Linux only)
+//
+// A cv::VideoCapture that talks to /dev/video<N> itself instead of going
+// through OpenCV's backend, so the rest of the tracker (exposure trackbars,
+// background camera reopen, CameraFrame) uses it unchanged:
+//
+//   - mmap'd driver buffers, v4l2Buffers of them (OpenCV hides the count)
+//   - raw frames (CAP_PROP_CONVERT_RGB off, YUYV/NV12/GREY/BGR24, or MJPEG
+//     as one row of compressed bytes) are wrapped in a Mat pointing
+//     straight into the dequeued buffer: no memcpy per frame. The buffer is
+//     handed back to the driver on the next grab(), so a frame is only valid
+//     until then (the tracking loop never keeps one longer)
+//   - each frame carries the kernel's CLOCK_MONOTONIC capture timestamp,
+//     the same clock as std::chrono::steady_clock, for latency accounting
+//   - gaps in the driver's frame sequence are counted as dropped frames
+//
+// Format properties (size, fps, FOURCC, CONVERT_RGB, BUFFERSIZE) are applied
+// when streaming starts, i.e. on the first grab after they change. Camera
+// controls (exposure, brightness, ...) go to the driver immediately.
+// face-tracker-v4l2-probe exercises this against a real or vivid device.
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const int V4L2_DEFAULT_BUFFERS = 4;
+const int V4L2_MAX_BUFFERS = 32;
+
+class V4l2Capture : public cv::VideoCapture {
+public:
+    V4l2Capture() = default;
+    ~V4l2Capture() override;
+    V4l2Capture(const V4l2Capture&) = delete;
+    V4l2Capture& operator=(const V4l2Capture&) = delete;
+
+    // Open /dev/video<index>; false (with a message) if it is not a capture device
+    bool openDevice(int index, int bufferCount = V4L2_DEFAULT_BUFFERS);
+
+    bool isOpened() const override { return fd_ >= 0; }
+    void release() override;
+    bool grab() override;
+    bool retrieve(cv::OutputArray image, int flag = 0) override;
+    bool read(cv::OutputArray image) override;
+    using cv::VideoCapture::operator>>;
+    cv::VideoCapture& operator>>(cv::Mat& image) override;
+    bool set(int propId, double value) override;
+    double get(int propId) const override;
+
+    // Kernel capture time of the current frame in steady_clock microseconds (0 = none yet)
+    int64_t frameTimestampUs() const { return timestampUs_; }
+    // Frames the driver produced that were never dequeued (sequence gaps)
+    uint64_t droppedFrames() const { return dropped_; }
+    // Buffers actually allocated by the driver (may differ from the request)
+    int bufferCount() const { return static_cast<int>(buffers_.size()); }
+    uint32_t pixelFormat() const { return pixelFormat_; }
+    const std::string& device() const { return device_; }
+    // `frame` points into one of the mmap'd driver buffers (zero-copy check)
+    bool isMappedFrame(const cv::Mat& frame) const;
+
+private:
+    struct MappedBuffer {
+        void* start = nullptr;
+        size_t length = 0;
+    };
+
+    bool startStreaming();
+    void stopStreaming();
+    bool requeueCurrent();
+    int controlId(int propId) const;
+
+    int fd_ = -1;
+    std::string device_;
+    std::vector<MappedBuffer> buffers_;
+    bool streaming_ = false;
+    int current_ = -1; // Dequeued buffer, ours until the next grab()
+
+    // Requested format, applied by startStreaming()
+    int requestedBuffers_ = V4L2_DEFAULT_BUFFERS;
+    int requestedWidth_ = 640;
+    int requestedHeight_ = 480;
+    double requestedFps_ = 30.0;
+    uint32_t requestedFourcc_ = 0; // 0 = YUYV
+    bool convertRgb_ = true;
+
+    // Negotiated format
+    uint32_t pixelFormat_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    int bytesPerLine_ = 0;
+    uint32_t bytesUsed_ = 0; // Of the current buffer (varies for MJPEG)
+    double fps_ = 0.0;
+
+    int64_t timestampUs_ = 0;
+    uint32_t lastSequence_ = 0;
+    bool haveSequence_ = false;
+    uint64_t dropped_ = 0;
+    cv::Mat converted_; // BGR output when CONVERT_RGB is on
+};
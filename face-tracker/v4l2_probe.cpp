@@ -0,0 +1,143 @@
+// V4L2 capture probe - checks the direct V4L2 backend against a real or virtual camera
+//
+// Usage: face-tracker-v4l2-probe [--device N] [--frames N] [--buffers N] [--format yuyv|nv12|mjpeg] [--bgr]
+//
+//   --device   /dev/video<N> (default 0)
+//   --frames   Frames to capture (default 120)
+//   --buffers  Driver buffers to request (default 4)
+//   --format   Pixel format to request (default yuyv)
+//   --bgr      Let the backend convert to BGR instead of wrapping raw buffers
+//
+// Without a camera, the vivid driver provides one:
+//   sudo modprobe vivid && face-tracker-v4l2-probe --device <vivid index>
+//
+// Checks, exiting non-zero if any fails: every raw frame points into one of
+// the mmap'd driver buffers (zero-copy), kernel timestamps increase and are
+// no later than the dequeue time, and CameraFrame finds the luma plane
+// (MJPEG: the compressed frame decodes to the reported size).
+// Prints frame interval, timestamp-to-dequeue latency and dropped frames.
+#include "camera_frame.h"
+#include "v4l2_capture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static int64_t steadyNowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+int main(int argc, char** argv) {
+    int device = 0;
+    int frames = 120;
+    int buffers = V4L2_DEFAULT_BUFFERS;
+    std::string format = "yuyv";
+    bool bgr = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--device" && i + 1 < argc) {
+            device = std::atoi(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::max(2, std::atoi(argv[++i]));
+        } else if (arg == "--buffers" && i + 1 < argc) {
+            buffers = std::atoi(argv[++i]);
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "--bgr") {
+            bgr = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--device N] [--frames N] [--buffers N] [--format yuyv|nv12|mjpeg] [--bgr]" << std::endl;
+            return 1;
+        }
+    }
+
+    V4l2Capture cap;
+    if (!cap.openDevice(device, buffers)) {
+        return 1;
+    }
+    CaptureFormat requested = parseCaptureFormat(format);
+    if (requested == CAPTURE_BGR || !requestCaptureFormat(cap, requested)) {
+        std::cerr << cap.device() << " does not offer " << format << " frames" << std::endl;
+        return 1;
+    }
+    cap.set(cv::CAP_PROP_CONVERT_RGB, bgr ? 1 : 0);
+
+    int failures = 0;
+    auto fail = [&failures](int frame, const std::string& what) {
+        if (failures++ < 10) {
+            std::cerr << "FAIL frame " << frame << ": " << what << std::endl;
+        }
+    };
+
+    CameraFrame frame;
+    int64_t firstTimestampUs = 0;
+    int64_t lastTimestampUs = 0;
+    int64_t maxIntervalUs = 0;
+    int64_t totalLatencyUs = 0;
+    int64_t maxLatencyUs = 0;
+    int received = 0; // Averages cover these, not --frames: the loop stops at the first missing frame
+    for (int i = 0; i < frames; i++) {
+        if (!frame.read(cap)) {
+            fail(i, "no frame");
+            break;
+        }
+        received++;
+        int64_t dequeuedUs = steadyNowUs();
+        int64_t timestampUs = cap.frameTimestampUs();
+
+        if (bgr) {
+            if (frame.isRaw() || frame.bgr().channels() != 3) {
+                fail(i, "expected a converted BGR frame");
+            }
+        } else {
+            if (frame.format() != requested) {
+                fail(i, std::string("frame parsed as ") + captureFormatName(frame.format()));
+            } else if (requested == CAPTURE_MJPEG) {
+                if (frame.bgr().size() != frame.size()) {
+                    fail(i, "JPEG does not decode to the frame size");
+                }
+            } else if (frame.luma().size() != frame.size()) {
+                fail(i, "luma plane size does not match the frame");
+            }
+            cv::Mat raw;
+            cap.retrieve(raw);
+            if (!cap.isMappedFrame(raw)) {
+                fail(i, "raw frame is a copy, not the driver buffer");
+            }
+        }
+
+        if (timestampUs <= 0 || timestampUs > dequeuedUs) {
+            fail(i, "timestamp " + std::to_string(timestampUs) + " us is not before dequeue at " + std::to_string(dequeuedUs) + " us");
+        }
+        if (i == 0) {
+            firstTimestampUs = timestampUs;
+        } else if (timestampUs <= lastTimestampUs) {
+            fail(i, "timestamp did not increase");
+        } else {
+            maxIntervalUs = std::max(maxIntervalUs, timestampUs - lastTimestampUs);
+        }
+        lastTimestampUs = timestampUs;
+        totalLatencyUs += dequeuedUs - timestampUs;
+        maxLatencyUs = std::max(maxLatencyUs, dequeuedUs - timestampUs);
+    }
+
+    double spanMs = (lastTimestampUs - firstTimestampUs) / 1000.0;
+    std::cout << cap.device() << ": " << cap.get(cv::CAP_PROP_FRAME_WIDTH) << "x" << cap.get(cv::CAP_PROP_FRAME_HEIGHT)
+              << " " << format << (bgr ? " -> BGR" : " (zero-copy)") << ", " << cap.bufferCount() << " buffers" << std::endl;
+    std::cout << "  Frames received: " << received << " of " << frames << std::endl;
+    if (received >= 2 && spanMs > 0.0) {
+        std::cout << "  Frame interval: avg " << spanMs / (received - 1) << " ms, max " << maxIntervalUs / 1000.0
+                  << " ms (" << (received - 1) * 1000.0 / spanMs << " fps)" << std::endl;
+    }
+    if (received > 0) {
+        std::cout << "  Capture to dequeue: avg " << totalLatencyUs / 1000.0 / received << " ms, max "
+                  << maxLatencyUs / 1000.0 << " ms" << std::endl;
+    }
+    std::cout << "  Dropped frames: " << cap.droppedFrames() << std::endl;
+    std::cout << (failures ? "FAILED (" + std::to_string(failures) + " checks)" : std::string("OK")) << std::endl;
+    return failures ? 1 : 0;
+}
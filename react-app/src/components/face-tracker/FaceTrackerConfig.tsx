@@ -53,6 +53,12 @@ interface FaceTrackerConfig {
   tiltLimit: number;
   panGear: number;
   tiltGear: number;
+  previewWindows: boolean;
+  mjpegEnabled: boolean;
+  mjpegPort: number;
+  mjpegFps: number;
+  mjpegWidth: number;
+  mjpegQuality: number;
 }
 
 interface SliderFieldProps {
@@ -167,6 +173,12 @@ export const FaceTrackerConfig: React.FC = () => {
         tiltLimit: 1.0,
         panGear: 1.0,
         tiltGear: 1.0,
+        previewWindows: true,
+        mjpegEnabled: false,
+        mjpegPort: 8081,
+        mjpegFps: 15,
+        mjpegWidth: 640,
+        mjpegQuality: 75,
       };
       
       // Merge loaded config with defaults to ensure all fields exist
@@ -650,6 +662,58 @@ export const FaceTrackerConfig: React.FC = () => {
               Show 3D Visualization
             </label>
           </div>
+          <div className={styles.checkboxField}>
+            <label>
+              <input
+                type="checkbox"
+                checked={config.previewWindows}
+                onChange={(e) => updateConfig('previewWindows', e.target.checked)}
+              />
+              Show OpenCV Windows
+            </label>
+          </div>
+          <div className={styles.checkboxField}>
+            <label>
+              <input
+                type="checkbox"
+                checked={config.mjpegEnabled}
+                onChange={(e) => updateConfig('mjpegEnabled', e.target.checked)}
+              />
+              Browser Preview (MJPEG)
+            </label>
+          </div>
+          <SliderField
+            label="Preview FPS"
+            value={config.mjpegFps}
+            onChange={(v) => updateConfig('mjpegFps', Math.round(v))}
+            min={1}
+            max={30}
+            step={1}
+          />
+          <SliderField
+            label="Preview Width"
+            value={config.mjpegWidth}
+            onChange={(v) => updateConfig('mjpegWidth', Math.round(v))}
+            min={160}
+            max={1280}
+            step={16}
+          />
+          <SliderField
+            label="Preview JPEG Quality"
+            value={config.mjpegQuality}
+            onChange={(v) => updateConfig('mjpegQuality', Math.round(v))}
+            min={10}
+            max={100}
+            step={1}
+          />
+          {config.mjpegEnabled && config.showPreview && (
+            // The tracker only serves localhost; frames are encoded only while this is visible
+            <img
+              className={styles.previewStream}
+              src={`http://127.0.0.1:${config.mjpegPort}/stream.mjpg`}
+              alt="Face tracker preview"
+            />
+          )}
         </section>
       </div>
     </div>
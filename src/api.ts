@@ -1403,6 +1403,18 @@ import { sendOscMessage } from './index';
 const FACE_TRACKER_CONFIG_PATH = path.join(__dirname, '..', 'face-tracker', 'face-tracker-config.json');
 const faceTrackerService = new FaceTrackerService();
 
+// A daemon tracker outlives stop(); make sure it goes away with the server
+process.once('exit', () => faceTrackerService.shutdown());
+
+// DMX from the tracker's binary stream is applied directly (no /api/dmx/batch round trip)
+faceTrackerService.onDmx((values) => {
+  for (const { channel, value } of values) {
+    if (channel >= 0 && channel < 512) {
+      setDmxChannel(channel, value);
+    }
+  }
+});
+
 apiRouter.get('/face-tracker/config', (req, res) => {
   try {
     if (!fs.existsSync(FACE_TRACKER_CONFIG_PATH)) {
@@ -1415,6 +1427,13 @@ apiRouter.get('/face-tracker/config', (req, res) => {
         zoomChannel: 0,
         focusChannel: 0,
         cameraIndex: 0,
+        captureFormat: 'bgr',
+        captureBackend: 'opencv',
+        v4l2Buffers: 4,
+        captureDecodeThreads: 2,
+        captureDecodeScale: 2,
+        logLevel: 'info',
+        logRateLimit: 30,
         updateRate: 30,
         panSensitivity: 1.0,
         tiltSensitivity: 1.0,
@@ -1457,7 +1476,42 @@ apiRouter.get('/face-tracker/config', (req, res) => {
         panLimit: 1.0,
         tiltLimit: 1.0,
         panGear: 1.0,
-        tiltGear: 1.0
+        tiltGear: 1.0,
+        previewWindows: true,
+        previewFps: 15,
+        mjpegEnabled: false,
+        mjpegPort: 8081,
+        mjpegFps: 15,
+        mjpegWidth: 640,
+        mjpegQuality: 75,
+        metricsEnabled: false,
+        metricsPort: 9464,
+        traceEnabled: false,
+        traceSpans: 16384,
+        tracePath: '/tmp/face-tracker-trace.json',
+        watchdogTimeoutMs: 1000,
+        failsafePan: -1,
+        failsafeTilt: -1,
+        syntheticMotion: 'lissajous',
+        syntheticPeriodMs: 4000,
+        syntheticAmplitude: 0.6,
+        syntheticFaceImage: '',
+        syntheticFaceSize: 160,
+        syntheticNoise: 0,
+        syntheticBlur: 0,
+        syntheticLighting: 1.0,
+        syntheticLightDrift: 0,
+        syntheticRealtime: true,
+        syntheticSeed: 1,
+        syntheticFrames: 0,
+        syntheticTruthPath: '',
+        poseLogPath: '',
+        recordPath: '',
+        recordFormat: 'png',
+        recordQueueFrames: 32,
+        oscControlEnabled: false,
+        oscControlPort: 9001,
+        oscControlBind: '127.0.0.1'
       };
       res.json(defaultConfig);
       return;
@@ -1486,14 +1540,8 @@ apiRouter.put('/face-tracker/config', (req, res) => {
       });
     }
 
-    // Ensure directory exists
-    const configDir = path.dirname(FACE_TRACKER_CONFIG_PATH);
-    if (!fs.existsSync(configDir)) {
-      fs.mkdirSync(configDir, { recursive: true });
-    }
-
-    // Save config to file
-    fs.writeFileSync(FACE_TRACKER_CONFIG_PATH, JSON.stringify(configData, null, 2));
+    // Saved through the service so an in-process tracker gets the change too
+    faceTrackerService.saveConfig(configData);
 
     log('Face tracker config saved successfully', 'SYSTEM');
 
@@ -0,0 +1,106 @@
+/**
+ * Face Tracker Native - the C++ tracker loaded into the backend process
+ * Wraps face-tracker/build/bin/facetracker.node (face-tracker/node/facetracker_addon.cpp):
+ * tracking runs on a native worker thread and poses arrive as direct callbacks,
+ * with no child process, socket or HTTP hop in between.
+ */
+
+import path from 'path';
+import fs from 'fs';
+import { log } from './logger';
+import { FaceTrackerPose } from './faceTrackerStream';
+
+export interface FaceTrackerNativePose extends FaceTrackerPose {
+  gesture: string; // Newly detected gesture ("NODDING", ...) or ''
+  // 'stalled': no camera frame for watchdogTimeoutMs (repeated every second);
+  // 'failed': tracking stopped on `error`. Both carry the failsafe position in panDmx/tiltDmx.
+  status: 'tracking' | 'stalled' | 'failed';
+  error: string;
+}
+
+interface NativeTracker {
+  start(onPose: (pose: FaceTrackerNativePose) => void): Promise<void>;
+  stop(): void;
+  updateConfig(configJson: string): void;
+  droppedPoses(): number;
+  error(): string;
+}
+
+interface NativeModule {
+  apiVersion: number;
+  Tracker: new (configJson?: string) => NativeTracker;
+}
+
+// Must match FT_API_VERSION in face-tracker/facetracker.h
+const NATIVE_API_VERSION = 2;
+
+const addonPath = path.join(__dirname, '..', 'face-tracker', 'build', 'bin', 'facetracker.node');
+let nativeModule: NativeModule | null | undefined;
+
+function loadNative(): NativeModule | null {
+  if (nativeModule !== undefined) return nativeModule;
+  nativeModule = null;
+  if (!fs.existsSync(addonPath)) return null;
+  try {
+    const loaded: NativeModule = require(addonPath);
+    if (loaded.apiVersion !== NATIVE_API_VERSION) {
+      log(`Face tracker addon API v${loaded.apiVersion} does not match v${NATIVE_API_VERSION}, rebuild it`, 'WARN');
+    } else {
+      nativeModule = loaded;
+    }
+  } catch (error) {
+    log('Face tracker addon failed to load', 'WARN', { error });
+  }
+  return nativeModule;
+}
+
+export class FaceTrackerNative {
+  private tracker: NativeTracker | null = null;
+
+  /**
+   * Check if the addon was built (cmake -DFACE_TRACKER_BUILD_NODE_ADDON=ON) and loads
+   */
+  static isAvailable(): boolean {
+    return loadNative() !== null;
+  }
+
+  /**
+   * Open the camera and track; resolves once frames are flowing
+   */
+  async start(config: object, onPose: (pose: FaceTrackerNativePose) => void): Promise<void> {
+    const native = loadNative();
+    if (!native) {
+      throw new Error('Face tracker addon not available');
+    }
+    if (!this.tracker) {
+      // Models stay loaded in the tracker object between sessions
+      this.tracker = new native.Tracker(JSON.stringify(config));
+    } else {
+      this.tracker.updateConfig(JSON.stringify(config));
+    }
+    await this.tracker.start(onPose);
+  }
+
+  stop(): void {
+    if (!this.tracker) return;
+    this.tracker.stop();
+    const dropped = this.tracker.droppedPoses();
+    if (dropped > 0) {
+      log(`Face tracker dropped ${dropped} poses while the event loop was busy`, 'FACE_TRACKER');
+    }
+  }
+
+  /**
+   * Why tracking stopped on its own ('' while it runs fine)
+   */
+  error(): string {
+    return this.tracker?.error() ?? '';
+  }
+
+  /**
+   * Live config change (smoothing, mapping, image); camera fields apply on the next start
+   */
+  updateConfig(config: object): void {
+    this.tracker?.updateConfig(JSON.stringify(config));
+  }
+}
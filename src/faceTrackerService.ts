@@ -4,9 +4,13 @@
  */
 
 import { spawn, ChildProcess } from 'child_process';
+import net from 'net';
 import path from 'path';
 import fs from 'fs';
+import os from 'os';
 import { log } from './logger';
+import { FaceTrackerStream, FaceTrackerDmxValue } from './faceTrackerStream';
+import { FaceTrackerNative, FaceTrackerNativePose } from './faceTrackerNative';
 
 export interface FaceTrackerConfig {
   cameraIndex: number;
@@ -28,27 +32,66 @@ export interface FaceTrackerConfig {
   panMax: number;
   tiltMin: number;
   tiltMax: number;
+  useStream?: boolean;
+  streamSocketPath?: string;
+  inProcess?: boolean; // Track in-process through the addon when built (opt-in; default is the tracker binary)
 }
 
 export class FaceTrackerService {
   private process: ChildProcess | null = null;
   private configPath: string;
   private isRunning: boolean = false;
+  private isReady: boolean = false; // Tracker printed READY (models loaded, camera open)
+  private readyWaiter?: { resolve: () => void; reject: (error: Error) => void };
   private onFrameCallback?: (frame: Buffer) => void;
   private onFaceDetectedCallback?: (pan: number, tilt: number) => void;
+  private onDmxCallback?: (values: FaceTrackerDmxValue[]) => void;
+  private stream: FaceTrackerStream | null = null;
+  private native: FaceTrackerNative | null = null; // In-process tracker (addon), when in use
+  private nativeLastDmx = new Map<number, number>();
+  private nativeConfig: (FaceTrackerConfig & Record<string, any>) | null = null; // What onNativePose() sends with
+  private nativeLastKeyframe = 0; // Date.now() of the last full refresh (0 = none yet)
+  private nativeLastSend = 0;     // Date.now() of the last face pose sent (updateRate)
+  private nativeStatus: FaceTrackerNativePose['status'] = 'tracking';
+  private nativeError = '';
+  private streamSocketPath: string;
+  private commandSocketPath: string;
 
   constructor() {
     this.configPath = path.join(__dirname, '..', 'face-tracker', 'face-tracker-config.json');
+    this.streamSocketPath = path.join(os.tmpdir(), 'artbastard-face-tracker.sock');
+    this.commandSocketPath = path.join(os.tmpdir(), 'artbastard-face-tracker-control.sock');
+  }
+
+  /**
+   * Daemon mode (tracker stays resident between sessions) uses a Unix domain command socket
+   */
+  static isDaemonSupported(): boolean {
+    return process.platform !== 'win32';
+  }
+
+  /**
+   * Binary stream needs Unix domain sockets (not wired up on Windows)
+   */
+  static isStreamSupported(): boolean {
+    return process.platform !== 'win32';
   }
 
   /**
    * Check if C++ face tracker binary exists
    */
-  static isAvailable(): boolean {
+  static isBinaryAvailable(): boolean {
     const binaryPath = path.join(__dirname, '..', 'face-tracker', 'build', 'bin', 'face-tracker');
     return fs.existsSync(binaryPath);
   }
 
+  /**
+   * Check if the tracker can run at all: in-process addon or binary
+   */
+  static isAvailable(): boolean {
+    return FaceTrackerNative.isAvailable() || FaceTrackerService.isBinaryAvailable();
+  }
+
   /**
    * Start the face tracker process
    */
@@ -57,17 +100,214 @@ export class FaceTrackerService {
       throw new Error('Face tracker is already running');
     }
 
-    if (!FaceTrackerService.isAvailable()) {
+    // In-process tracking (opt-in): poses arrive as direct callbacks, no process or socket
+    if (config.inProcess === true && FaceTrackerNative.isAvailable()) {
+      await this.startNative(config);
+      return;
+    }
+
+    if (!FaceTrackerService.isBinaryAvailable()) {
       throw new Error('C++ face tracker binary not found. Please build it first.');
     }
+    if (this.native) {
+      this.native.stop();
+      this.native = null;
+    }
+
+    // Receive pose/DMX over the binary stream instead of stdout + HTTP when available
+    if (FaceTrackerService.isStreamSupported() && await this.openStream()) {
+      config = { ...config, useStream: true, streamSocketPath: this.streamSocketPath };
+    } else {
+      config = { ...config, useStream: false };
+    }
 
     // Update config file
     await this.updateConfig(config);
 
+    if (!FaceTrackerService.isDaemonSupported()) {
+      this.spawnTracker([]);
+      this.isRunning = true;
+      log('Face Tracker service started', 'FACE_TRACKER');
+      return;
+    }
+
+    // Warm daemon: models stay loaded between sessions, so starting takes about one frame
+    if (!this.process) {
+      this.spawnTracker(['--daemon', '--command-socket', this.commandSocketPath]);
+      await this.waitUntilReady(60000);
+    } else {
+      await this.sendCommand(`reconfigure ${JSON.stringify(config)}`);
+    }
+    await this.sendCommand('start');
+
+    this.isRunning = true;
+    log('Face Tracker service started', 'FACE_TRACKER');
+  }
+
+  /**
+   * Stop tracking. A daemon stays resident on standby (fixtures return home);
+   * otherwise the process is terminated.
+   */
+  stop(): void {
+    if (this.native) {
+      this.native.stop();
+      this.isRunning = false;
+      log('Face Tracker stopped (in-process)', 'FACE_TRACKER');
+      return;
+    }
+    if (this.process && this.isReady && FaceTrackerService.isDaemonSupported()) {
+      this.isRunning = false;
+      this.sendCommand('stop')
+        .then(() => log('Face Tracker on standby', 'FACE_TRACKER'))
+        .catch((error) => {
+          log('Face tracker did not accept stop, terminating', 'WARN', { error });
+          this.shutdown();
+        });
+      return;
+    }
+    this.shutdown();
+  }
+
+  /**
+   * Terminate the tracker process (daemon included)
+   */
+  shutdown(): void {
+    if (this.native) {
+      this.native.stop();
+      this.native = null;
+      this.isRunning = false;
+      this.isReady = false;
+    }
+    if (this.process) {
+      this.process.kill('SIGTERM');
+      this.process = null;
+      this.isRunning = false;
+      this.isReady = false;
+      log('Face Tracker service stopped', 'FACE_TRACKER');
+    }
+    this.stream?.close();
+    this.stream = null;
+  }
+
+  /**
+   * Track inside this process through the addon (models stay loaded between sessions)
+   */
+  private async startNative(config: Partial<FaceTrackerConfig>): Promise<void> {
+    if (this.process) {
+      this.shutdown(); // A resident daemon may still hold the camera
+    }
+    const trackerConfig = await this.updateConfig({ ...config, useStream: false });
+    this.native = this.native ?? new FaceTrackerNative();
+    this.nativeLastDmx.clear();
+    this.nativeConfig = trackerConfig;
+    this.nativeLastKeyframe = 0;
+    this.nativeLastSend = 0;
+    this.nativeStatus = 'tracking';
+    this.nativeError = '';
+    await this.native.start(trackerConfig, (pose) => this.onNativePose(pose));
+    this.isRunning = true;
+    this.isReady = true;
+    log('Face Tracker service started (in-process)', 'FACE_TRACKER');
+  }
+
+  /**
+   * Event loop: one tracked frame from the addon. Output follows the tracker's own
+   * rules: only face poses move fixtures, at most updateRate times a second; a
+   * channel is resent once it moves by more than outputHysteresis, and every
+   * keyframeInterval ms all channels are refreshed. A stall or failure sends the
+   * failsafe position on every channel.
+   */
+  private onNativePose(pose: FaceTrackerNativePose): void {
+    const config = this.nativeConfig;
+    if (!config) return;
+    if (pose.status !== this.nativeStatus) {
+      if (pose.status === 'stalled') {
+        log('Face Tracker: camera stalled, fixtures sent to the failsafe position', 'WARN');
+      } else if (pose.status === 'tracking') {
+        log('Face Tracker: camera frames resumed', 'FACE_TRACKER');
+      }
+      this.nativeStatus = pose.status;
+    }
+    if (pose.status === 'failed') {
+      this.nativeError = pose.error;
+      log(`Face Tracker stopped on an error: ${pose.error}`, 'ERROR');
+    }
+    if (pose.gesture) {
+      log(`Face Tracker gesture: ${pose.gesture}`, 'FACE_TRACKER');
+    }
+    const failsafe = pose.status !== 'tracking';
+    if (!pose.faceDetected && !failsafe) return;
+    const now = Date.now();
+    if (!failsafe) {
+      const updateInterval = 1000 / Math.max(1, config.updateRate ?? 20);
+      if (now - this.nativeLastSend < updateInterval) return;
+      this.nativeLastSend = now;
+      this.onFaceDetectedCallback?.(pose.panDmx, pose.tiltDmx);
+    }
+
+    const keyframeInterval = config.keyframeInterval ?? 1000;
+    const keyframe = failsafe || this.nativeLastKeyframe === 0 ||
+      (keyframeInterval > 0 && now - this.nativeLastKeyframe >= keyframeInterval);
+    const hysteresis = config.outputHysteresis ?? 0;
+    const slots: Array<[number | undefined, number | undefined]> = [
+      [config.panChannel, pose.panDmx],
+      [config.tiltChannel, pose.tiltDmx],
+      [config.irisChannel, config.irisValue],
+      [config.zoomChannel, config.zoomValue],
+      [config.focusChannel, config.focusValue],
+    ];
+    const values: FaceTrackerDmxValue[] = [];
+    for (const [channel, value] of slots) {
+      if (!channel || channel < 1 || value === undefined) continue;
+      const last = this.nativeLastDmx.get(channel);
+      if (!keyframe && last !== undefined && Math.abs(value - last) <= hysteresis) continue;
+      this.nativeLastDmx.set(channel, value);
+      values.push({ channel: channel - 1, value });
+    }
+    if (keyframe) {
+      // A failsafe send must not count: the first face pose after it refreshes everything again
+      this.nativeLastKeyframe = failsafe ? 0 : now;
+    }
+    if (values.length) {
+      this.onDmxCallback?.(values);
+    }
+
+    if (pose.status === 'failed') {
+      // The native worker has ended; release it so the next start() can run
+      setImmediate(() => {
+        this.native?.stop();
+        this.isRunning = false;
+        this.isReady = false;
+      });
+    }
+  }
+
+  /**
+   * Save face-tracker-config.json as given. The tracker binary picks the file up
+   * through its watcher; the in-process tracker is handed the change directly.
+   */
+  saveConfig(configData: Record<string, any>): void {
+    const configDir = path.dirname(this.configPath);
+    if (!fs.existsSync(configDir)) {
+      fs.mkdirSync(configDir, { recursive: true });
+    }
+    fs.writeFileSync(this.configPath, JSON.stringify(configData, null, 2));
+
+    if (this.native && this.nativeConfig) {
+      const { inProcess, ...trackerConfig } = configData;
+      this.nativeConfig = { ...this.nativeConfig, ...trackerConfig, useStream: false };
+      this.native.updateConfig(this.nativeConfig);
+    }
+  }
+
+  /**
+   * Spawn the tracker binary and wire up its output
+   */
+  private spawnTracker(args: string[]): void {
     const binaryPath = path.join(__dirname, '..', 'face-tracker', 'build', 'bin', 'face-tracker');
     const workingDir = path.dirname(binaryPath);
 
-    this.process = spawn(binaryPath, [], {
+    this.process = spawn(binaryPath, args, {
       cwd: workingDir,
       stdio: ['pipe', 'pipe', 'pipe'],
     });
@@ -75,9 +315,15 @@ export class FaceTrackerService {
     this.process.stdout?.on('data', (data: Buffer) => {
       const output = data.toString();
       log(`Face Tracker: ${output}`, 'FACE_TRACKER');
+
+      if (!this.isReady && /^READY\b/m.test(output)) {
+        this.isReady = true;
+        this.readyWaiter?.resolve();
+        this.readyWaiter = undefined;
+      }
       
-      // Parse DMX updates from output
-      const dmxMatch = output.match(/Pan:\s*(\d+),\s*Tilt:\s*(\d+)/);
+      // Parse DMX updates from output (stream delivers these directly when enabled)
+      const dmxMatch = !this.stream && output.match(/Pan:\s*(\d+),\s*Tilt:\s*(\d+)/);
       if (dmxMatch && this.onFaceDetectedCallback) {
         const pan = parseInt(dmxMatch[1]);
         const tilt = parseInt(dmxMatch[2]);
@@ -93,29 +339,93 @@ export class FaceTrackerService {
     this.process.on('exit', (code) => {
       log(`Face Tracker exited with code ${code}`, 'FACE_TRACKER');
       this.isRunning = false;
+      this.isReady = false;
       this.process = null;
+      this.readyWaiter?.reject(new Error(`Face tracker exited with code ${code} during startup`));
+      this.readyWaiter = undefined;
     });
+  }
 
-    this.isRunning = true;
-    log('Face Tracker service started', 'FACE_TRACKER');
+  /**
+   * Resolve once the tracker has printed READY
+   */
+  private waitUntilReady(timeoutMs: number): Promise<void> {
+    if (this.isReady) return Promise.resolve();
+    return new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        this.readyWaiter = undefined;
+        reject(new Error('Timed out waiting for the face tracker to become ready'));
+      }, timeoutMs);
+      this.readyWaiter = {
+        resolve: () => { clearTimeout(timer); resolve(); },
+        reject: (error) => { clearTimeout(timer); reject(error); },
+      };
+    });
   }
 
   /**
-   * Stop the face tracker process
+   * Send one command to the daemon's command socket and return its reply
    */
-  stop(): void {
-    if (this.process) {
-      this.process.kill('SIGTERM');
-      this.process = null;
-      this.isRunning = false;
-      log('Face Tracker service stopped', 'FACE_TRACKER');
+  private sendCommand(command: string): Promise<string> {
+    return new Promise((resolve, reject) => {
+      const socket = net.createConnection(this.commandSocketPath);
+      let reply = '';
+      socket.setTimeout(2000);
+      socket.on('connect', () => socket.write(`${command}\n`));
+      socket.on('data', (data: Buffer) => {
+        reply += data.toString();
+        const newline = reply.indexOf('\n');
+        if (newline < 0) return;
+        socket.end();
+        const line = reply.slice(0, newline);
+        if (line.startsWith('ok')) {
+          resolve(line);
+        } else {
+          reject(new Error(`Face tracker rejected "${command.split(' ')[0]}": ${line}`));
+        }
+      });
+      socket.on('timeout', () => {
+        socket.destroy();
+        reject(new Error('Face tracker command timed out'));
+      });
+      socket.on('error', reject);
+    });
+  }
+
+  /**
+   * Open the binary stream socket the tracker connects to
+   */
+  private async openStream(): Promise<boolean> {
+    if (this.stream) return true;
+
+    this.stream = new FaceTrackerStream(this.streamSocketPath, {
+      onPose: (pose) => {
+        if (pose.faceDetected && this.onFaceDetectedCallback) {
+          this.onFaceDetectedCallback(pose.panDmx, pose.tiltDmx);
+        }
+      },
+      onDmx: (values) => this.onDmxCallback?.(values),
+      onGesture: (gesture) => log(`Face Tracker gesture: ${gesture}`, 'FACE_TRACKER'),
+      onStats: (stats) => {
+        log(`Face Tracker stats: ${stats.frames} frames, ${stats.sent} sent, ${stats.suppressed} suppressed, ` +
+          `${stats.keyframes} keyframes, ${stats.streamDropped} dropped`, 'FACE_TRACKER');
+      },
+    });
+
+    try {
+      await this.stream.listen();
+      return true;
+    } catch (error) {
+      log('Face tracker stream unavailable, falling back to HTTP', 'WARN', { error });
+      this.stream = null;
+      return false;
     }
   }
 
   /**
    * Update configuration file
    */
-  private async updateConfig(config: Partial<FaceTrackerConfig>): Promise<void> {
+  private async updateConfig(config: Partial<FaceTrackerConfig>): Promise<FaceTrackerConfig & Record<string, any>> {
     let currentConfig: any = {};
     
     if (fs.existsSync(this.configPath)) {
@@ -146,7 +456,8 @@ export class FaceTrackerService {
       tiltMax: 255,
     };
 
-    const mergedConfig = { ...defaultConfig, ...currentConfig, ...config };
+    const { inProcess, ...trackerConfig } = config;
+    const mergedConfig = { ...defaultConfig, ...currentConfig, ...trackerConfig };
 
     // Ensure directory exists
     const configDir = path.dirname(this.configPath);
@@ -156,6 +467,7 @@ export class FaceTrackerService {
 
     // Write config file
     fs.writeFileSync(this.configPath, JSON.stringify(mergedConfig, null, 2));
+    return mergedConfig;
   }
 
   /**
@@ -165,6 +477,13 @@ export class FaceTrackerService {
     this.onFaceDetectedCallback = callback;
   }
 
+  /**
+   * Set sink for DMX values received over the binary stream (0-based channels)
+   */
+  onDmx(callback: (values: FaceTrackerDmxValue[]) => void): void {
+    this.onDmxCallback = callback;
+  }
+
   /**
    * Set callback for video frames (if supported)
    */
@@ -175,10 +494,14 @@ export class FaceTrackerService {
   /**
    * Get current status
    */
-  getStatus(): { running: boolean; available: boolean } {
+  getStatus(): { running: boolean; ready: boolean; available: boolean; inProcess: boolean; error?: string } {
+    const error = this.nativeError || this.native?.error();
     return {
       running: this.isRunning,
+      ready: this.isReady,
       available: FaceTrackerService.isAvailable(),
+      inProcess: this.native !== null,
+      ...(error ? { error } : {}),
     };
   }
 }
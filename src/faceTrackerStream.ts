@@ -0,0 +1,256 @@
+/**
+ * Face Tracker Stream - binary Unix domain socket channel from the C++ tracker
+ * Replaces stdout scraping and the /api/dmx/batch round trip with one persistent connection.
+ * Framing mirrors face-tracker/binary_stream.h (little-endian, 16-byte header).
+ */
+
+import net from 'net';
+import fs from 'fs';
+import { log } from './logger';
+
+export const STREAM_MAGIC = 0xab;
+export const STREAM_HEADER_SIZE = 16;
+
+export enum StreamMessageType {
+  Hello = 0,
+  Pose = 1,
+  Dmx = 2,
+  Gesture = 3,
+  Stats = 4,
+}
+
+// Smallest valid payload per message type (Dmx and Gesture also depend on their count byte)
+const STREAM_PAYLOAD_MIN: Partial<Record<StreamMessageType, number>> = {
+  [StreamMessageType.Hello]: 2,
+  [StreamMessageType.Pose]: 19,
+  [StreamMessageType.Dmx]: 1,
+  [StreamMessageType.Gesture]: 1,
+  [StreamMessageType.Stats]: 36,
+};
+
+const POSE_FLAG_FACE = 0x01;
+const POSE_FLAG_LANDMARKS = 0x02;
+
+export interface FaceTrackerPose {
+  rawPan: number;
+  rawTilt: number;
+  smoothedPan: number;
+  smoothedTilt: number;
+  panDmx: number;
+  tiltDmx: number;
+  faceDetected: boolean;
+  fromLandmarks: boolean;
+  timestampUs: bigint;
+}
+
+export interface FaceTrackerDmxValue {
+  channel: number; // 0-based DMX channel
+  value: number;
+}
+
+export interface FaceTrackerStats {
+  frames: number;
+  sent: bigint;
+  suppressed: bigint;
+  keyframes: bigint;
+  streamDropped: bigint;
+}
+
+export interface FaceTrackerStreamHandlers {
+  onPose?: (pose: FaceTrackerPose) => void;
+  onDmx?: (values: FaceTrackerDmxValue[]) => void;
+  onGesture?: (gesture: string) => void;
+  onStats?: (stats: FaceTrackerStats) => void;
+}
+
+export class FaceTrackerStream {
+  private server: net.Server | null = null;
+  private connection: net.Socket | null = null;
+  private pending: Buffer = Buffer.alloc(0);
+  private lastSequence: number | null = null;
+  private gapCount = 0;
+  private badFrameCount = 0;
+
+  constructor(private socketPath: string, private handlers: FaceTrackerStreamHandlers) {}
+
+  /**
+   * Listen for the tracker connection (one connection at a time)
+   */
+  async listen(): Promise<void> {
+    if (this.server) return;
+
+    // Remove a stale socket left behind by a previous run
+    if (fs.existsSync(this.socketPath)) {
+      fs.unlinkSync(this.socketPath);
+    }
+
+    this.server = net.createServer((socket) => this.accept(socket));
+    await new Promise<void>((resolve, reject) => {
+      this.server!.once('error', reject);
+      this.server!.listen(this.socketPath, () => {
+        this.server!.off('error', reject);
+        resolve();
+      });
+    });
+    log(`Face tracker stream listening on ${this.socketPath}`, 'FACE_TRACKER');
+  }
+
+  close(): void {
+    this.connection?.destroy();
+    this.connection = null;
+    this.server?.close();
+    this.server = null;
+    if (fs.existsSync(this.socketPath)) {
+      fs.unlinkSync(this.socketPath);
+    }
+  }
+
+  isConnected(): boolean {
+    return this.connection !== null;
+  }
+
+  private accept(socket: net.Socket): void {
+    // A new tracker process replaces the old connection
+    this.connection?.destroy();
+    this.connection = socket;
+    this.pending = Buffer.alloc(0);
+    this.lastSequence = null;
+    socket.setNoDelay?.(true);
+
+    socket.on('data', (chunk: Buffer) => this.onData(chunk));
+    socket.on('close', () => {
+      if (this.connection === socket) {
+        this.connection = null;
+        log('Face tracker stream disconnected', 'FACE_TRACKER');
+      }
+    });
+    socket.on('error', (error) => {
+      log('Face tracker stream error', 'ERROR', { error });
+    });
+  }
+
+  private onData(chunk: Buffer): void {
+    this.pending = this.pending.length ? Buffer.concat([this.pending, chunk]) : chunk;
+
+    let offset = 0;
+    while (this.pending.length - offset >= STREAM_HEADER_SIZE) {
+      if (this.pending.readUInt8(offset) !== STREAM_MAGIC) {
+        // Framing lost - drop the connection rather than guess
+        log('Face tracker stream: bad magic, resetting connection', 'ERROR');
+        this.connection?.destroy();
+        this.pending = Buffer.alloc(0);
+        return;
+      }
+
+      const type = this.pending.readUInt8(offset + 1);
+      const length = this.pending.readUInt16LE(offset + 2);
+      if (this.pending.length - offset < STREAM_HEADER_SIZE + length) break;
+
+      const sequence = this.pending.readUInt32LE(offset + 4);
+      const timestampUs = this.pending.readBigUInt64LE(offset + 8);
+      const payload = this.pending.subarray(offset + STREAM_HEADER_SIZE, offset + STREAM_HEADER_SIZE + length);
+      if (type !== StreamMessageType.Hello) {
+        this.trackSequence(sequence);
+      }
+      this.dispatch(type, payload, timestampUs);
+
+      offset += STREAM_HEADER_SIZE + length;
+    }
+
+    this.pending = this.pending.subarray(offset);
+  }
+
+  private trackSequence(sequence: number): void {
+    if (this.lastSequence !== null && sequence !== ((this.lastSequence + 1) >>> 0)) {
+      this.gapCount++;
+    }
+    this.lastSequence = sequence;
+  }
+
+  /**
+   * Short or corrupt payloads are counted and skipped: a read past the end would
+   * throw inside the socket 'data' handler
+   */
+  private payloadValid(type: number, payload: Buffer): boolean {
+    const minimum = STREAM_PAYLOAD_MIN[type as StreamMessageType];
+    if (minimum === undefined) return true; // Unknown type, skipped by dispatch()
+    let required = minimum;
+    if (payload.length >= minimum && type === StreamMessageType.Dmx) {
+      required = 1 + payload.readUInt8(0) * 3;
+    } else if (payload.length >= minimum && type === StreamMessageType.Gesture) {
+      required = 1 + payload.readUInt8(0);
+    }
+    if (payload.length >= required) return true;
+
+    this.badFrameCount++;
+    if (this.badFrameCount <= 10) {
+      log(`Face tracker stream: skipping type ${type} message, payload ${payload.length} bytes (need ${required})`, 'WARN');
+    }
+    return false;
+  }
+
+  private dispatch(type: number, payload: Buffer, timestampUs: bigint): void {
+    if (!this.payloadValid(type, payload)) return;
+    switch (type) {
+      case StreamMessageType.Hello:
+        log(`Face tracker stream connected (protocol v${payload.readUInt16LE(0)})`, 'FACE_TRACKER');
+        break;
+      case StreamMessageType.Pose: {
+        const flags = payload.readUInt8(18);
+        this.handlers.onPose?.({
+          rawPan: payload.readFloatLE(0),
+          rawTilt: payload.readFloatLE(4),
+          smoothedPan: payload.readFloatLE(8),
+          smoothedTilt: payload.readFloatLE(12),
+          panDmx: payload.readUInt8(16),
+          tiltDmx: payload.readUInt8(17),
+          faceDetected: (flags & POSE_FLAG_FACE) !== 0,
+          fromLandmarks: (flags & POSE_FLAG_LANDMARKS) !== 0,
+          timestampUs,
+        });
+        break;
+      }
+      case StreamMessageType.Dmx: {
+        const count = payload.readUInt8(0);
+        const values: FaceTrackerDmxValue[] = [];
+        for (let i = 0; i < count; i++) {
+          const base = 1 + i * 3;
+          values.push({ channel: payload.readUInt16LE(base), value: payload.readUInt8(base + 2) });
+        }
+        this.handlers.onDmx?.(values);
+        break;
+      }
+      case StreamMessageType.Gesture: {
+        const length = payload.readUInt8(0);
+        this.handlers.onGesture?.(payload.toString('utf-8', 1, 1 + length));
+        break;
+      }
+      case StreamMessageType.Stats:
+        this.handlers.onStats?.({
+          frames: payload.readUInt32LE(0),
+          sent: payload.readBigUInt64LE(4),
+          suppressed: payload.readBigUInt64LE(12),
+          keyframes: payload.readBigUInt64LE(20),
+          streamDropped: payload.readBigUInt64LE(28),
+        });
+        break;
+      default:
+        // Unknown message types are skipped so newer trackers stay compatible
+        break;
+    }
+  }
+
+  /**
+   * Number of sequence gaps seen (messages the tracker dropped instead of blocking)
+   */
+  getGapCount(): number {
+    return this.gapCount;
+  }
+
+  /**
+   * Number of messages skipped because their payload was too short
+   */
+  getBadFrameCount(): number {
+    return this.badFrameCount;
+  }
+}